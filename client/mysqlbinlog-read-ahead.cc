@@ -0,0 +1,435 @@
+/* Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/*
+  Read-ahead of the binlog for the mysqlbinlog client program, see
+  mysqlbinlog-read-ahead.h.
+*/
+
+#include "client_priv.h"
+#include "mysqlbinlog-read-ahead.h"
+
+
+pthread_handler_t remote_read_ahead_thread(void *arg)
+{
+  my_thread_init();
+  ((Remote_read_ahead *) arg)->run();
+  my_thread_end();
+  return 0;
+}
+
+
+Remote_read_ahead::Remote_read_ahead()
+  :m_mysql(NULL), m_first(NULL), m_last(&m_first), m_current(NULL),
+   m_bytes(0), m_max_bytes(0), m_done(false), m_stop(false), m_started(false)
+{
+}
+
+
+/**
+  Start receiving the packets of a binlog dump requested on a connection
+
+  @retval false  Started, the packets must be read with read_packet()
+  @retval true   The thread could not be started
+*/
+
+bool Remote_read_ahead::start(MYSQL *mysql, size_t max_bytes)
+{
+  DBUG_ASSERT(!m_started);
+  m_mysql= mysql;
+  m_max_bytes= max_bytes;
+  m_done= m_stop= false;
+  pthread_mutex_init(&m_lock, NULL);
+  pthread_cond_init(&m_cond, NULL);
+  if (pthread_create(&m_thread, NULL, remote_read_ahead_thread, this))
+  {
+    pthread_cond_destroy(&m_cond);
+    pthread_mutex_destroy(&m_lock);
+    return true;
+  }
+  m_started= true;
+  return false;
+}
+
+
+void Remote_read_ahead::run()
+{
+  for (;;)
+  {
+    ulong length= mysql_net_read_packet(m_mysql);
+    size_t size= length == packet_error ? 0 : length;
+    bool last= length == packet_error ||
+               (length < 8 && m_mysql->net.read_pos[0] == 254);
+    Packet *packet;
+
+    if (!(packet= (Packet *) my_malloc(PSI_NOT_INSTRUMENTED,
+                                       offsetof(Packet, data) + size,
+                                       MYF(MY_WME))))
+      break;
+    packet->next= NULL;
+    packet->length= length;
+    memcpy(packet->data, m_mysql->net.read_pos, size);
+
+    pthread_mutex_lock(&m_lock);
+    /* A packet larger than the limit is still queued, alone */
+    while (!m_stop && m_bytes && m_bytes + size > m_max_bytes)
+      pthread_cond_wait(&m_cond, &m_lock);
+    if (m_stop)
+    {
+      pthread_mutex_unlock(&m_lock);
+      my_free(packet);
+      break;
+    }
+    *m_last= packet;
+    m_last= &packet->next;
+    m_bytes+= size;
+    pthread_cond_broadcast(&m_cond);
+    pthread_mutex_unlock(&m_lock);
+    if (last)
+      break;
+  }
+
+  pthread_mutex_lock(&m_lock);
+  m_done= true;
+  pthread_cond_broadcast(&m_cond);
+  pthread_mutex_unlock(&m_lock);
+}
+
+
+/**
+  Take the next packet, like cli_safe_read()
+
+  @param[out] packet  The data of the packet, valid until the next call
+
+  @return Length of the packet, or packet_error. On error, mysql_error()
+          of the connection tells why.
+*/
+
+ulong Remote_read_ahead::read_packet(uchar **packet)
+{
+  Packet *p;
+
+  my_free(m_current);
+  m_current= NULL;
+  pthread_mutex_lock(&m_lock);
+  while (!m_first && !m_done)
+    pthread_cond_wait(&m_cond, &m_lock);
+  if (!(p= m_first))
+  {
+    /* The thread ran out of memory */
+    pthread_mutex_unlock(&m_lock);
+    return packet_error;
+  }
+  if (!(m_first= p->next))
+    m_last= &m_first;
+  if (p->length != packet_error)
+    m_bytes-= p->length;
+  pthread_cond_broadcast(&m_cond);
+  pthread_mutex_unlock(&m_lock);
+
+  m_current= p;
+  *packet= p->data;
+  return p->length;
+}
+
+
+/*
+  Stop the thread. If it is still receiving, the connection is cancelled,
+  as when the binlog dump is not read to the end without read-ahead, the
+  connection is not used any more.
+*/
+
+void Remote_read_ahead::stop()
+{
+  bool done;
+  if (!m_started)
+    return;
+  pthread_mutex_lock(&m_lock);
+  m_stop= true;
+  done= m_done;
+  pthread_cond_broadcast(&m_cond);
+  pthread_mutex_unlock(&m_lock);
+  if (!done)
+    mariadb_cancel(m_mysql);
+  pthread_join(m_thread, NULL);
+
+  my_free(m_current);
+  m_current= NULL;
+  while (m_first)
+  {
+    Packet *next= m_first->next;
+    my_free(m_first);
+    m_first= next;
+  }
+  m_last= &m_first;
+  m_bytes= 0;
+  pthread_cond_destroy(&m_cond);
+  pthread_mutex_destroy(&m_lock);
+  m_started= false;
+}
+
+
+pthread_handler_t local_read_ahead_thread(void *arg)
+{
+  my_thread_init();
+  ((Local_read_ahead *) arg)->run();
+  my_thread_end();
+  return 0;
+}
+
+
+/*
+  read_function of the IO_CACHE of a local binlog file read ahead. Like
+  _my_b_cache_read(), it fills the buffer of the cache, or reads directly
+  into the caller's buffer when more than the buffer is wanted, but from
+  the blocks read ahead when they have the bytes.
+*/
+
+static int local_read_ahead_read(IO_CACHE *info, uchar *buf, size_t count)
+{
+  Local_read_ahead *read_ahead= (Local_read_ahead *) info->append_read_pos;
+  /* pos_in_file always point on where info->buffer was read */
+  my_off_t pos= info->pos_in_file + (size_t) (info->read_end - info->buffer);
+
+  if (count >= info->read_length)
+  {
+    if (pos + count <= info->end_of_file &&
+        read_ahead->copy(pos, buf, count) == count)
+    {
+      info->pos_in_file= pos + count;
+      info->read_pos= info->read_end= info->buffer;
+      info->seek_not_done= 1;
+      return 0;
+    }
+  }
+  else if (pos + count <= info->end_of_file)
+  {
+    size_t length= (size_t) MY_MIN(info->read_length,
+                                   info->end_of_file - pos);
+    if ((length= read_ahead->copy(pos, info->buffer, length)) >= count)
+    {
+      info->pos_in_file= pos;
+      info->read_pos= info->buffer + count;
+      info->read_end= info->buffer + length;
+      info->seek_not_done= 1;
+      memcpy(buf, info->buffer, count);
+      return 0;
+    }
+  }
+  return read_ahead->file_read_function(info, buf, count);
+}
+
+
+Local_read_ahead::Local_read_ahead()
+  :file_read_function(NULL), m_file(NULL), m_block_size(0), m_fill(0),
+   m_take(0), m_ready(0), m_next_pos(0), m_generation(0), m_eof(false),
+   m_stop(false), m_started(false)
+{
+  for (uint i= 0; i < BLOCKS; i++)
+    m_blocks[i].data= NULL;
+}
+
+
+/**
+  Start reading a local binlog file ahead of its IO_CACHE
+
+  @param file       IO_CACHE of the file, positioned where the events start
+  @param max_bytes  How much to read ahead
+
+  @retval false  Started, stop() must be called before end_io_cache()
+  @retval true   Out of memory, or the thread could not be started
+*/
+
+bool Local_read_ahead::start(IO_CACHE *file, size_t max_bytes)
+{
+  DBUG_ASSERT(!m_started);
+  DBUG_ASSERT(file->type == READ_CACHE && !(file->myflags & MY_ENCRYPT));
+  m_block_size= MY_MAX(MY_ALIGN(max_bytes / BLOCKS, IO_SIZE), IO_SIZE);
+  for (uint i= 0; i < BLOCKS; i++)
+  {
+    if (!(m_blocks[i].data= (uchar *) my_malloc(PSI_NOT_INSTRUMENTED,
+                                                m_block_size, MYF(MY_WME))))
+      goto err;
+  }
+  m_file= file;
+  m_fill= m_take= m_ready= 0;
+  m_next_pos= my_b_tell(file);
+  m_eof= m_stop= false;
+  pthread_mutex_init(&m_lock, NULL);
+  pthread_cond_init(&m_cond, NULL);
+  if (pthread_create(&m_thread, NULL, local_read_ahead_thread, this))
+  {
+    pthread_cond_destroy(&m_cond);
+    pthread_mutex_destroy(&m_lock);
+    goto err;
+  }
+  m_started= true;
+
+  file_read_function= file->read_function;
+  file->read_function= local_read_ahead_read;
+  file->append_read_pos= (uchar *) this;
+  return false;
+
+err:
+  for (uint i= 0; i < BLOCKS; i++)
+  {
+    my_free(m_blocks[i].data);
+    m_blocks[i].data= NULL;
+  }
+  return true;
+}
+
+
+void Local_read_ahead::run()
+{
+  pthread_mutex_lock(&m_lock);
+  for (;;)
+  {
+    while (!m_stop && (m_eof || m_ready == BLOCKS))
+      pthread_cond_wait(&m_cond, &m_lock);
+    if (m_stop)
+      break;
+    Block *block= m_blocks + m_fill;
+    my_off_t pos= m_next_pos;
+    ulong generation= m_generation;
+    pthread_mutex_unlock(&m_lock);
+
+    /*
+      The block is not ready, so the main thread does not look at it, even
+      if it restarts the read-ahead meanwhile.
+    */
+    size_t length= my_pread(m_file->file, block->data, m_block_size, pos,
+                            MYF(0));
+
+    pthread_mutex_lock(&m_lock);
+    if (generation != m_generation)
+      continue;
+    if (length == (size_t) -1 || length == 0)
+    {
+      m_eof= true;
+      pthread_cond_broadcast(&m_cond);
+      continue;
+    }
+    block->pos= pos;
+    block->length= length;
+    m_next_pos= pos + length;
+    m_fill= (m_fill + 1) % BLOCKS;
+    m_ready++;
+    if (length < m_block_size)
+      m_eof= true;
+    pthread_cond_broadcast(&m_cond);
+  }
+  pthread_mutex_unlock(&m_lock);
+}
+
+
+/* Let the thread continue reading from a position, dropping the blocks */
+
+void Local_read_ahead::restart(my_off_t pos)
+{
+  m_generation++;
+  m_fill= m_take= m_ready= 0;
+  m_next_pos= pos;
+  m_eof= false;
+  pthread_cond_broadcast(&m_cond);
+}
+
+
+void Local_read_ahead::release_block()
+{
+  m_take= (m_take + 1) % BLOCKS;
+  m_ready--;
+  pthread_cond_broadcast(&m_cond);
+}
+
+
+/**
+  Copy bytes of the file from the blocks read ahead, waiting for the thread
+  to read them if needed
+
+  @return Number of bytes copied, which is less than length at the end of
+          the file, and 0 if the blocks are not at pos
+*/
+
+size_t Local_read_ahead::copy(my_off_t pos, uchar *buf, size_t length)
+{
+  size_t done= 0;
+  pthread_mutex_lock(&m_lock);
+  while (done < length)
+  {
+    if (!m_ready)
+    {
+      /*
+        The thread reads the next block from m_next_pos. When the IO_CACHE
+        reads elsewhere, continue from there.
+      */
+      if (pos < m_next_pos ||
+          pos >= m_next_pos + (m_eof ? 0 : m_block_size))
+      {
+        if (pos != m_next_pos)
+          restart(pos);
+        break;
+      }
+      pthread_cond_wait(&m_cond, &m_lock);
+      continue;
+    }
+    Block *block= m_blocks + m_take;
+    if (pos < block->pos)
+    {
+      restart(pos);
+      break;
+    }
+    if (pos >= block->pos + block->length)
+    {
+      release_block();
+      continue;
+    }
+    size_t n= (size_t) MY_MIN(length - done, block->pos + block->length - pos);
+    /* The thread does not change a ready block */
+    pthread_mutex_unlock(&m_lock);
+    memcpy(buf + done, block->data + (pos - block->pos), n);
+    pthread_mutex_lock(&m_lock);
+    done+= n;
+    pos+= n;
+    if (pos == block->pos + block->length)
+      release_block();
+  }
+  pthread_mutex_unlock(&m_lock);
+  return done;
+}
+
+
+void Local_read_ahead::stop()
+{
+  if (!m_started)
+    return;
+  pthread_mutex_lock(&m_lock);
+  m_stop= true;
+  pthread_cond_broadcast(&m_cond);
+  pthread_mutex_unlock(&m_lock);
+  pthread_join(m_thread, NULL);
+
+  m_file->read_function= file_read_function;
+  m_file->append_read_pos= NULL;
+  m_file= NULL;
+  for (uint i= 0; i < BLOCKS; i++)
+  {
+    my_free(m_blocks[i].data);
+    m_blocks[i].data= NULL;
+  }
+  pthread_cond_destroy(&m_cond);
+  pthread_mutex_destroy(&m_lock);
+  m_started= false;
+}
@@ -0,0 +1,117 @@
+/* Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/*
+  Read-ahead of the binlog for mysqlbinlog, with --read-ahead-size=N.
+
+  The main thread reads an event, then decodes and prints it, then reads the
+  next one, so the time to get the bytes of each event from the server or
+  from the disk adds up with the time to print it. With read-ahead, a thread
+  reads up to N bytes ahead of the main thread:
+
+   - With --read-from-remote-server, the thread receives the packets of the
+     binlog dump, and the main thread takes them from a queue instead of
+     reading the connection.
+
+   - For a local binlog file, the thread reads the file in blocks, and the
+     IO_CACHE of the main thread copies from the blocks instead of reading
+     the file. Reads elsewhere in the file, like the seeks at the start of
+     a file, are done by the IO_CACHE as usual, and the thread continues
+     from where they end.
+
+  The events are still decoded and printed one by one by the main thread,
+  as how an event is printed depends on the events before it.
+*/
+
+#ifndef MYSQLBINLOG_READ_AHEAD_H
+#define MYSQLBINLOG_READ_AHEAD_H
+
+/* Packets of the binlog dump received ahead of the main thread */
+class Remote_read_ahead
+{
+public:
+  Remote_read_ahead();
+  bool start(MYSQL *mysql, size_t max_bytes);
+  ulong read_packet(uchar **packet);
+  void stop();
+  void run();
+
+private:
+  struct Packet
+  {
+    Packet *next;
+    ulong length;
+    uchar data[1];
+  };
+
+  MYSQL *m_mysql;
+  pthread_t m_thread;
+  pthread_mutex_t m_lock;
+  pthread_cond_t m_cond;
+  /* Received and not yet read */
+  Packet *m_first, **m_last;
+  /* Returned by the last read_packet(), freed by the next one */
+  Packet *m_current;
+  size_t m_bytes, m_max_bytes;
+  /* The thread has received the last packet, or an error */
+  bool m_done;
+  bool m_stop;
+  bool m_started;
+};
+
+
+/* Blocks of a local binlog file read ahead of the main thread */
+class Local_read_ahead
+{
+public:
+  Local_read_ahead();
+  bool start(IO_CACHE *file, size_t max_bytes);
+  size_t copy(my_off_t pos, uchar *buf, size_t length);
+  void stop();
+  void run();
+
+  int (*file_read_function)(IO_CACHE *, uchar *, size_t);
+
+private:
+  static constexpr uint BLOCKS= 4;
+  struct Block
+  {
+    uchar *data;
+    my_off_t pos;
+    size_t length;
+  };
+
+  void restart(my_off_t pos);
+  void release_block();
+
+  IO_CACHE *m_file;
+  pthread_t m_thread;
+  pthread_mutex_t m_lock;
+  pthread_cond_t m_cond;
+  Block m_blocks[BLOCKS];
+  size_t m_block_size;
+  /* The block the thread fills next, the first ready one, ready blocks */
+  uint m_fill, m_take, m_ready;
+  /* Where the thread reads next */
+  my_off_t m_next_pos;
+  /* Incremented when the main thread reads elsewhere in the file */
+  ulong m_generation;
+  /* The thread got to the end of the file, or a read error */
+  bool m_eof;
+  bool m_stop;
+  bool m_started;
+};
+
+#endif /* MYSQLBINLOG_READ_AHEAD_H */
@@ -45,6 +45,7 @@
 #include <atomic>
 #include "handler_binlog_reader.h"
 #include "mysqlbinlog-engine.h"
+#include "mysqlbinlog-read-ahead.h"
 #include "log_event.h"
 #include "compat56.h"
 #include "sql_common.h"
@@ -130,6 +131,7 @@ static my_bool force_if_open_opt= 1;
 static my_bool opt_raw_mode= 0, opt_stop_never= 0;
 my_bool opt_gtid_strict_mode= true;
 static ulong opt_stop_never_slave_server_id= 0;
+static ulong opt_read_ahead_size= 0;
 static my_bool opt_verify_binlog_checksum= 1;
 static ulonglong offset = 0;
 static char* host = 0;
@@ -172,6 +174,8 @@ static last_processed_ev_t last_processed_ev= {0, MY_TIME_T_MAX};
 
 static ulonglong rec_count= 0;
 static MYSQL* mysql = NULL;
+static Remote_read_ahead remote_read_ahead;
+static Local_read_ahead local_read_ahead;
 static const char* dirname_for_local_load= 0;
 static bool opt_skip_annotate_row_events= 0;
 
@@ -1652,6 +1656,12 @@ static struct my_option my_options[] =
   {"read-from-remote-server", 'R', "Read binary logs from a MariaDB server.",
    &remote_opt, &remote_opt, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0,
    0, 0},
+  {"read-ahead-size", 0,
+   "Read up to this many bytes of the binary log ahead of the printing of "
+   "the events, in a separate thread, from the server with -R or from a "
+   "local file. 0 disables read-ahead.",
+   &opt_read_ahead_size, &opt_read_ahead_size, 0, GET_ULONG, REQUIRED_ARG,
+   0, 0, 1024*1024*1024L, 0, IO_SIZE, 0},
   {"raw", 0, "Requires -R. Output raw binlog data instead of SQL "
    "statements. Output files named after server logs.",
    &opt_raw_mode, &opt_raw_mode, 0, GET_BOOL, NO_ARG, 0, 0, 0, 0,
@@ -2721,30 +2731,29 @@ static Exit_status check_master_version()
 
 
 static Exit_status handle_event_text_mode(PRINT_EVENT_INFO *print_event_info,
-                                          ulong *len,
+                                          uchar *packet, ulong *len,
                                           const char* logname,
                                           uint logname_len, my_off_t old_off)
 {
   const char *error_msg;
   Log_event *ev;
-  NET *net= &mysql->net;
   DBUG_ENTER("handle_event_text_mode");
 
-  if (net->read_pos[5] == ANNOTATE_ROWS_EVENT ||
-      net->read_pos[5] == TABLE_MAP_EVENT)
+  if (packet[5] == ANNOTATE_ROWS_EVENT ||
+      packet[5] == TABLE_MAP_EVENT)
   {
-    if (!(ev= read_self_managing_buffer_event_from_net(net->read_pos + 1,
+    if (!(ev= read_self_managing_buffer_event_from_net(packet + 1,
                                                        *len - 1, &error_msg)))
     {
       error("Could not construct %s event object: %s",
-            net->read_pos[5] == ANNOTATE_ROWS_EVENT ? "annotate" : "table_map",
+            packet[5] == ANNOTATE_ROWS_EVENT ? "annotate" : "table_map",
             error_msg);
       DBUG_RETURN(ERROR_STOP);
     }   
   }
   else
   {
-    if (!(ev= Log_event::read_log_event(net->read_pos + 1 ,
+    if (!(ev= Log_event::read_log_event(packet + 1 ,
                                         *len - 1, &error_msg,
                                         glob_description_event,
                                         opt_verify_binlog_checksum)))
@@ -2756,7 +2765,7 @@ static Exit_status handle_event_text_mode(PRINT_EVENT_INFO *print_event_info,
       If reading from a remote host, ensure the temp_buf for the
       Log_event class is pointing to the incoming stream.
     */
-    ev->register_temp_buf(net->read_pos + 1, FALSE);
+    ev->register_temp_buf(packet + 1, FALSE);
   }
 
   Log_event_type type= ev->get_type_code();
@@ -2829,11 +2838,11 @@ static Exit_status handle_event_text_mode(PRINT_EVENT_INFO *print_event_info,
 static char out_file_name[FN_REFLEN + 1];
 
 static Exit_status handle_event_raw_mode(PRINT_EVENT_INFO *print_event_info,
-                                         ulong *len,
+                                         uchar *packet, ulong *len,
                                          const char* logname, uint logname_len)
 {
   const char *error_msg;
-  const uchar *read_pos= mysql->net.read_pos + 1;
+  const uchar *read_pos= packet + 1;
   Log_event_type type;
   DBUG_ENTER("handle_event_raw_mode");
   DBUG_ASSERT(opt_raw_mode && remote_opt);
@@ -3017,33 +3026,48 @@ static Exit_status dump_remote_log_entries(PRINT_EVENT_INFO *print_event_info,
     DBUG_RETURN(ERROR_STOP);
   }
 
+  if (opt_read_ahead_size &&
+      remote_read_ahead.start(mysql, opt_read_ahead_size))
+  {
+    error("Could not start the read-ahead thread.");
+    DBUG_RETURN(ERROR_STOP);
+  }
+
   for (;;)
   {
-    len= cli_safe_read(mysql);
+    uchar *packet;
+    if (opt_read_ahead_size)
+      len= remote_read_ahead.read_packet(&packet);
+    else
+    {
+      len= cli_safe_read(mysql);
+      packet= net->read_pos;
+    }
     if (len == packet_error)
     {
       error("Got error reading packet from server: %s", mysql_error(mysql));
-      DBUG_RETURN(ERROR_STOP);
+      retval= ERROR_STOP;
+      break;
     }
-    if (len < 8 && net->read_pos[0] == 254)
+    if (len < 8 && packet[0] == 254)
       break; // end of data
-    DBUG_PRINT("info",( "len: %lu  net->read_pos[5]: %d\n",
-			len, net->read_pos[5]));
+    DBUG_PRINT("info",( "len: %lu  packet[5]: %d\n",
+			len, packet[5]));
     if (opt_raw_mode)
     {
-      retval= handle_event_raw_mode(print_event_info, &len,
+      retval= handle_event_raw_mode(print_event_info, packet, &len,
                                     logname, logname_len);
     }
     else
     {
-      retval= handle_event_text_mode(print_event_info, &len,
+      retval= handle_event_text_mode(print_event_info, packet, &len,
                                      logname, logname_len, old_off);
     }
     if (retval != OK_CONTINUE)
     {
       if (retval == OK_EOF)
-        break;
-      DBUG_RETURN(retval);
+        retval= OK_CONTINUE;
+      break;
     }
 
     /*
@@ -3053,7 +3077,8 @@ static Exit_status dump_remote_log_entries(PRINT_EVENT_INFO *print_event_info,
     old_off+= len-1;
   }
 
-  DBUG_RETURN(OK_CONTINUE);
+  remote_read_ahead.stop();
+  DBUG_RETURN(retval);
 }
 
 
@@ -3370,6 +3395,13 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
     if (open_engine_binlog(engine_binlog_reader, start_position, logname, file))
       goto err;
   }
+  /* Standard input cannot be read at a position by another thread */
+  else if (opt_read_ahead_size && fd >= 0 &&
+           local_read_ahead.start(file, opt_read_ahead_size))
+  {
+    error("Could not start the read-ahead thread.");
+    goto err;
+  }
   for (;;)
   {
     char llbuff[21];
@@ -3455,6 +3487,7 @@ static Exit_status dump_local_log_entries(PRINT_EVENT_INFO *print_event_info,
   retval= ERROR_STOP;
 
 end:
+  local_read_ahead.stop();
   if (fd >= 0)
     my_close(fd, MYF(MY_WME));
   /*
@@ -0,0 +1,38 @@
+# Copyright (c) 2026, MariaDB Corporation.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 2 of the License.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1335  USA
+
+# Look for the system zstd library, used for compressed binlog events.
+# Sets HAVE_ZSTD, ZSTD_INCLUDE_DIRS and ZSTD_LIBRARIES.
+#
+# WITH_ZSTD=auto (default) uses zstd if found, WITH_ZSTD=yes fails if it
+# is not found, and WITH_ZSTD=no builds without it.
+
+MACRO (MYSQL_CHECK_ZSTD)
+  SET(WITH_ZSTD "auto" CACHE STRING
+    "Use system zstd for binlog event compression. Options are: auto, yes, no")
+  IF(NOT WITH_ZSTD STREQUAL "no")
+    FIND_PACKAGE(ZSTD QUIET)
+    IF(ZSTD_FOUND)
+      SET(HAVE_ZSTD 1)
+    ELSEIF(WITH_ZSTD STREQUAL "yes")
+      MESSAGE(FATAL_ERROR "WITH_ZSTD=yes, but the zstd library was not found")
+    ENDIF()
+  ENDIF()
+  IF(NOT HAVE_ZSTD)
+    SET(ZSTD_INCLUDE_DIRS "")
+    SET(ZSTD_LIBRARIES "")
+  ENDIF()
+  ADD_FEATURE_INFO(ZSTD HAVE_ZSTD "ZSTD compression of binlog events")
+ENDMACRO()
@@ -208,6 +208,7 @@
 #cmakedefine HAVE_RWLOCK_INIT 1
 #cmakedefine HAVE_SCHED_YIELD 1
 #cmakedefine HAVE_SELECT 1
+#cmakedefine HAVE_SENDFILE 1
 #cmakedefine HAVE_SETENV 1
 #cmakedefine HAVE_SETMNTENT 1
 #cmakedefine HAVE_SETUPTERM 1
@@ -472,6 +473,7 @@
 #cmakedefine HAVE_CHARSET_utf32 1
 #cmakedefine HAVE_UCA_COLLATIONS 1
 #cmakedefine HAVE_COMPRESS 1
+#cmakedefine HAVE_ZSTD 1
 #cmakedefine HAVE_EncryptAes128Ctr 1
 #cmakedefine HAVE_EncryptAes128Gcm 1
 #cmakedefine HAVE_hkdf 1
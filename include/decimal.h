@@ -58,6 +58,19 @@ int decimal2bin(const decimal_t *from, uchar *to, decimal_digits_t precision,
 int bin2decimal(const uchar *from, decimal_t *to, decimal_digits_t precision,
                 decimal_digits_t scale);
 
+/*
+  DECIMAL(M,D) with M up to this many digits can be read as a longlong
+  scaled by 10^D, see bin2scaled_longlong()
+*/
+#define DECIMAL_SCALED_LONGLONG_PRECISION 18
+
+int bin2scaled_longlong(const uchar *from, longlong *to,
+                        decimal_digits_t precision, decimal_digits_t scale);
+int scaled_longlong2decimal(longlong from, decimal_digits_t scale,
+                            decimal_t *to);
+int scaled_longlong2double(longlong from, decimal_digits_t scale, double *to);
+longlong scaled_longlong2longlong(longlong from, decimal_digits_t scale);
+
 uint decimal_size(decimal_digits_t precision, decimal_digits_t scale);
 uint decimal_bin_size(decimal_digits_t precision, decimal_digits_t scale);
 uint decimal_result_size(decimal_t *from1, decimal_t *from2, char op,
@@ -110,6 +110,20 @@ typedef struct st_heap_block
 
 struct st_heap_info;			/* For reference */
 
+/*
+  Blob column of an internal temporary table. The blob data is kept in
+  separately allocated overflow chunks, the record only holds the length
+  and a pointer to the chunk data.
+*/
+
+typedef struct st_hp_blob_desc
+{
+  uint offset;                          /* Offset of the blob in record */
+  uint packlength;                      /* Bytes used for the blob length */
+  uint null_pos;                        /* Position of null byte */
+  uint8 null_bit;                       /* Null bit, 0 if not null */
+} HP_BLOB_DESC;
+
 typedef struct st_hp_keydef		/* Key definition with open */
 {
   uint flag;				/* HA_NOSAME | HA_NULL_PART_KEY */
@@ -135,6 +149,8 @@ typedef struct st_heap_share
 {
   HP_BLOCK block;
   HP_KEYDEF  *keydef;
+  HP_BLOB_DESC *blob_descs;
+  struct st_hp_blob_chunk *blob_chunks; /* All allocated blob chunks */
   ulonglong data_length,index_length,max_table_size;
   ulonglong auto_increment;
   ulong min_records,max_records;	/* Params to open */
@@ -148,6 +164,7 @@ typedef struct st_heap_share
   uint visible;                         /* Offset to the visible/deleted mark */
   uint changed;
   uint keys,max_key_length;
+  uint blobs;                           /* Number of blob columns */
   uint currently_disabled_keys;    /* saved value from "keys" when disabled */
   uint open_count;
   uchar *del_link;			/* Link to next block with del. rec */
@@ -174,6 +191,7 @@ typedef struct st_heap_info
   uint opt_flag,update;
   uchar *lastkey;			/* Last used key with rkey */
   uchar *recbuf;                         /* Record buffer for rb-tree keys */
+  uchar **blob_ptrs;                    /* Blob copies of record being written */
   enum ha_rkey_function last_find_flag;
   TREE_ELEMENT *parents[MAX_TREE_HEIGHT+1];
   TREE_ELEMENT **last_pos;
@@ -189,6 +207,8 @@ typedef struct st_heap_info
 typedef struct st_heap_create_info
 {
   HP_KEYDEF *keydef;
+  HP_BLOB_DESC *blob_descs;
+  uint blobs;
   uint auto_key;                        /* keynr [1 - maxkey] for auto key */
   uint auto_key_type;
   uint keys;
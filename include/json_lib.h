@@ -65,6 +65,7 @@ typedef struct st_json_string_t
 
   my_charset_conv_mb_wc wc; /* UNICODE conversion function. */
                             /* It's taken out of the cs just to speed calls. */
+  my_bool ascii_based;   /* ASCII bytes are ASCII characters in the cs. */
 } json_string_t;
 
 
@@ -36,6 +36,7 @@ typedef struct st_used_mem
   struct st_used_mem *next;	   /* Next block in use */
   size_t left;                     /* memory left in block  */
   size_t size;                     /* size of block */
+  size_t flags;                    /* USED_MEM_xxx flags */
 } USED_MEM;
 
 
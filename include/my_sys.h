@@ -98,6 +98,7 @@ C_MODE_START
 #define MY_TREE_WITH_DELETE 0x40000U
 #define MY_TRACK 0x80000U             /* Track tmp usage */
 #define MY_TRACK_WITH_LIMIT 0x100000U /* Give error if over tmp_file_usage */
+#define MY_ROOT_USE_BLOCK_CACHE 0x200000U /* init_alloc_root: reuse blocks */
 
 #define MY_CHECK_ERROR	1U	/* Params to my_end; Check open-close */
 #define MY_GIVE_INFO	2U	/* Give time info about process*/
@@ -952,6 +953,9 @@ extern void reset_root_defaults(MEM_ROOT *mem_root, size_t block_size,
 extern void root_make_savepoint(MEM_ROOT *root, MEM_ROOT_SAVEPOINT *sv);
 extern void root_free_to_savepoint(const MEM_ROOT_SAVEPOINT *sv);
 extern void protect_root(MEM_ROOT *root, int prot);
+extern void my_root_block_cache_free(void);
+extern ulonglong my_root_block_cache_size;
+extern int64 my_root_block_cache_hits, my_root_block_cache_misses;
 extern char *strdup_root(MEM_ROOT *root,const char *str);
 static inline char *safe_strdup_root(MEM_ROOT *root, const char *str)
 {
@@ -659,6 +659,10 @@ unsigned long my_net_read_packet_reallen(NET *net, my_bool read_from_server,
 #ifdef MY_GLOBAL_INCLUDED
 void my_net_set_write_timeout(NET *net, uint timeout);
 void my_net_set_read_timeout(NET *net, uint timeout);
+#ifdef HAVE_SENDFILE
+my_bool my_net_write_file(NET *net, const uchar *head, size_t head_len,
+                          File file, my_off_t offset, size_t len);
+#endif
 #endif
 
 struct sockaddr;
@@ -94,6 +94,9 @@ my_bool vio_reset(Vio* vio, enum enum_vio_type type,
 size_t	vio_read(Vio *vio, uchar *	buf, size_t size);
 size_t  vio_read_buff(Vio *vio, uchar * buf, size_t size);
 size_t	vio_write(Vio *vio, const uchar * buf, size_t size);
+#ifdef HAVE_SENDFILE
+size_t  vio_sendfile(Vio *vio, File file, my_off_t offset, size_t size);
+#endif
 int	vio_blocking(Vio *vio, my_bool onoff, my_bool *old_mode);
 my_bool	vio_is_blocking(Vio *vio);
 /* setsockopt TCP_NODELAY at IPPROTO_TCP level, when possible */
@@ -21,6 +21,7 @@
 #include <my_sys.h>
 #include <m_string.h>
 #include <my_bit.h>
+#include <my_atomic.h>
 #ifdef HAVE_SYS_MMAN_H
 #include <sys/mman.h>
 #endif
@@ -31,6 +32,11 @@
 #define ROOT_FLAG_THREAD_SPECIFIC 1
 #define ROOT_FLAG_MPROTECT        2
 #define ROOT_FLAG_READ_ONLY       4
+#define ROOT_FLAG_BLOCK_CACHE     8
+
+/* USED_MEM -> flags */
+#define USED_MEM_BLOCK_CACHE      1     /* Give block back to the block cache */
+#define USED_MEM_THREAD_SPECIFIC  2     /* Block is accounted to the thread */
 
 /* data packed in MEM_ROOT -> min_malloc */
 
@@ -45,13 +51,153 @@
 #define ALIGN_SIZE(X) MY_ALIGN(X, 16)
 
 /*
-  Alloc memory through either my_malloc or mmap()
+  Per thread cache of free MEM_ROOT blocks
+
+  Roots created with MY_ROOT_USE_BLOCK_CACHE (like THD::main_mem_root)
+  do not give their blocks back to malloc() in free_root(). Instead the
+  blocks are kept in a cache local to the OS thread, so that the next
+  statement, or the next connection served by the same thread, can reuse
+  already warmed up memory without calling malloc() and free().
+
+  Blocks are kept in lists by size class, floor(log2(block size)). The
+  total size of the blocks in the cache of one thread is limited by
+  my_root_block_cache_size; 0 disables the cache.
+
+  Cached blocks are always allocated without MY_THREAD_SPECIFIC. Memory
+  accounting of a block is moved to the thread when a thread specific root
+  takes it and back to global memory when the block returns to the cache.
+*/
+
+#define ROOT_BLOCK_CACHE_MIN_CLASS 8            /* ROOT_MIN_BLOCK_SIZE */
+#define ROOT_BLOCK_CACHE_CLASSES   16           /* 256 bytes - 16M */
+
+typedef struct st_root_block_cache
+{
+  USED_MEM *blocks[ROOT_BLOCK_CACHE_CLASSES];
+  size_t size;                                  /* Sum of cached blocks */
+} ROOT_BLOCK_CACHE;
+
+static MY_THREAD_LOCAL ROOT_BLOCK_CACHE root_block_cache;
+
+ulonglong my_root_block_cache_size= 0;
+int64 my_root_block_cache_hits= 0, my_root_block_cache_misses= 0;
+
+static inline uint root_block_cache_class(size_t size)
+{
+  return my_bit_log2_size_t(size) - ROOT_BLOCK_CACHE_MIN_CLASS;
+}
+
+
+/*
+  Get a block of at least 'size' bytes from the block cache
+
+  The first fitting block in the size class of 'size' is used. If there
+  is none, any block from a bigger size class will do.
+*/
+
+static USED_MEM *root_block_cache_get(size_t size)
+{
+  ROOT_BLOCK_CACHE *cache= &root_block_cache;
+  uint i= root_block_cache_class(size);
+  USED_MEM **prev, *block;
+
+  if (i >= ROOT_BLOCK_CACHE_CLASSES)
+    return 0;
+  for (prev= &cache->blocks[i]; (block= *prev); prev= &block->next)
+  {
+    if (block->size >= size)
+      goto found;
+  }
+  for (i++ ; i < ROOT_BLOCK_CACHE_CLASSES; i++)
+  {
+    if ((block= *(prev= &cache->blocks[i])))
+      goto found;
+  }
+  return 0;
+
+found:
+  *prev= block->next;
+  cache->size-= block->size;
+  return block;
+}
+
+
+/*
+  Put a block in the block cache. Returns 1 if the cache is full
+*/
+
+static my_bool root_block_cache_put(USED_MEM *block)
+{
+  ROOT_BLOCK_CACHE *cache= &root_block_cache;
+  uint i= root_block_cache_class(block->size);
+
+  if (i >= ROOT_BLOCK_CACHE_CLASSES ||
+      cache->size + block->size > my_root_block_cache_size)
+    return 1;
+  block->next= cache->blocks[i];
+  cache->blocks[i]= block;
+  cache->size+= block->size;
+  return 0;
+}
+
+
+/**
+  Free all blocks in the block cache of the current thread.
+  Called by my_thread_end().
+*/
+
+void my_root_block_cache_free(void)
+{
+  ROOT_BLOCK_CACHE *cache= &root_block_cache;
+  uint i;
+  for (i= 0; i < ROOT_BLOCK_CACHE_CLASSES; i++)
+  {
+    USED_MEM *block, *next;
+    for (block= cache->blocks[i]; block; block= next)
+    {
+      next= block->next;
+      my_free(block);
+    }
+    cache->blocks[i]= 0;
+  }
+  cache->size= 0;
+}
+
+
+/*
+  Alloc memory through either my_malloc, mmap() or the block cache
 */
 
 static void *root_alloc(MEM_ROOT *root, size_t size, size_t *alloced_size,
 			myf my_flags)
 {
   *alloced_size= size;
+  if (root->flags & ROOT_FLAG_BLOCK_CACHE)
+  {
+    USED_MEM *block;
+    if ((block= root_block_cache_get(size)))
+    {
+      *alloced_size= block->size;
+      my_atomic_add64_explicit(&my_root_block_cache_hits, 1,
+                               MY_MEMORY_ORDER_RELAXED);
+    }
+    else
+    {
+      if (!(block= (USED_MEM*) my_malloc(root->psi_key, size, my_flags)))
+        return 0;
+      my_atomic_add64_explicit(&my_root_block_cache_misses, 1,
+                               MY_MEMORY_ORDER_RELAXED);
+    }
+    block->flags= USED_MEM_BLOCK_CACHE;
+    if (root->flags & ROOT_FLAG_THREAD_SPECIFIC)
+    {
+      /* Move accounting of the block from global memory to the thread */
+      block->flags|= USED_MEM_THREAD_SPECIFIC;
+      update_malloc_size(- (longlong) *alloced_size, 0);
+      update_malloc_size((longlong) *alloced_size, 1);
+    }
+    return block;
+  }
 #if defined(HAVE_MMAP) && defined(HAVE_MPROTECT) && defined(MAP_ANONYMOUS)
   if (root->flags & ROOT_FLAG_MPROTECT)
   {
@@ -61,16 +207,35 @@ static void *root_alloc(MEM_ROOT *root, size_t size, size_t *alloced_size,
                  MAP_NORESERVE | MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
     if (res == MAP_FAILED)
       res= 0;
+    else
+      ((USED_MEM*) res)->flags= 0;
     return res;
   }
 #endif /* HAVE_MMAP */
 
-  return my_malloc(root->psi_key, size,
-		   my_flags | MALLOC_FLAG(root));
+  {
+    USED_MEM *block= (USED_MEM*) my_malloc(root->psi_key, size,
+                                           my_flags | MALLOC_FLAG(root));
+    if (block)
+      block->flags= 0;
+    return block;
+  }
 }
 
 static void root_free(MEM_ROOT *root, void *ptr, size_t size)
 {
+  USED_MEM *block= (USED_MEM*) ptr;
+  if (block->flags & USED_MEM_BLOCK_CACHE)
+  {
+    if (block->flags & USED_MEM_THREAD_SPECIFIC)
+    {
+      update_malloc_size(- (longlong) block->size, 1);
+      update_malloc_size((longlong) block->size, 0);
+    }
+    if (root_block_cache_put(block))
+      my_free(block);
+    return;
+  }
 #if defined(HAVE_MMAP) && defined(HAVE_MPROTECT) && defined(MAP_ANONYMOUS)
   if (root->flags & ROOT_FLAG_MPROTECT)
     my_munmap(ptr, size);
@@ -135,6 +300,8 @@ static void calculate_block_sizes(MEM_ROOT *mem_root, size_t block_size,
                        pre-allocated during memory root initialization.
       my_flags	       MY_THREAD_SPECIFIC flag for my_malloc
                        MY_RROOT_USE_MPROTECT for read only protected memory
+                       MY_ROOT_USE_BLOCK_CACHE to keep freed blocks in
+                       the block cache of the thread for later reuse
 
   DESCRIPTION
     This function prepares memory root for further use, sets initial size of
@@ -164,6 +331,8 @@ void init_alloc_root(PSI_memory_key key, MEM_ROOT *mem_root, size_t block_size,
     mem_root->flags|= ROOT_FLAG_THREAD_SPECIFIC;
   if (my_flags & MY_ROOT_USE_MPROTECT)
     mem_root->flags|= ROOT_FLAG_MPROTECT;
+  else if (my_flags & MY_ROOT_USE_BLOCK_CACHE)
+    mem_root->flags|= ROOT_FLAG_BLOCK_CACHE;
 
   calculate_block_sizes(mem_root, block_size, &pre_alloc_size);
 
@@ -302,6 +471,7 @@ void *alloc_root(MEM_ROOT *mem_root, size_t length)
     next->next= mem_root->used;
     next->left= 0;
     next->size= length;
+    next->flags= 0;
     mem_root->used= next;
     DBUG_PRINT("exit",("ptr: %p", (((char*)next)+ALIGN_SIZE(sizeof(USED_MEM)))));
     DBUG_RETURN((((uchar*) next)+ALIGN_SIZE(sizeof(USED_MEM))));
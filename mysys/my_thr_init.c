@@ -318,6 +318,9 @@ void my_thread_end(void)
 	  tmp, pthread_self(), tmp ? (long) tmp->id : 0L);
 #endif  
 
+  /* Give back MEM_ROOT blocks cached by this thread */
+  my_root_block_cache_free();
+
   /*
     Remove the instrumentation for this thread.
     This must be done before trashing st_my_thread_var,
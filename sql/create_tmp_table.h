@@ -60,6 +60,7 @@ class Create_tmp_table: public Data_type_statistics
                    ulonglong select_options, ha_rows rows_limit);
   virtual ~Create_tmp_table() {}
   virtual bool choose_engine(THD *thd, TABLE *table, TMP_TABLE_PARAM *param);
+  bool blobs_in_key() const;
   void add_field(TABLE *table, Field *field, uint fieldnr,
                  bool force_not_null_cols);
   TABLE *start(THD *thd,
@@ -3810,8 +3810,12 @@ my_decimal* Field_new_decimal::val_decimal(my_decimal *decimal_value)
 {
   DBUG_ASSERT(marked_for_read());
   DBUG_ENTER("Field_new_decimal::val_decimal");
-  binary2my_decimal(E_DEC_FATAL_ERROR, ptr, decimal_value,
-                    precision, dec);
+  longlong nr;
+  if (!val_scaled_longlong(&nr))
+    scaled_longlong2decimal(nr, dec, decimal_value);
+  else
+    binary2my_decimal(E_DEC_FATAL_ERROR, ptr, decimal_value,
+                      precision, dec);
   DBUG_EXECUTE("info", print_decimal_buff(decimal_value, (uchar *) ptr,
                                           bin_size););
   DBUG_RETURN(decimal_value);
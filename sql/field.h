@@ -1971,6 +1971,13 @@ class Field: public Value_source
     return flags & VERS_UPDATE_UNVERSIONED_FLAG;
   }
 
+  /* The hidden column of an expression in a key, like KEY ((a + b)) */
+  bool is_key_expression() const
+  {
+    return invisible == INVISIBLE_FULL && vcol_info &&
+           !(flags & LONG_UNIQUE_HASH_FIELD);
+  }
+
   /*
     Validate a non-null field value stored in the given record
     according to the current thread settings, e.g. sql_mode.
@@ -2583,16 +2590,35 @@ class Field_new_decimal final :public Field_num {
   int  store(longlong nr, bool unsigned_val) override;
   int  store_time_dec(const MYSQL_TIME *ltime, uint dec) override;
   int  store_decimal(const my_decimal *) override;
+  /*
+    Read the value as an integer scaled by 10^dec without making
+    a my_decimal. Returns true if the precision is too big for that.
+  */
+  bool val_scaled_longlong(longlong *to) const
+  {
+    return precision > DECIMAL_SCALED_LONGLONG_PRECISION ||
+           bin2scaled_longlong(ptr, to, precision, dec);
+  }
   double val_real() override
   {
+    longlong nr;
+    double res;
+    if (!val_scaled_longlong(&nr) && !scaled_longlong2double(nr, dec, &res))
+      return res;
     return my_decimal(ptr, precision, dec).to_double();
   }
   longlong val_int() override
   {
+    longlong nr;
+    if (!val_scaled_longlong(&nr) && (nr >= 0 || !unsigned_flag))
+      return scaled_longlong2longlong(nr, dec);
     return my_decimal(ptr, precision, dec).to_longlong(unsigned_flag);
   }
   ulonglong val_uint() override
   {
+    longlong nr;
+    if (!val_scaled_longlong(&nr) && nr >= 0)
+      return (ulonglong) scaled_longlong2longlong(nr, dec);
     return (ulonglong) my_decimal(ptr, precision, dec).to_longlong(true);
   }
   my_decimal *val_decimal(my_decimal *) override;
@@ -2610,6 +2636,9 @@ class Field_new_decimal final :public Field_num {
   }
   bool val_bool() override
   {
+    longlong nr;
+    if (!val_scaled_longlong(&nr))
+      return nr != 0;
     return my_decimal(ptr, precision, dec).to_bool();
   }
   int cmp(const uchar *, const uchar *) const override;
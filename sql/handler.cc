@@ -33,6 +33,7 @@
 #include "sql_base.h"           // TDC_element
 #include "discover.h"           // extension_based_table_discovery, etc
 #include "log_event.h"          // *_rows_log_event
+#include "log_cache.h"          // binlog_cache_data
 #include "create_options.h"
 #include <myisampack.h>
 #include "transaction.h"
@@ -7969,9 +7970,14 @@ static int binlog_log_row_to_binlog(TABLE* table,
   auto *cache= binlog_get_cache_data(cache_mngr,
                                      use_trans_cache(thd, has_trans));
 
-    error= (*log_func)(thd, table, mysql_bin_log.as_event_log(), cache,
-                       has_trans, thd->variables.binlog_row_image,
-                       before_record, after_record);
+  if (before_record)
+    cache->writeset.add_row(table, before_record, false);
+  if (after_record)
+    cache->writeset.add_row(table, after_record, true);
+
+  error= (*log_func)(thd, table, mysql_bin_log.as_event_log(), cache,
+                     has_trans, thd->variables.binlog_row_image,
+                     before_record, after_record);
   DBUG_RETURN(error ? HA_ERR_RBR_LOGGING_FAILED : 0);
 }
 
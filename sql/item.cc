@@ -9596,7 +9596,7 @@ void Item_cache_wrapper::cleanup()
 
 
 /**
-  Create an expression cache that uses a temporary table
+  Create an expression cache that uses an in-memory hash table
 
   @param thd           Thread handle
   @param depends_on    Parameters of the expression to create cache for
@@ -9604,8 +9604,9 @@ void Item_cache_wrapper::cleanup()
   @details
   The function takes 'depends_on' as the list of all parameters for
   the expression wrapped into this object and creates an expression
-  cache in a temporary table containing the field for the parameters
-  and the result of the expression.
+  cache in a hash table keyed on the parameters. Types that can't be
+  hashed are cached in a temporary table containing the field for the
+  parameters and the result of the expression.
 
   @retval FALSE OK
   @retval TRUE  Error
@@ -9615,7 +9616,7 @@ bool Item_cache_wrapper::set_cache(THD *thd)
 {
   DBUG_ENTER("Item_cache_wrapper::set_cache");
   DBUG_ASSERT(expr_cache == 0);
-  expr_cache= new Expression_cache_tmptable(thd, parameters, expr_value);
+  expr_cache= new Expression_cache_hash(thd, parameters, expr_value);
   DBUG_RETURN(expr_cache == NULL);
 }
 
@@ -9626,7 +9627,7 @@ Expression_cache_tracker* Item_cache_wrapper::init_tracker(MEM_ROOT *mem_root)
     Expression_cache_tracker* tracker=
       new(mem_root) Expression_cache_tracker(expr_cache);
     if (tracker)
-      ((Expression_cache_tmptable *)expr_cache)->set_tracker(tracker);
+      expr_cache->set_tracker(tracker);
     return tracker;
   }
   return NULL;
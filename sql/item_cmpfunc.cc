@@ -746,10 +746,30 @@ bool Arg_comparator::set_cmp_func_real(THD *thd)
   return false;
 }
 
+/*
+  Return the DECIMAL field of an item if its values can be read
+  as scaled integers, see Field_new_decimal::val_scaled_longlong()
+*/
+static Field_new_decimal *scaled_decimal_field(Item *item)
+{
+  if (item->type() != Item::FIELD_ITEM)
+    return NULL;
+  Field *field= ((Item_field*) item)->field;
+  if (field->type_handler() != &type_handler_newdecimal ||
+      ((Field_new_decimal*) field)->precision >
+        DECIMAL_SCALED_LONGLONG_PRECISION)
+    return NULL;
+  return (Field_new_decimal*) field;
+}
+
+
 bool Arg_comparator::set_cmp_func_decimal(THD *thd)
 {
   func= is_owner_equal_func() ? &Arg_comparator::compare_e_decimal :
                                 &Arg_comparator::compare_decimal;
+  if (scaled_decimal_field(*a) && scaled_decimal_field(*b))
+    func= is_owner_equal_func() ? &Arg_comparator::compare_e_decimal_fields :
+                                  &Arg_comparator::compare_decimal_fields;
   a= cache_converted_constant(thd, a, &a_cache, compare_type_handler());
   b= cache_converted_constant(thd, b, &b_cache, compare_type_handler());
   return false;
@@ -984,6 +1004,46 @@ int Arg_comparator::compare_e_decimal()
 }
 
 
+/*
+  Compare two DECIMAL fields of the same scale as scaled integers.
+  The arguments are checked again on every call, they can be replaced
+  after set_cmp_func(), in which case this falls back to my_decimal.
+*/
+
+int Arg_comparator::compare_decimal_fields()
+{
+  Field_new_decimal *field1= scaled_decimal_field(*a);
+  Field_new_decimal *field2= scaled_decimal_field(*b);
+  longlong val1, val2;
+  if (field1 && field2 && field1->dec == field2->dec &&
+      !field1->is_null() && !field2->is_null() &&
+      !field1->val_scaled_longlong(&val1) &&
+      !field2->val_scaled_longlong(&val2))
+  {
+    (*a)->null_value= (*b)->null_value= false;
+    return compare_not_null_values(val1, val2);
+  }
+  return compare_decimal();
+}
+
+
+int Arg_comparator::compare_e_decimal_fields()
+{
+  Field_new_decimal *field1= scaled_decimal_field(*a);
+  Field_new_decimal *field2= scaled_decimal_field(*b);
+  longlong val1, val2;
+  if (field1 && field2 && field1->dec == field2->dec &&
+      !field1->is_null() && !field2->is_null() &&
+      !field1->val_scaled_longlong(&val1) &&
+      !field2->val_scaled_longlong(&val2))
+  {
+    (*a)->null_value= (*b)->null_value= false;
+    return MY_TEST(val1 == val2);
+  }
+  return compare_e_decimal();
+}
+
+
 int Arg_comparator::compare_real_fixed()
 {
   /*
@@ -129,6 +129,8 @@ class Arg_comparator: public Sql_alloc
   int compare_e_row();           // compare args[0] & args[1]
   int compare_real_fixed();
   int compare_e_real_fixed();
+  int compare_decimal_fields();
+  int compare_e_decimal_fields();
   int compare_datetime();
   int compare_e_datetime();
   int compare_time();
@@ -21,6 +21,8 @@
 #include "item.h"
 #include "sql_parse.h" // For check_stack_overrun
 #include "json_schema_helper.h"
+#include "sql_type_jsonb.h"
+#include "json_binary.h"
 
 static bool get_current_value(json_engine_t *, const uchar *&, size_t &);
 static int check_overlaps(json_engine_t *, json_engine_t *, bool, MEM_ROOT*, json_engine_t *temp_je, MEM_ROOT_DYNAMIC_ARRAY *stack);
@@ -104,6 +106,44 @@ append_simple(String *s, const uchar *a, size_t a_len)
 }
 
 
+/*
+  The JSONB column the argument is, or NULL. The functions look for
+  values in its image instead of parsing the text of the document.
+*/
+static Field_jsonb *jsonb_field(Item *item)
+{
+  Item *real= item->real_item();
+  if (real->type() != Item::FIELD_ITEM ||
+      real->type_handler() != &type_handler_jsonb)
+    return NULL;
+  return static_cast<Field_jsonb*>(static_cast<Item_field*>(real)->field);
+}
+
+
+/*
+  Writes the text of the value at the path of the JSONB column to str and
+  starts scanning it with je.
+*/
+static jsonb_find_result jsonb_extract(Field_jsonb *field,
+                                       const json_path_t *path, int last_step,
+                                       String *str, json_engine_t *je)
+{
+  size_t pos;
+  jsonb_find_result res= json_binary_find(field->get_ptr(),
+                                          field->get_length(),
+                                          path, last_step, &pos);
+  if (res != JSONB_FOUND)
+    return res;
+  str->set_charset(field->charset());
+  str->length(0);
+  if (json_binary_to_text(str, field->get_ptr(), pos))
+    return JSONB_ERROR;
+  json_scan_start(je, str->charset(), (const uchar *) str->ptr(),
+                  (const uchar *) str->end());
+  return json_read_value(je) ? JSONB_ERROR : JSONB_FOUND;
+}
+
+
 /*
   Appends JSON string to the String object taking charsets in
   consideration.
@@ -841,7 +881,8 @@ bool Json_path_extractor::extract(MEM_ROOT *mem_root, String *str,
                                   MEM_ROOT_DYNAMIC_ARRAY *array_counters,
                                   const char *func_name, bool allow_wildcard)
 {
-  String *js= item_js->val_json(&tmp_js);
+  Field_jsonb *jsonb= jsonb_field(item_js);
+  String *js= jsonb ? NULL : item_js->val_json(&tmp_js);
   json_path_step_t *tmp_ptr= NULL;
   int error= 0;
 
@@ -874,14 +915,38 @@ bool Json_path_extractor::extract(MEM_ROOT *mem_root, String *str,
     parsed= constant;
   }
 
-  if (item_js->null_value || item_jp->null_value)
+  if ((jsonb ? jsonb->is_null() : item_js->null_value) ||
+      item_jp->null_value)
     return true;
 
-  json_scan_start(&je, js->charset(), (const uchar*)js->ptr(),
-                                    (const uchar*)js->end());
   str->length(0);
   str->set_charset(cs);
 
+  if (jsonb)
+  {
+    switch (jsonb_extract(jsonb, &p, p.last_step_idx, &tmp_js, &je)) {
+    case JSONB_FOUND:
+      if (je.value_type == JSON_VALUE_NULL)
+        return true;
+      if (!check_and_get_value(&je, str, &error))
+        return false;
+      /* the value is not of the kind, a duplicate key may be */
+      str->length(0);
+      error= 0;
+      break;
+    case JSONB_NOT_FOUND:
+      return true;
+    case JSONB_UNSUPPORTED:
+    case JSONB_ERROR:
+      break;
+    }
+    if (!(js= item_js->val_json(&tmp_js)))
+      return true;
+  }
+
+  json_scan_start(&je, js->charset(), (const uchar*)js->ptr(),
+                                    (const uchar*)js->end());
+
   cur_step= &p.steps;
   tmp_ptr= (json_path_step_t*)(p.steps.buffer);
 continue_search:
@@ -1263,7 +1328,8 @@ String *Item_func_json_extract::read_json(String *str,
                                           json_value_types *type,
                                           char **out_val, int *value_len)
 {
-  String *js= args[0]->val_json(&tmp_js);
+  Field_jsonb *jsonb= jsonb_field(args[0]);
+  String *js= jsonb ? NULL : args[0]->val_json(&tmp_js);
   const uchar *value;
   int not_first_value= 0, count_path= 0;
   uint n_arg;
@@ -1272,7 +1338,7 @@ String *Item_func_json_extract::read_json(String *str,
   uint has_negative_path= 0;
   THD *thd;
 
-  if ((null_value= args[0]->null_value))
+  if ((null_value= jsonb ? jsonb->is_null() : args[0]->null_value))
     return 0;
 
   thd= current_thd;
@@ -1307,6 +1373,28 @@ String *Item_func_json_extract::read_json(String *str,
     (paths[0].p.types_used & (JSON_PATH_WILD | JSON_PATH_DOUBLE_WILD |
                               JSON_PATH_ARRAY_RANGE));
 
+  if (jsonb)
+  {
+    if (!possible_multiple_values)
+    {
+      /* the text of the value is what json_nice() would return */
+      switch (jsonb_extract(jsonb, &paths[0].p, paths[0].p.last_step_idx,
+                            &tmp_js, &je)) {
+      case JSONB_FOUND:
+        *type= je.value_type;
+        *out_val= (char *) je.value;
+        *value_len= je.value_len;
+        return &tmp_js;
+      case JSONB_NOT_FOUND:
+        goto return_null;
+      case JSONB_UNSUPPORTED:
+      case JSONB_ERROR:
+        break;
+      }
+    }
+    js= args[0]->val_json(&tmp_js);
+  }
+
   *type= possible_multiple_values ? JSON_VALUE_ARRAY : JSON_VALUE_NULL;
 
   if (str)
@@ -3665,6 +3753,101 @@ bool Item_func_json_insert::fix_length_and_dec(THD *thd)
 }
 
 
+/*
+  Parses the path of the n_path-th pair, the last step of it is not
+  searched for. Returns true if the path is NULL or wrong.
+*/
+bool Item_func_json_insert::setup_path(uint n_path)
+{
+  const uint n_arg= 1 + n_path * 2;
+  json_path_with_flags *c_path= paths + n_path;
+
+  if (!c_path->parsed)
+  {
+    String *s_p= args[n_arg]->val_str(tmp_paths+n_path);
+    if (s_p)
+    {
+      if (path_setup_nwc(&c_path->p,s_p->charset(),
+                         (const uchar *) s_p->ptr(),
+                         (const uchar *) s_p->ptr() + s_p->length()))
+      {
+        report_path_error(s_p, &c_path->p, n_arg);
+        return true;
+      }
+
+      /* We search to the last step. */
+      c_path->p.last_step_idx--;
+    }
+    c_path->parsed= c_path->constant;
+  }
+  return args[n_arg]->null_value;
+}
+
+
+/*
+  JSON_REPLACE() and JSON_SET() of a JSONB column stored into a JSONB
+  column replace the values in a copy of the image, the document is not
+  parsed or printed. What the image cannot do, like adding a member or
+  an element, is done by val_str().
+*/
+int Item_func_json_insert::save_in_field(Field *field, bool no_conversions)
+{
+  Field_jsonb *jsonb;
+
+  if (!mode_replace || field->type_handler() != &type_handler_jsonb ||
+      !(jsonb= jsonb_field(args[0])) || (used_tables() & RAND_TABLE_BIT))
+    return Item_json_str_multipath::save_in_field(field, no_conversions);
+
+  if (jsonb->is_null())
+  {
+    null_value= true;
+    return set_field_to_null_with_conversions(field, no_conversions);
+  }
+
+  if (tmp_js.copy((const char *) jsonb->get_ptr(), jsonb->get_length(),
+                  &my_charset_bin))
+    return Item_json_str_multipath::save_in_field(field, no_conversions);
+
+  for (uint n_path= 0; n_path < arg_count / 2; n_path++)
+  {
+    json_path_t *path= &paths[n_path].p;
+
+    if (setup_path(n_path))
+    {
+      null_value= true;
+      return set_field_to_null_with_conversions(field, no_conversions);
+    }
+
+    tmp_value_js.set_charset(&my_charset_utf8mb4_bin);
+    tmp_value_js.length(0);
+    if (append_json_value(&tmp_value_js, args[n_path * 2 + 2], &tmp_val) ||
+        json_binary_from_text(&tmp_value_image, tmp_value_js.ptr(),
+                              tmp_value_js.length(),
+                              tmp_value_js.charset()))
+      return Item_json_str_multipath::save_in_field(field, no_conversions);
+
+    switch (json_binary_replace(&tmp_js, path, path->last_step_idx + 1,
+                                (const uchar *) tmp_value_image.ptr(),
+                                tmp_value_image.length())) {
+    case JSONB_FOUND:
+      break;
+    case JSONB_NOT_FOUND:
+      if (!mode_insert)
+        break;
+      /* fall through */
+    case JSONB_UNSUPPORTED:
+    case JSONB_ERROR:
+      return Item_json_str_multipath::save_in_field(field, no_conversions);
+    }
+  }
+
+  null_value= false;
+  field->set_notnull();
+  return static_cast<Field_jsonb*>(field)->store_binary(tmp_js.ptr(),
+                                                        tmp_js.length());
+}
+
+
 String *Item_func_json_insert::val_str(String *str)
 {
   String *js= args[0]->val_json(&tmp_js);
@@ -3692,25 +3875,7 @@ String *Item_func_json_insert::val_str(String *str)
     json_path_step_t *lp= NULL, *last_step=NULL, *initial_step= NULL;
     int corrected_n_item;
 
-    if (!c_path->parsed)
-    {
-      String *s_p= args[n_arg]->val_str(tmp_paths+n_path);
-      if (s_p)
-      {
-        if (path_setup_nwc(&c_path->p,s_p->charset(),
-                           (const uchar *) s_p->ptr(),
-                           (const uchar *) s_p->ptr() + s_p->length()))
-        {
-          report_path_error(s_p, &c_path->p, n_arg);
-          goto return_null;
-        }
-
-        /* We search to the last step. */
-        c_path->p.last_step_idx--;
-      }
-      c_path->parsed= c_path->constant;
-    }
-    if (args[n_arg]->null_value)
+    if (setup_path(n_path))
       goto return_null;
 
     json_scan_start(&je, js->charset(),(const uchar *) js->ptr(),
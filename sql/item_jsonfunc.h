@@ -681,9 +681,11 @@ class Item_func_json_insert: public Item_json_str_multipath
 protected:
   String tmp_js;
   String tmp_val;
+  String tmp_value_js, tmp_value_image;
   bool mode_insert, mode_replace;
   json_engine_t je;
   MEM_ROOT_DYNAMIC_ARRAY json_depth_array;
+  bool setup_path(uint n_path);
 
 public:
   Item_func_json_insert(bool i_mode, bool r_mode, THD *thd, List<Item> &list):
@@ -691,6 +693,7 @@ class Item_func_json_insert: public Item_json_str_multipath
       mode_insert(i_mode), mode_replace(r_mode) {}
   bool fix_length_and_dec(THD *thd) override;
   String *val_str(String *) override;
+  int save_in_field(Field *field, bool no_conversions) override;
   uint get_n_paths() const override { return arg_count/2; }
   LEX_CSTRING func_name_cstring() const override
   {
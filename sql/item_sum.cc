@@ -32,6 +32,7 @@
 #include "sp_head.h"
 #include "item_sum.h"
 #include "sql_type_geom.h"
+#include "key.h"                                // key_hashnr
 
 /**
   Calculate the affordable RAM limit for structures like TREE or Unique
@@ -1520,6 +1521,8 @@ Item_sum_sum::Item_sum_sum(THD *thd, Item_sum_sum *item)
    Type_handler_hybrid_field_type(item),
    direct_added(FALSE), direct_reseted_field(FALSE),
    curr_dec_buff(item->curr_dec_buff),
+   scaled_sum(item->scaled_sum), scaled_sum_scale(item->scaled_sum_scale),
+   scaled_sum_pending(item->scaled_sum_pending),
    count(item->count)
 {
   /* TODO: check if the following assignments are really needed */
@@ -1556,6 +1559,8 @@ void Item_sum_sum::clear()
   {
     curr_dec_buff= 0;
     my_decimal_set_zero(dec_buffs);
+    scaled_sum= 0;
+    scaled_sum_pending= FALSE;
   }
   else
     sum= 0.0;
@@ -1663,6 +1668,8 @@ void Item_sum_sum::add_helper(bool perform_removal)
     else
     {
       direct_reseted_field= FALSE;
+      if (add_scaled_decimal(perform_removal))
+        DBUG_VOID_RETURN;
       my_decimal value;
       const my_decimal *val= aggr->arg_val_decimal(&value);
       if (!aggr->arg_is_null(true))
@@ -1730,13 +1737,81 @@ void Item_sum_sum::add_helper(bool perform_removal)
 }
 
 
+/*
+  Add the value of a DECIMAL field with up to
+  DECIMAL_SCALED_LONGLONG_PRECISION digits to scaled_sum, which is
+  much cheaper than my_decimal_add(). scaled_sum is folded into
+  dec_buffs before it would overflow, when the scale of the values
+  changes and before the sum is read.
+
+  @retval false  the argument is not such a field, add it as my_decimal
+  @retval true   the value has been added
+*/
+
+bool Item_sum_sum::add_scaled_decimal(bool perform_removal)
+{
+  Field_new_decimal *field;
+  longlong nr;
+
+  if (aggr->Aggrtype() != Aggregator::SIMPLE_AGGREGATOR ||
+      args[0]->type() != FIELD_ITEM)
+    return false;
+  Field *arg_field= ((Item_field*) args[0])->field;
+  if (arg_field->type_handler() != &type_handler_newdecimal)
+    return false;
+  field= static_cast<Field_new_decimal*>(arg_field);
+  if ((args[0]->null_value= field->is_null()))
+    return true;
+  if (field->val_scaled_longlong(&nr))
+    return false;
+
+  if (perform_removal)
+  {
+    if (!count)
+      return true;
+    nr= -nr;
+    count--;
+  }
+  else
+    count++;
+  if (scaled_sum_pending &&
+      (scaled_sum_scale != field->dec ||
+       (nr > 0 ? scaled_sum > LONGLONG_MAX - nr :
+                 scaled_sum < LONGLONG_MIN - nr)))
+    fold_scaled_sum();
+  scaled_sum+= nr;
+  scaled_sum_scale= field->dec;
+  scaled_sum_pending= TRUE;
+  null_value= (count > 0) ? 0 : 1;
+  return true;
+}
+
+
+void Item_sum_sum::fold_scaled_sum()
+{
+  if (scaled_sum_pending)
+  {
+    my_decimal value;
+    scaled_longlong2decimal(scaled_sum, scaled_sum_scale, &value);
+    my_decimal_add(E_DEC_FATAL_ERROR, dec_buffs + (curr_dec_buff ^ 1),
+                   &value, dec_buffs + curr_dec_buff);
+    curr_dec_buff^= 1;
+    scaled_sum= 0;
+    scaled_sum_pending= FALSE;
+  }
+}
+
+
 longlong Item_sum_sum::val_int()
 {
   DBUG_ASSERT(fixed());
   if (aggr)
     aggr->endup();
   if (result_type() == DECIMAL_RESULT)
+  {
+    fold_scaled_sum();
     return dec_buffs[curr_dec_buff].to_longlong(unsigned_flag);
+  }
   return val_int_from_real();
 }
 
@@ -1747,7 +1822,10 @@ double Item_sum_sum::val_real()
   if (aggr)
     aggr->endup();
   if (result_type() == DECIMAL_RESULT)
+  {
+    fold_scaled_sum();
     sum= dec_buffs[curr_dec_buff].to_double();
+  }
   return sum;
 }
 
@@ -1767,7 +1845,10 @@ my_decimal *Item_sum_sum::val_decimal(my_decimal *val)
   if (aggr)
     aggr->endup();
   if (result_type() == DECIMAL_RESULT)
+  {
+    fold_scaled_sum();
     return null_value ? NULL : (dec_buffs + curr_dec_buff);
+  }
   return val_decimal_from_real(val);
 }
 
@@ -1875,6 +1956,189 @@ bool Aggregator_simple::arg_is_null(bool use_null_value)
 }
 
 
+/***************************************************************************
+** Group_by_hash
+***************************************************************************/
+
+#define GROUP_BY_HASH_INITIAL_SIZE 256
+
+Group_by_hash::Group_by_hash(KEY *key_info_arg, uint key_length_arg,
+                             uint rec_length_arg, size_t memory_limit_arg)
+  :key_info(key_info_arg), key_length(key_length_arg),
+   rec_length(rec_length_arg), slots(NULL), size(0), records(0),
+   first_entry(NULL), last_next(&first_entry), memory_used(0),
+   memory_limit(memory_limit_arg), active(true)
+{
+  entry_length= (uint) ALIGN_SIZE(sizeof(uchar*) + rec_length + key_length);
+  init_alloc_root(PSI_INSTRUMENT_ME, &entry_root,
+                  MY_MAX(entry_length * 64, 4096), 0,
+                  MYF(MY_THREAD_SPECIFIC));
+}
+
+
+/**
+  Check if all aggregate functions can be computed in the hash table.
+
+  Only functions that keep their whole state in their result field of the
+  temporary table record qualify.
+*/
+
+bool Group_by_hash::supported(Item_sum **func_ptr)
+{
+  Item_sum *func;
+  while ((func= *(func_ptr++)))
+  {
+    switch (func->sum_func()) {
+    case Item_sum::COUNT_FUNC:
+    case Item_sum::SUM_FUNC:
+    case Item_sum::AVG_FUNC:
+    case Item_sum::MIN_FUNC:
+    case Item_sum::MAX_FUNC:
+      break;
+    default:
+      return false;
+    }
+  }
+  return true;
+}
+
+
+/** Remove all groups and make the hash table usable again */
+
+void Group_by_hash::reset()
+{
+  if (records)
+  {
+    bzero((void*) slots, size * sizeof(Slot));
+    free_root(&entry_root, MYF(MY_MARK_BLOCKS_FREE));
+    memory_used= size * sizeof(Slot);
+  }
+  records= 0;
+  first_entry= NULL;
+  last_next= &first_entry;
+  active= true;
+}
+
+
+void Group_by_hash::free()
+{
+  my_free(slots);
+  slots= NULL;
+  size= records= 0;
+  free_root(&entry_root, MYF(0));
+  first_entry= NULL;
+  last_next= &first_entry;
+  memory_used= 0;
+}
+
+
+ulong Group_by_hash::hash_key(const uchar *key) const
+{
+  return key_hashnr(key_info, key_info->user_defined_key_parts, key);
+}
+
+
+/**
+  Find the record of a group
+
+  @return pointer to the record, NULL if the group is not in the table
+*/
+
+uchar *Group_by_hash::find(const uchar *key, ulong hash) const
+{
+  if (!records)
+    return NULL;
+  ulong mask= size - 1;
+  for (ulong idx= hash & mask; slots[idx].entry; idx= (idx + 1) & mask)
+  {
+    if (slots[idx].hash == hash &&
+        !key_buf_cmp(key_info, key_info->user_defined_key_parts,
+                     entry_key(slots[idx].entry), key))
+      return slots[idx].entry + sizeof(uchar*);
+  }
+  return NULL;
+}
+
+
+/** Double the number of slots, keeping the load factor at most 1/2 */
+
+bool Group_by_hash::grow()
+{
+  ulong new_size= size ? size * 2 : GROUP_BY_HASH_INITIAL_SIZE;
+  Slot *new_slots;
+  if (!(new_slots= (Slot*) my_malloc(PSI_INSTRUMENT_ME,
+                                     new_size * sizeof(Slot),
+                                     MYF(MY_THREAD_SPECIFIC | MY_ZEROFILL))))
+    return true;
+  ulong mask= new_size - 1;
+  for (ulong i= 0; i < size; i++)
+  {
+    if (!slots[i].entry)
+      continue;
+    ulong idx= slots[i].hash & mask;
+    while (new_slots[idx].entry)
+      idx= (idx + 1) & mask;
+    new_slots[idx]= slots[i];
+  }
+  my_free(slots);
+  memory_used+= (new_size - size) * sizeof(Slot);
+  slots= new_slots;
+  size= new_size;
+  return false;
+}
+
+
+/**
+  Make room for one more group
+
+  @retval true   there is room, insert() can be called
+  @retval false  the memory limit is reached
+*/
+
+bool Group_by_hash::reserve()
+{
+  if ((records + 1) * 2 > size)
+  {
+    size_t new_slots_size= (size ? size : GROUP_BY_HASH_INITIAL_SIZE / 2) *
+                           sizeof(Slot);
+    if (memory_used + new_slots_size + entry_length > memory_limit ||
+        grow())
+      return false;
+  }
+  return memory_used + entry_length <= memory_limit;
+}
+
+
+/**
+  Add a new group, reserve() must have been called before
+
+  @return true on out of memory
+*/
+
+bool Group_by_hash::insert(const uchar *key, ulong hash, const uchar *record)
+{
+  uchar *entry;
+  DBUG_ASSERT((records + 1) * 2 <= size);
+  if (!(entry= (uchar*) alloc_root(&entry_root, entry_length)))
+    return true;
+  *(uchar**) entry= NULL;
+  memcpy(entry + sizeof(uchar*), record, rec_length);
+  memcpy(entry_key(entry), key, key_length);
+  *last_next= entry;
+  last_next= (uchar**) entry;
+
+  ulong mask= size - 1;
+  ulong idx= hash & mask;
+  while (slots[idx].entry)
+    idx= (idx + 1) & mask;
+  slots[idx].hash= hash;
+  slots[idx].entry= entry;
+  records++;
+  memory_used+= entry_length;
+  return false;
+}
+
+
 my_decimal *Aggregator_distinct::arg_val_decimal(my_decimal * value)
 {
   return use_distinct_values ? table->field[0]->val_decimal(value) :
@@ -2112,6 +2376,7 @@ my_decimal *Item_sum_avg::val_decimal(my_decimal *val)
   if (result_type() != DECIMAL_RESULT)
     return val_decimal_from_real(val);
 
+  fold_scaled_sum();
   sum_dec= dec_buffs + curr_dec_buff;
   int2my_decimal(E_DEC_FATAL_ERROR, count, 0, &cnt);
   my_decimal_div(E_DEC_FATAL_ERROR, val, sum_dec, &cnt, prec_increment);
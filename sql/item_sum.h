@@ -741,6 +741,74 @@ class Aggregator_simple : public Aggregator
 };
 
 
+/**
+  In-memory hash table for GROUP BY with partial sums.
+
+  Used by end_update() in front of the temporary table: each group is kept
+  as a complete temporary table record, so that the aggregate functions can
+  update their result fields in place with Item_sum::update_field(), without
+  any handler calls. The groups are written to the temporary table once all
+  rows are processed, or when the table would grow beyond its memory limit
+  (after which the normal temporary table algorithm takes over).
+
+  The table uses open addressing with linear probing. A slot holds the hash
+  value of the key next to the entry pointer, so that most mismatches are
+  resolved without touching the entry. Keys are in the key format of the
+  temporary table group key and are compared with key_buf_cmp(), which
+  respects the collations of the group columns.
+
+  Entries are kept in insertion order, so the temporary table gets the
+  groups in the same order as without the hash table.
+*/
+
+class Group_by_hash :public Sql_alloc
+{
+  struct Slot
+  {
+    ulong hash;
+    uchar *entry;
+  };
+  KEY *key_info;
+  uint key_length, rec_length;
+  /* Entry: next entry, record, key */
+  uint entry_length;
+  Slot *slots;
+  ulong size, records;
+  MEM_ROOT entry_root;
+  uchar *first_entry, **last_next;
+  size_t memory_used, memory_limit;
+  bool active;
+
+  uchar *entry_key(uchar *entry) const
+  { return entry + sizeof(uchar*) + rec_length; }
+  bool grow();
+public:
+  Group_by_hash(KEY *key_info_arg, uint key_length_arg, uint rec_length_arg,
+                size_t memory_limit_arg);
+  ~Group_by_hash() { free(); }
+  static bool supported(Item_sum **func_ptr);
+  void reset();
+  void free();
+  /* FALSE after the groups were moved to the temporary table */
+  bool is_active() const { return active; }
+  void deactivate() { reset(); active= false; }
+  ulong hash_key(const uchar *key) const;
+  uchar *find(const uchar *key, ulong hash) const;
+  bool reserve();
+  bool insert(const uchar *key, ulong hash, const uchar *record);
+  ulong elements() const { return records; }
+
+  /* Records of all groups, in insertion order */
+  uchar *first_record() const
+  { return first_entry ? first_entry + sizeof(uchar*) : NULL; }
+  uchar *next_record(const uchar *record) const
+  {
+    uchar *next= *(uchar**) (record - sizeof(uchar*));
+    return next ? next + sizeof(uchar*) : NULL;
+  }
+};
+
+
 class Item_sum_num :public Item_sum
 {
 public:
@@ -825,12 +893,21 @@ class Item_sum_sum :public Item_sum_num,
   my_decimal direct_sum_decimal;
   my_decimal dec_buffs[2];
   uint curr_dec_buff;
+  /*
+    Sum of DECIMAL field values not yet added to dec_buffs, as an integer
+    scaled by 10^scaled_sum_scale, see add_scaled_decimal()
+  */
+  longlong scaled_sum;
+  decimal_digits_t scaled_sum_scale;
+  bool scaled_sum_pending;
   bool fix_length_and_dec(THD *thd) override;
+  void fold_scaled_sum();
 
 public:
   Item_sum_sum(THD *thd, Item *item_par, bool distinct):
     Item_sum_num(thd, item_par), direct_added(FALSE),
-    direct_reseted_field(FALSE)
+    direct_reseted_field(FALSE), scaled_sum(0), scaled_sum_scale(0),
+    scaled_sum_pending(FALSE)
   {
     set_distinct(distinct);
   }
@@ -874,6 +951,7 @@ class Item_sum_sum :public Item_sum_num,
 
 private:
   void add_helper(bool perform_removal);
+  bool add_scaled_decimal(bool perform_removal);
   ulonglong count;
 
 protected:
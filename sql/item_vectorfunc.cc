@@ -23,30 +23,7 @@
 #include "item_vectorfunc.h"
 #include "vector_mhnsw.h"
 #include "sql_type_vector.h"
-
-static double calc_distance_euclidean(float *v1, float *v2, size_t v_len)
-{
-  double d= 0;
-  for (size_t i= 0; i < v_len; i++, v1++, v2++)
-  {
-    double dist= get_float(v1) - get_float(v2);
-    d+= dist * dist;
-  }
-  return sqrt(d);
-}
-
-static double calc_distance_cosine(float *v1, float *v2, size_t v_len)
-{
-  double dotp=0, abs1=0, abs2=0;
-  for (size_t i= 0; i < v_len; i++, v1++, v2++)
-  {
-    float f1= get_float(v1), f2= get_float(v2);
-    abs1+= f1 * f1;
-    abs2+= f2 * f2;
-    dotp+= f1 * f2;
-  }
-  return 1 - dotp/sqrt(abs1*abs2);
-}
+#include "vector_kernels.h"
 
 Item_func_vec_distance::Item_func_vec_distance(THD *thd, Item *a, Item *b,
                                                distance_kind kind)
@@ -57,8 +34,8 @@ Item_func_vec_distance::Item_func_vec_distance(THD *thd, Item *a, Item *b,
 bool Item_func_vec_distance::fix_length_and_dec(THD *thd)
 {
   switch (kind) {
-  case EUCLIDEAN: calc_distance= calc_distance_euclidean; break;
-  case COSINE:    calc_distance= calc_distance_cosine; break;
+  case EUCLIDEAN: calc_distance= vec_kernels->distance_euclidean; break;
+  case COSINE:    calc_distance= vec_kernels->distance_cosine; break;
   case AUTO:
     for (uint i=0; i < 2; i++)
       if (auto *item= dynamic_cast<Item_field*>(args[i]->real_item()))
@@ -37,7 +37,7 @@ class Item_func_vec_distance: public Item_real_func
   {
     return check_argument_types_or_binary(NULL, 0, arg_count);
   }
-  double (*calc_distance)(float *v1, float *v2, size_t v_len);
+  double (*calc_distance)(const float *v1, const float *v2, size_t v_len);
 
 public:
   enum distance_kind { EUCLIDEAN, COSINE, AUTO } kind;
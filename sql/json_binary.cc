@@ -0,0 +1,442 @@
+/*
+   Copyright (c) 2026, MariaDB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+#include "mariadb.h"
+#include "json_binary.h"
+#include "sql_array.h"
+#include <algorithm>
+
+/*
+  Values are written and read recursively, this limits the depth of
+  a document that can be stored in a JSONB column
+*/
+static constexpr uint JSONB_MAX_DEPTH= 1024;
+/* Longer paths are followed in the text */
+static constexpr int JSONB_MAX_PATH= 64;
+
+static constexpr size_t CONTAINER_HEADER= 1 + 4 + 4;
+static constexpr size_t ARRAY_ENTRY= 4;
+static constexpr size_t MEMBER_ENTRY= 4 + 4 + 4;
+static constexpr size_t SORTED_ENTRY= 4;
+
+static inline uint32 jsonb_count(const uchar *v) { return uint4korr(v + 1); }
+static inline uint32 jsonb_size(const uchar *v)  { return uint4korr(v + 5); }
+
+static inline size_t jsonb_table_size(const uchar *v)
+{
+  return jsonb_count(v) * (*v == JSON_VALUE_OBJECT ? MEMBER_ENTRY + SORTED_ENTRY
+                                                   : ARRAY_ENTRY);
+}
+
+static inline const uchar *jsonb_table(const uchar *v)
+{
+  return v + jsonb_size(v) - jsonb_table_size(v);
+}
+
+static size_t jsonb_value_size(const uchar *v)
+{
+  switch (*v) {
+  case JSON_VALUE_OBJECT:
+  case JSON_VALUE_ARRAY:
+    return jsonb_size(v);
+  case JSON_VALUE_STRING:
+  case JSON_VALUE_NUMBER:
+    return 5 + uint4korr(v + 1);
+  default:
+    return 1;
+  }
+}
+
+static inline const uchar *jsonb_key(const uchar *obj, uint32 n,
+                                     uint32 *length)
+{
+  const uchar *member= jsonb_table(obj) + n * MEMBER_ENTRY;
+  *length= uint4korr(member + 4);
+  return obj + uint4korr(member);
+}
+
+
+/************* writing ****************************************************/
+
+class Json_binary_writer
+{
+  json_engine_t *je;
+  String *out;
+  /* entries of the arrays and objects that are being written */
+  Dynamic_array<uint32> entries;
+  Dynamic_array<uint32> sorted;
+  uint depth= 0;
+public:
+  bool escaped_keys= false;
+
+  Json_binary_writer(json_engine_t *je_arg, String *out_arg)
+    : je(je_arg), out(out_arg), entries(PSI_INSTRUMENT_MEM, 64, 256),
+      sorted(PSI_INSTRUMENT_MEM, 16, 64)
+  {}
+
+  bool append_uint32(size_t n)
+  {
+    if (n > UINT_MAX32)
+      return true;
+    char buf[4];
+    int4store(buf, static_cast<uint32>(n));
+    return out->append(buf, 4);
+  }
+
+  void store_uint32(size_t pos, size_t n)
+  {
+    int4store(const_cast<char*>(out->ptr()) + pos, static_cast<uint32>(n));
+  }
+
+  bool write_value();
+  bool write_container();
+};
+
+
+bool Json_binary_writer::write_value()
+{
+  switch (je->value_type) {
+  case JSON_VALUE_OBJECT:
+  case JSON_VALUE_ARRAY:
+    return write_container();
+  case JSON_VALUE_STRING:
+  case JSON_VALUE_NUMBER:
+    return out->append(static_cast<char>(je->value_type)) ||
+           append_uint32(je->value_len) ||
+           out->append(reinterpret_cast<const char*>(je->value),
+                       je->value_len);
+  default:
+    return out->append(static_cast<char>(je->value_type));
+  }
+}
+
+
+bool Json_binary_writer::write_container()
+{
+  const size_t start= out->length(), first= entries.elements();
+  const bool object= je->value_type == JSON_VALUE_OBJECT;
+  const int end_state= object ? JST_OBJ_END : JST_ARRAY_END;
+
+  if (++depth > JSONB_MAX_DEPTH ||
+      out->append(static_cast<char>(je->value_type)) ||
+      out->fill(start + CONTAINER_HEADER, 0))
+    return true;
+
+  while (json_scan_next(je) == 0 && je->state != end_state)
+  {
+    if (object)
+    {
+      DBUG_ASSERT(je->state == JST_KEY);
+      const uchar *key= je->s.c_str, *key_end;
+      do
+      {
+        key_end= je->s.c_str;
+      } while (json_read_keyname_chr(je) == 0);
+      if (unlikely(je->s.error))
+        return true;
+      if (memchr(key, '\\', key_end - key))
+        escaped_keys= true;
+      if (entries.append(static_cast<uint32>(out->length() - start)) ||
+          entries.append(static_cast<uint32>(key_end - key)) ||
+          out->append(reinterpret_cast<const char*>(key), key_end - key))
+        return true;
+    }
+    DBUG_ASSERT(je->state == JST_VALUE);
+    if (entries.append(static_cast<uint32>(out->length() - start)) ||
+        json_read_value(je) || write_value())
+      return true;
+  }
+  if (unlikely(je->s.error))
+    return true;
+
+  const size_t n_entries= entries.elements() - first;
+  const size_t count= object ? n_entries / 3 : n_entries;
+  for (size_t i= first; i < entries.elements(); i++)
+    if (append_uint32(entries.at(i)))
+      return true;
+
+  if (object && count)
+  {
+    /* the first of equal keys is found, like json_find_path() does */
+    const char *obj= out->ptr() + start;
+    const uint32 *member= &entries.at(first);
+    sorted.clear();
+    for (uint32 i= 0; i < count; i++)
+      if (sorted.append(i))
+        return true;
+    std::sort(sorted.front(), sorted.front() + count,
+              [obj, member](uint32 a, uint32 b)
+              {
+                uint32 a_len= member[a*3 + 1], b_len= member[b*3 + 1];
+                if (a_len != b_len)
+                  return a_len < b_len;
+                if (int cmp= memcmp(obj + member[a*3], obj + member[b*3],
+                                    a_len))
+                  return cmp < 0;
+                return a < b;
+              });
+    for (size_t i= 0; i < count; i++)
+      if (append_uint32(sorted.at(i)))
+        return true;
+  }
+
+  if (out->length() - start > UINT_MAX32)
+    return true;
+  store_uint32(start + 1, count);
+  store_uint32(start + 5, out->length() - start);
+  entries.elements(first);
+  depth--;
+  return false;
+}
+
+
+bool json_binary_from_text(String *to, const char *js, size_t length,
+                           CHARSET_INFO *cs)
+{
+  MEM_ROOT root;
+  json_engine_t je;
+  bool res;
+
+  init_alloc_root(PSI_INSTRUMENT_MEM, &root, 1024, 0, MYF(MY_THREAD_SPECIFIC));
+  mem_root_dynamic_array_init(&root, PSI_INSTRUMENT_MEM, &je.stack,
+                              sizeof(int), NULL, JSON_DEPTH_DEFAULT,
+                              JSON_DEPTH_INC, MYF(0));
+  json_scan_start(&je, cs, reinterpret_cast<const uchar*>(js),
+                  reinterpret_cast<const uchar*>(js) + length);
+
+  Json_binary_writer writer(&je, to);
+  to->length(0);
+  res= to->append(static_cast<char>(JSONB_VERSION)) || json_read_value(&je) ||
+       writer.write_value();
+  if (!res)
+  {
+    /* there must be nothing after the value */
+    while (json_scan_next(&je) == 0) {}
+    res= je.s.error != 0;
+  }
+  if (!res && writer.escaped_keys)
+    const_cast<char*>(to->ptr())[0]|= JSONB_ESCAPED_KEYS;
+
+  free_root(&root, MYF(0));
+  return res;
+}
+
+
+/************* reading ****************************************************/
+
+bool json_binary_to_text(String *to, const uchar *image, size_t pos)
+{
+  const uchar *v= image + pos;
+  switch (*v) {
+  case JSON_VALUE_OBJECT:
+  case JSON_VALUE_ARRAY:
+  {
+    const bool object= *v == JSON_VALUE_OBJECT;
+    const uint32 count= jsonb_count(v);
+    const uchar *table= jsonb_table(v);
+    if (to->append(object ? '{' : '['))
+      return true;
+    for (uint32 i= 0; i < count; i++)
+    {
+      if (i && to->append(STRING_WITH_LEN(", ")))
+        return true;
+      uint32 value_offset;
+      if (object)
+      {
+        const uchar *member= table + i * MEMBER_ENTRY;
+        if (to->append('"') ||
+            to->append(reinterpret_cast<const char*>(v + uint4korr(member)),
+                       uint4korr(member + 4)) ||
+            to->append(STRING_WITH_LEN("\": ")))
+          return true;
+        value_offset= uint4korr(member + 8);
+      }
+      else
+        value_offset= uint4korr(table + i * ARRAY_ENTRY);
+      if (json_binary_to_text(to, v, value_offset))
+        return true;
+    }
+    return to->append(object ? '}' : ']');
+  }
+  case JSON_VALUE_STRING:
+    return to->append('"') ||
+           to->append(reinterpret_cast<const char*>(v + 5), uint4korr(v + 1)) ||
+           to->append('"');
+  case JSON_VALUE_NUMBER:
+    return to->append(reinterpret_cast<const char*>(v + 5), uint4korr(v + 1));
+  case JSON_VALUE_TRUE:
+    return to->append(STRING_WITH_LEN("true"));
+  case JSON_VALUE_FALSE:
+    return to->append(STRING_WITH_LEN("false"));
+  default:
+    DBUG_ASSERT(*v == JSON_VALUE_NULL);
+    return to->append(STRING_WITH_LEN("null"));
+  }
+}
+
+
+/* The member of the object with the key, or UINT_MAX32 */
+static uint32 jsonb_find_key(const uchar *obj, const uchar *key,
+                             uint32 key_length)
+{
+  const uint32 count= jsonb_count(obj);
+  const uchar *sorted= jsonb_table(obj) + count * MEMBER_ENTRY;
+  uint32 lo= 0, hi= count, n, length;
+  const uchar *k;
+
+  while (lo < hi)
+  {
+    uint32 mid= (lo + hi) / 2;
+    k= jsonb_key(obj, uint4korr(sorted + mid * SORTED_ENTRY), &length);
+    if (length < key_length ||
+        (length == key_length && memcmp(k, key, length) < 0))
+      lo= mid + 1;
+    else
+      hi= mid;
+  }
+  if (lo == count)
+    return UINT_MAX32;
+  n= uint4korr(sorted + lo * SORTED_ENTRY);
+  k= jsonb_key(obj, n, &length);
+  return length == key_length && !memcmp(k, key, length) ? n : UINT_MAX32;
+}
+
+
+/*
+  The keys in the image are utf8mb4 as they were written. A key of the path
+  can be compared with them byte by byte if it has no escapes either.
+*/
+static bool key_step_supported(const json_path_t *path,
+                               const json_path_step_t *step)
+{
+  bool ascii= true;
+  for (const uchar *c= step->key; c < step->key_end; c++)
+  {
+    if (*c == '\\')
+      return false;
+    if (*c >= 0x80)
+      ascii= false;
+  }
+  return ascii ? path->s.cs->mbminlen == 1
+               : my_charset_same(path->s.cs, &my_charset_utf8mb4_bin);
+}
+
+
+/*
+  Follows the path from the value at pos. The offsets of the arrays and
+  objects on the way are put in containers[], if it is not NULL.
+*/
+static jsonb_find_result jsonb_follow(const uchar *image, size_t length,
+                                      const json_path_t *path, int last_step,
+                                      size_t *pos, size_t *containers)
+{
+  if (length < 2 || (image[0] & JSONB_ESCAPED_KEYS) || path->mode_strict ||
+      last_step > JSONB_MAX_PATH)
+    return JSONB_UNSUPPORTED;
+  DBUG_ASSERT(image[0] == JSONB_VERSION);
+
+  const json_path_step_t *steps=
+    reinterpret_cast<const json_path_step_t*>(path->steps.buffer);
+  size_t cur= 1;
+  for (int i= 1; i <= last_step; i++)
+  {
+    const json_path_step_t *step= steps + i;
+    const uchar *v= image + cur;
+    uint32 n;
+
+    if (containers)
+      containers[i - 1]= cur;
+    if (step->type == JSON_PATH_KEY && *v == JSON_VALUE_OBJECT)
+    {
+      if (!key_step_supported(path, step))
+        return JSONB_UNSUPPORTED;
+      n= jsonb_find_key(v, step->key,
+                        static_cast<uint32>(step->key_end - step->key));
+      if (n == UINT_MAX32)
+        return JSONB_NOT_FOUND;
+      cur+= uint4korr(jsonb_table(v) + n * MEMBER_ENTRY + 8);
+    }
+    else if (step->type == JSON_PATH_ARRAY && *v == JSON_VALUE_ARRAY &&
+             step->n_item >= 0)
+    {
+      if (static_cast<uint32>(step->n_item) >= jsonb_count(v))
+        return JSONB_NOT_FOUND;
+      cur+= uint4korr(jsonb_table(v) + step->n_item * ARRAY_ENTRY);
+    }
+    else
+      return JSONB_UNSUPPORTED; // wildcards, ranges, lax autowrapping
+  }
+  *pos= cur;
+  return JSONB_FOUND;
+}
+
+
+jsonb_find_result json_binary_find(const uchar *image, size_t length,
+                                   const json_path_t *path, int last_step,
+                                   size_t *pos)
+{
+  return jsonb_follow(image, length, path, last_step, pos, NULL);
+}
+
+
+/************* partial update *********************************************/
+
+jsonb_find_result json_binary_replace(String *image, const json_path_t *path,
+                                      int last_step, const uchar *value,
+                                      size_t value_length)
+{
+  DBUG_ASSERT(value_length > 1);
+  size_t containers[JSONB_MAX_PATH], pos;
+  const uchar *img= reinterpret_cast<const uchar*>(image->ptr());
+  jsonb_find_result res= jsonb_follow(img, image->length(), path, last_step,
+                                      &pos, containers);
+  if (res != JSONB_FOUND)
+    return res;
+
+  const size_t old_length= jsonb_value_size(img + pos);
+  const longlong delta= static_cast<longlong>(value_length - 1) -
+                        static_cast<longlong>(old_length);
+  if (image->length() + delta > static_cast<longlong>(UINT_MAX32) ||
+      image->replace(static_cast<uint32>(pos), static_cast<uint32>(old_length),
+                     reinterpret_cast<const char*>(value + 1),
+                     static_cast<uint32>(value_length - 1)))
+    return JSONB_ERROR;
+
+  /*
+    Everything after the new value moved by delta: the tables of the
+    arrays and objects around it, and what they point to after it
+  */
+  uchar *buf= reinterpret_cast<uchar*>(const_cast<char*>(image->ptr()));
+  buf[0]|= value[0] & JSONB_ESCAPED_KEYS;
+  for (int i= last_step; i > 0; i--)
+  {
+    uchar *v= buf + containers[i - 1];
+    const uint32 child= static_cast<uint32>(pos - containers[i - 1]);
+    int4store(v + 5, static_cast<uint32>(jsonb_size(v) + delta));
+    uchar *table= const_cast<uchar*>(jsonb_table(v));
+    uchar *end= table + jsonb_count(v) * (*v == JSON_VALUE_OBJECT
+                                          ? MEMBER_ENTRY : ARRAY_ENTRY);
+    for (uchar *e= table; e < end; e+= 4)
+    {
+      /* all entries are offsets, but the key lengths */
+      uint32 offset= uint4korr(e);
+      if (offset > child && !(*v == JSON_VALUE_OBJECT &&
+                              (e - table) % MEMBER_ENTRY == 4))
+        int4store(e, static_cast<uint32>(offset + delta));
+    }
+  }
+  return JSONB_FOUND;
+}
@@ -0,0 +1,92 @@
+#ifndef JSON_BINARY_INCLUDED
+#define JSON_BINARY_INCLUDED
+/*
+   Copyright (c) 2026, MariaDB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+/*
+  Binary image of a JSON document, how JSONB columns store it.
+
+  The image is one byte of JSONB_VERSION (ORed with JSONB_ESCAPED_KEYS if
+  some key has a backslash in it) followed by the value of the document.
+  Every value starts with its json_value_types as one byte:
+
+    JSON_VALUE_TRUE, _FALSE, _NULL   nothing else
+
+    JSON_VALUE_NUMBER, _STRING       length (4 bytes) and the text as it is
+                                     in the JSON, strings without the quotes
+                                     and with the escapes
+
+    JSON_VALUE_ARRAY                 count (4), size (4), the elements,
+                                     then an offset (4) of every element
+
+    JSON_VALUE_OBJECT                count (4), size (4), the key and the
+                                     value of every member, then a key
+                                     offset (4), key length (4) and value
+                                     offset (4) of every member in the
+                                     order of the document, then the numbers
+                                     (4) of the members sorted by key length
+                                     and key
+
+  The size is of the whole value, with the type byte, and the offsets are
+  from the type byte. So an element of an array is found without looking
+  at the others, and a member of an object with a binary search.
+
+  Numbers are kept as text, so that the JSON functions return them as they
+  were written. Keys are compared as they are written too, and if some
+  key has escapes, the functions parse the text instead of using the image.
+*/
+
+#include "sql_string.h"
+#include <json_lib.h>
+
+static constexpr uchar JSONB_VERSION= 1;
+static constexpr uchar JSONB_ESCAPED_KEYS= 0x80;
+
+enum jsonb_find_result
+{
+  JSONB_FOUND,
+  JSONB_NOT_FOUND,
+  /* the path needs the rules of json_find_path(), parse the text */
+  JSONB_UNSUPPORTED,
+  /* out of memory */
+  JSONB_ERROR
+};
+
+/* Returns true if the text is not valid JSON or out of memory */
+bool json_binary_from_text(String *to, const char *js, size_t length,
+                           CHARSET_INFO *cs);
+
+/* Appends the value at image + pos to the text, formatted as JSON_EXTRACT() */
+bool json_binary_to_text(String *to, const uchar *image, size_t pos);
+
+/*
+  Looks for the value at the steps 1..last_step of the path. On JSONB_FOUND
+  *pos is the offset of the value in the image.
+*/
+jsonb_find_result json_binary_find(const uchar *image, size_t length,
+                                   const json_path_t *path, int last_step,
+                                   size_t *pos);
+
+/*
+  Replaces the value at the steps 1..last_step of the path with the value
+  of another image, in place. Only the offset tables of the arrays and
+  objects on the path are changed.
+*/
+jsonb_find_result json_binary_replace(String *image, const json_path_t *path,
+                                      int last_step, const uchar *value,
+                                      size_t value_length);
+
+#endif /* JSON_BINARY_INCLUDED */
@@ -37,6 +37,7 @@
 #include "log_event.h"          // Query_log_event
 #include "rpl_filter.h"
 #include "rpl_rli.h"
+#include "rpl_binlog_tail.h"
 #include "sql_audit.h"
 #include "mysqld.h"
 #include "ddl_log.h"
@@ -315,12 +316,14 @@ struct Binlog_background_job
       uint32 gtid_count;
       uint32 offset;
     } gtid_index_data;
+    char *gtid_index_rebuild_name;
   };
   Binlog_background_job *next;
   enum enum_job_type {
     CHECKPOINT_NOTIFY,
     GTID_INDEX_UPDATE,
     GTID_INDEX_CLOSE,
+    GTID_INDEX_REBUILD,
     SENTINEL
   } job_type;
 };
@@ -340,6 +343,7 @@ static int queue_binlog_background_gtid_index_update(Gtid_index_writer *gi,
                                                      rpl_gtid *gtid_list,
                                                      uint32 count);
 static int queue_binlog_background_gtid_index_close(Gtid_index_writer *gi);
+static int queue_binlog_background_gtid_index_rebuild(const char *log_name);
 static int queue_binlog_background_sentinel();
 static void binlog_background_wait_for_sentinel();
 
@@ -4727,6 +4731,10 @@ bool MYSQL_BIN_LOG::open(const char *log_name,
 #endif
     DBUG_RETURN(1);                            /* all warnings issued */
   }
+#ifdef HAVE_REPLICATION
+  if (!is_relay_log)
+    binlog_tail_cache.start_file(&log_file, log_file_name);
+#endif
 
   max_size= max_size_arg;
 
@@ -8393,6 +8401,30 @@ MYSQL_BIN_LOG::write_gtid_event(THD *thd, binlog_cache_data *cache_data,
   DBUG_ASSERT((gtid_event.flags2 & Gtid_log_event::FL_DDL) ||
               !is_in_ddl_recovery);
 
+  if (opt_binlog_dependency_tracking == BINLOG_DEPENDENCY_TRACKING_WRITESET)
+  {
+    /*
+      The writeset only covers the transaction if it is all row events in
+      the transactional cache.
+    */
+    binlog_cache_mngr *mngr= thd->binlog_get_cache_mngr();
+    const Rpl_writeset *writeset= NULL;
+    uint64 depends_on;
+    if (mngr && !standalone && mngr->using_trx_cache &&
+        mngr->trx_cache.has_only_row_events() &&
+        (!mngr->using_stmt_cache || mngr->stmt_cache.empty()) &&
+        (gtid_event.flags2 & Gtid_log_event::FL_TRANSACTIONAL) &&
+        !(gtid_event.flags2 & (Gtid_log_event::FL_PREPARED_XA |
+                               Gtid_log_event::FL_COMPLETED_XA)))
+      writeset= &mngr->trx_cache.writeset;
+    if (!rpl_writeset_history.get_dependency(writeset, domain_id, seq_no,
+                                             &depends_on))
+    {
+      gtid_event.flags_extra|= Gtid_log_event::FL_EXTRA_WRITESET;
+      gtid_event.writeset_seq_no= depends_on;
+    }
+  }
+
   if (opt_binlog_engine_hton)
   {
     DBUG_ASSERT(cache_data != nullptr);
@@ -11650,6 +11682,10 @@ void MYSQL_BIN_LOG::close(uint exiting)
 
     /* this will cleanup IO_CACHE, sync and close the file */
     MYSQL_LOG::close(exiting);
+#ifdef HAVE_REPLICATION
+    if (!is_relay_log)
+      binlog_tail_cache.end_file();
+#endif
   }
 
   /*
@@ -13453,6 +13489,11 @@ binlog_background_thread(void *arg __attribute__((unused)))
         delete queue->gtid_index_data.gi;
         break;
 
+      case Binlog_background_job::GTID_INDEX_REBUILD:
+        mysql_bin_log.rebuild_gtid_index(queue->gtid_index_rebuild_name);
+        my_free(queue->gtid_index_rebuild_name);
+        break;
+
       case Binlog_background_job::SENTINEL:
         /*
           The sentinel is a way to signal to reset_logs() that all pending
@@ -13651,6 +13692,34 @@ queue_binlog_background_gtid_index_close(Gtid_index_writer *gi)
 }
 
 
+static int
+queue_binlog_background_gtid_index_rebuild(const char *log_name)
+{
+  int res;
+  char *name;
+
+  if (!(name= my_strdup(PSI_INSTRUMENT_ME, log_name, MYF(MY_WME))))
+    return 1;
+  mysql_mutex_lock(&mysql_bin_log.LOCK_binlog_background_thread);
+  Binlog_background_job *job= get_binlog_background_job();
+  if (!job)
+  {
+    my_free(name);
+    res= 1;
+  }
+  else
+  {
+    job->job_type= Binlog_background_job::GTID_INDEX_REBUILD;
+    job->gtid_index_rebuild_name= name;
+    queue_binlog_background_job(job);
+    res= 0;
+  }
+  mysql_mutex_unlock(&mysql_bin_log.LOCK_binlog_background_thread);
+
+  return res;
+}
+
+
 static int
 queue_binlog_background_sentinel()
 {
@@ -14609,6 +14678,180 @@ MYSQL_BIN_LOG::recover_gtid_index_abort(Gtid_index_writer *gi)
 }
 
 
+/*
+  Ask for the GTID index of a binlog file to be rebuilt, after a lookup found
+  it missing or corrupt (eg. binlog files from before --binlog-gtid-index, or
+  an index left incomplete by a crash). The file is scanned in the binlog
+  background thread, so the lookup does not wait for it, and later lookups
+  in the file use the index instead of scanning it.
+
+   @param  log_name  Full name of the binlog file.
+
+   @return nothing
+*/
+void
+MYSQL_BIN_LOG::queue_gtid_index_rebuild(const char *log_name)
+{
+  /*
+    The index of the active binlog file is being written and is only missing
+    if writing it failed; it is not rebuilt while the file is still written.
+  */
+  if (!opt_binlog_gtid_index || !is_open() || is_active(log_name))
+    return;
+  queue_binlog_background_gtid_index_rebuild(log_name);
+}
+
+
+/*
+  Rebuild the GTID index of a binlog file that is no longer active, by
+  scanning the file. Runs in the binlog background thread.
+
+  Each GTID is added to the index with the offset of the end of its event
+  group, found like binlog recovery does, so the index is the same as the
+  one written with the binlog. An event group left incomplete at the end of
+  the file by a crash is not added.
+
+   @param  log_name  Full name of the binlog file.
+
+   @return nothing
+*/
+void
+MYSQL_BIN_LOG::rebuild_gtid_index(const char *log_name)
+{
+  Gtid_index_reader_hot reader;
+  Gtid_index_writer *gi= NULL;
+  Format_description_log_event *fdle;
+  Log_event *ev;
+  rpl_binlog_state_base state;
+  rpl_gtid gtid;
+  uint32 found_offset, found_count;
+  bool gtid_pending= false, gtid_standalone= false, gtid_no2pc= false;
+  const char *errmsg;
+  MY_STAT stat_info;
+  IO_CACHE log;
+  File file;
+  int error;
+
+  /* Several lookups may have asked for the same file. */
+  if (!reader.open_index_file(log_name))
+  {
+    int res= reader.search_offset(0, &found_offset, &found_count);
+    reader.close_index_file();
+    if (res >= 0)
+      return;
+  }
+
+  if (!(fdle= new Format_description_log_event(BINLOG_VERSION)))
+    return;
+  bzero((char*) &log, sizeof(log));
+  if ((file= open_binlog(&log, log_name, &errmsg)) < 0)
+  {
+    delete fdle;
+    return;
+  }
+  state.init();
+
+  for (;;)
+  {
+    if (!(ev= Log_event::read_log_event(&log, &error, fdle,
+                                        opt_master_verify_checksum)) ||
+        !ev->is_valid())
+      break;
+
+    Log_event_type typ= ev->get_type_code();
+    switch (typ)
+    {
+    case FORMAT_DESCRIPTION_EVENT:
+      delete fdle;
+      fdle= static_cast<Format_description_log_event *>(ev);
+      ev= NULL;
+      break;
+
+    case START_ENCRYPTION_EVENT:
+      error= fdle->start_decryption(static_cast<Start_encryption_log_event *>
+                                    (ev));
+      break;
+
+    case GTID_LIST_EVENT:
+      if (!gi)
+      {
+        Gtid_list_log_event *glev= static_cast<Gtid_list_log_event *>(ev);
+        if (!(error= state.load_nolock(glev->list, glev->count)))
+          gi= new Gtid_index_writer(log_name, (uint32)my_b_tell(&log), &state,
+                                    (uint32)opt_binlog_gtid_index_page_size,
+                                    (my_off_t)opt_binlog_gtid_index_span_min);
+      }
+      break;
+
+    case GTID_EVENT:
+    {
+      Gtid_log_event *gev= static_cast<Gtid_log_event *>(ev);
+      if (!gi)
+      {
+        /* No Gtid_list_log_event before the first GTID, not a valid binlog. */
+        error= 1;
+        break;
+      }
+      gtid.domain_id= gev->domain_id;
+      gtid.server_id= gev->server_id;
+      gtid.seq_no= gev->seq_no;
+      gtid_pending= true;
+      gtid_standalone= (gev->flags2 & Gtid_log_event::FL_STANDALONE) != 0;
+      gtid_no2pc= false;
+      break;
+    }
+
+    case QUERY_EVENT:
+    {
+      Query_log_event *qev= static_cast<Query_log_event *>(ev);
+      if (qev->is_commit() || qev->is_rollback())
+        gtid_no2pc= true;
+      break;
+    }
+
+    case XA_PREPARE_LOG_EVENT:
+      gtid_no2pc= true;
+      break;
+
+    default:
+      break;
+    }
+    /* The same test for the end of the event group as in binlog recovery. */
+    if (gtid_pending &&
+        ((gtid_standalone && !Log_event::is_part_of_group(typ)) ||
+         (!gtid_standalone && (typ == XID_EVENT || gtid_no2pc))))
+    {
+      gi->process_gtid((uint32)my_b_tell(&log), &gtid);
+      gtid_pending= false;
+    }
+    delete ev;
+    ev= NULL;
+    if (error)
+      break;
+  }
+  delete ev;
+
+  if (error || log.error)
+    recover_gtid_index_abort(gi);
+  else
+    recover_gtid_index_end(gi);
+  end_io_cache(&log);
+  mysql_file_close(file, MYF(MY_WME));
+  delete fdle;
+
+  /*
+    A PURGE BINARY LOGS of the file while it was scanned deleted its index
+    before the new one was written; do not leave that one behind.
+  */
+  if (gi && !error && !my_stat(log_name, &stat_info, MYF(0)))
+  {
+    char buf[Gtid_index_base::GTID_INDEX_FILENAME_MAX_SIZE];
+    Gtid_index_base::make_gtid_index_file_name(buf, sizeof(buf), log_name);
+    my_delete(buf, MYF(0));
+  }
+}
+
+
 int
 MYSQL_BIN_LOG::do_binlog_recovery(const char *opt_name, bool do_xa_recovery)
 {
@@ -1091,6 +1091,8 @@ class MYSQL_BIN_LOG: public TC_LOG, public Event_log
   void make_log_name(char* buf, const char* log_ident);
   bool is_active(const char* log_file_name);
   bool can_purge_log(const char *log_file_name, bool interactive);
+  void queue_gtid_index_rebuild(const char *log_name);
+  void rebuild_gtid_index(const char *log_name);
   int update_log_index(LOG_INFO* linfo, bool need_update_threads);
   int rotate(bool force_rotate, bool *check_purge,
              bool commit_by_rotate= false);
@@ -17,6 +17,7 @@
 */
 
 #include "log_event.h"
+#include "rpl_writeset.h"
 
 static constexpr my_off_t MY_OFF_T_UNDEF= ~0ULL;
 /** Truncate cache log files bigger than this */
@@ -92,6 +93,15 @@ class binlog_cache_data
              ((status & (LOGGED_ROW_EVENT | LOGGED_CRITICAL)) == 0)));
   }
 
+  /*
+    Return 1 if the cache only contains row events (and their table maps),
+    so that the writeset covers all changes in it.
+  */
+  bool has_only_row_events() const
+  {
+    return (status & (LOGGED_ROW_EVENT | LOGGED_CRITICAL)) == LOGGED_ROW_EVENT;
+  }
+
   Rows_log_event *pending() const
   {
     return m_pending;
@@ -135,6 +145,7 @@ class binlog_cache_data
     status= 0;
     incident= FALSE;
     before_stmt_pos= MY_OFF_T_UNDEF;
+    writeset.reset();
     DBUG_ASSERT(empty());
   }
 
@@ -169,6 +180,7 @@ class binlog_cache_data
     status= 0;
     incident= FALSE;
     before_stmt_pos= MY_OFF_T_UNDEF;
+    writeset.reset();
     DBUG_ASSERT(empty());
   }
 
@@ -327,6 +339,8 @@ class binlog_cache_data
   IO_CACHE cache_log;
   /* Context for engine-implemented binlogging. */
   handler_binlog_event_group_info engine_binlog_info;
+  /* Unique key hashes of the rows changed, for writeset dependencies. */
+  Rpl_writeset writeset;
 
 protected:
   /*
@@ -55,6 +55,9 @@
 #include "rpl_constants.h"
 #include "sql_digest.h"
 #include "zlib.h"
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 #include "myisampack.h"
 #include <algorithm>
 
@@ -273,8 +276,8 @@ char *str_to_hex(char *to, const uchar *from, size_t len)
   Compressed Record
     Record Header: 1 Byte
              7 Bit: Always 1, mean compressed;
-           4-6 Bit: Compressed algorithm - Always 0, means zlib
-                    It maybe support other compression algorithm in the future.
+           4-6 Bit: Compressed algorithm - 0 means zlib, 1 means zstd,
+                    see enum_binlog_compress_alg
            0-3 Bit: Bytes of "Record Original Length"
     Record Original Length: 1-4 Bytes
     Compressed Buf:
@@ -286,9 +289,13 @@ char *str_to_hex(char *to, const uchar *from, size_t len)
 
 uint32 binlog_get_compress_len(uint32 len)
 {
+    size_t bound= compressBound(len);
+#ifdef HAVE_ZSTD
+    bound= MY_MAX(bound, ZSTD_COMPRESSBOUND(len));
+#endif
     /* 5 for the begin content, 1 reserved for a '\0'*/
     return ALIGN_SIZE((BINLOG_COMPRESSED_HEADER_LEN + BINLOG_COMPRESSED_ORIGINAL_LENGTH_MAX_BYTES) 
-                        + compressBound(len) + 1);
+                        + (uint32) bound + 1);
 }
 
 /**
@@ -299,10 +306,13 @@ uint32 binlog_get_compress_len(uint32 len)
       the content uncompressed.
          2) The 'comlen' should stored the length of 'dst', and it will
       be set as the size of compressed content after return.
+         3) 'alg' is one of enum_binlog_compress_alg. Without zstd support
+      in the build, zlib is used instead.
 
    return zero if successful, others otherwise.
 */
-int binlog_buf_compress(const uchar *src, uchar *dst, uint32 len, uint32 *comlen)
+int binlog_buf_compress(const uchar *src, uchar *dst, uint32 len, uint32 *comlen,
+                        uint alg)
 {
   uchar lenlen;
   if (len & 0xFF000000)
@@ -331,6 +341,20 @@ int binlog_buf_compress(const uchar *src, uchar *dst, uint32 len, uint32 *comlen
     dst[1]= uchar(len);
     lenlen= 1;
   }
+
+#ifdef HAVE_ZSTD
+  if (alg == BINLOG_COMPRESS_ZSTD)
+  {
+    dst[0]= 0x80 | (BINLOG_COMPRESS_ZSTD << 4) | (lenlen & 0x07);
+    size_t res= ZSTD_compress(dst + BINLOG_COMPRESSED_HEADER_LEN + lenlen,
+                              *comlen - BINLOG_COMPRESSED_HEADER_LEN - lenlen - 1,
+                              src, len, ZSTD_CLEVEL_DEFAULT);
+    if (ZSTD_isError(res))
+      return 1;
+    *comlen= (uint32)res + BINLOG_COMPRESSED_HEADER_LEN + lenlen;
+    return 0;
+  }
+#endif
   dst[0]= 0x80 | (lenlen & 0x07);
 
   uLongf tmplen= (uLongf)*comlen - BINLOG_COMPRESSED_HEADER_LEN - lenlen - 1;
@@ -618,6 +642,16 @@ int binlog_buf_uncompress(const uchar *src, uchar *dst, uint32 len,
       (const Bytef*)src + 1 + lenlen, len - 1 - lenlen) != Z_OK)
       return 1;
     break;
+#ifdef HAVE_ZSTD
+  case BINLOG_COMPRESS_ZSTD:
+  {
+    size_t res= ZSTD_decompress(dst, buflen, src + 1 + lenlen,
+                                len - 1 - lenlen);
+    if (ZSTD_isError(res) || res != buflen)
+      return 1;
+    break;
+  }
+#endif
   default:
     //TODO
     //bad algorithm
@@ -2591,7 +2625,7 @@ Gtid_log_event::Gtid_log_event(const uchar *buf, uint event_len,
                                const Format_description_log_event
                                *description_event)
   : Log_event(buf, description_event), seq_no(0), commit_id(0),
-    flags_extra(0), extra_engines(0), thread_id(0)
+    flags_extra(0), extra_engines(0), thread_id(0), writeset_seq_no(0)
 {
   uint8 header_size= description_event->common_header_len;
   uint8 post_header_len= description_event->post_header_len[GTID_EVENT-1];
@@ -2678,6 +2712,17 @@ Gtid_log_event::Gtid_log_event(const uchar *buf, uint event_len,
       thread_id= uint4korr(buf);
       buf+= 4;
     }
+
+    if (flags_extra & FL_EXTRA_WRITESET)
+    {
+      if (event_len < static_cast<uint>(buf - buf_0) + 8)
+      {
+        seq_no= 0;
+        return;
+      }
+      writeset_seq_no= uint8korr(buf);
+      buf+= 8;
+    }
   }
   /*
     the strict '<' part of the assert corresponds to extra zero-padded
@@ -3231,7 +3276,8 @@ Rows_log_event::Rows_log_event(const uchar *buf, size_t event_len,
 #if !defined(MYSQL_CLIENT) && defined(HAVE_REPLICATION)
     , m_curr_row(NULL), m_curr_row_end(NULL),
     m_key(NULL), m_key_info(NULL), m_key_nr(0),
-    m_usable_key_parts(0), master_had_triggers(0)
+    m_usable_key_parts(0), m_hash_scan(NULL), m_prefetch(NULL),
+    master_had_triggers(0)
 #endif
 {
   DBUG_ENTER("Rows_log_event::Rows_log_event(const char*,...)");
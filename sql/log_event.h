@@ -3378,14 +3378,16 @@ cap_gtid_event_size(uint32_t proposed_size)
 static constexpr uint32_t
 get_gtid_event_size(bool fl_commit_id, bool fl_xa, bool fl_extra,
                     bool fl_multi_engine, bool fl_alter,
-                    bool fl_thread_id, int bq_size, int gt_size)
+                    bool fl_thread_id, bool fl_writeset,
+                    int bq_size, int gt_size)
 {
   return cap_gtid_event_size((fl_commit_id ? GTID_HEADER_LEN + 2 : 13) +
                              (fl_xa ? 6 + bq_size + gt_size : 0) +
                              (fl_extra ? 1 : 0) +
                              (fl_multi_engine ? 1 : 0) +
                              (fl_alter ? 8 : 0) +
-                             (fl_thread_id ? 4 : 0));
+                             (fl_thread_id ? 4 : 0) +
+                             (fl_writeset ? 8 : 0));
 }
 #endif
 
@@ -3487,6 +3489,11 @@ class Gtid_log_event: public Log_event
   */
   uint8 extra_engines;
   my_thread_id thread_id;
+  /*
+    With FL_EXTRA_WRITESET, the seq_no of the last earlier transaction in the
+    domain that this one changes rows in common with.
+  */
+  uint64 writeset_seq_no;
 
   /* Flags2. */
 
@@ -3533,6 +3540,11 @@ class Gtid_log_event: public Log_event
   static constexpr uchar FL_COMMIT_ALTER_E1= 4;
   static constexpr uchar FL_ROLLBACK_ALTER_E1= 8;
   static constexpr uchar FL_EXTRA_THREAD_ID= 16; // thread_id like in BEGIN Query
+  /*
+    FL_EXTRA_WRITESET is set when writeset_seq_no is known. The transaction
+    can then be applied in parallel with all transactions after that one.
+  */
+  static constexpr uchar FL_EXTRA_WRITESET= 32;
 
 #ifdef MYSQL_SERVER
   static constexpr uint32_t max_size=
@@ -3540,7 +3552,8 @@ class Gtid_log_event: public Log_event
                         (bool)(FL_PREPARED_XA|FL_COMPLETED_XA),
                         true, FL_EXTRA_MULTI_ENGINE_E1,
                         (bool)(FL_COMMIT_ALTER_E1|FL_ROLLBACK_ALTER_E1),
-                        FL_EXTRA_THREAD_ID, MAXBQUALSIZE, MAXGTRIDSIZE);
+                        FL_EXTRA_THREAD_ID, FL_EXTRA_WRITESET,
+                        MAXBQUALSIZE, MAXGTRIDSIZE);
 
   Gtid_log_event(THD *thd_arg, uint64 seq_no, uint32 domain_id, bool standalone,
                  enum_event_cache_type cache_type_arg, uint16 flags,
@@ -5037,6 +5050,10 @@ class Rows_log_event : public Log_event
   KEY      *m_key_info; /* Pointer to KEY info for m_key_nr */
   uint      m_key_nr;   /* Key number */
   uint      m_usable_key_parts; /* A number of key_parts suited to lookup */
+  /* Positions of the rows found by hash_scan_rows(), or NULL */
+  class Rows_hash_scan *m_hash_scan;
+  /* Keys of the rows being read ahead by prefetch_rows(), or NULL */
+  class Rows_prefetch_batch *m_prefetch;
   bool master_had_triggers;     /* set after tables opening */
 
   /*
@@ -5088,6 +5105,8 @@ class Rows_log_event : public Log_event
   uint find_key_parts(const KEY *key) const;
   bool use_pk_position() const;
   int find_row(rpl_group_info *);
+  void hash_scan_rows(const rpl_group_info *, MY_BITMAP const *cols_ai);
+  void prefetch_rows(const rpl_group_info *, MY_BITMAP const *cols_ai);
   int update_sequence();
 
   // Unpack the current row into m_table->record[0], but with
@@ -6213,8 +6232,15 @@ enum Log_event_type wsrep_peak_event(rpl_group_info *rgi, ulonglong* event_size)
 */
 
 
+/* Algorithm in the header of a compressed record */
+enum enum_binlog_compress_alg
+{
+  BINLOG_COMPRESS_ZLIB= 0,
+  BINLOG_COMPRESS_ZSTD= 1
+};
+
 int binlog_buf_compress(const uchar *src, uchar *dst, uint32 len,
-                        uint32 *comlen);
+                        uint32 *comlen, uint alg);
 int binlog_buf_uncompress(const uchar *src, uchar *dst, uint32 len,
                           uint32 *newlen);
 uint32 binlog_get_compress_len(uint32 len);
@@ -3990,6 +3990,12 @@ Gtid_log_event::print(FILE *file, PRINT_EVENT_INFO *print_event_info)
     if (flags_extra & FL_ROLLBACK_ALTER_E1)
       if (my_b_printf(&cache, " ROLLBACK ALTER id= %lu", sa_seq_no))
         goto err;
+    if (flags_extra & FL_EXTRA_WRITESET)
+    {
+      longlong10_to_str(writeset_seq_no, buf2, 10);
+      if (my_b_printf(&cache, " writeset_seq_no=%s", buf2))
+        goto err;
+    }
     if (flags_extra & FL_EXTRA_THREAD_ID)
     {
       longlong10_to_str(thread_id, buf2, 10);
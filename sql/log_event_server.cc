@@ -44,6 +44,7 @@
 #include "rpl_mi.h"
 #include "rpl_filter.h"
 #include "rpl_record.h"
+#include "rpl_rows_prefetch.h"
 #include "transaction.h"
 #include <my_dir.h>
 #include "sql_show.h"    // append_identifier
@@ -1296,7 +1297,8 @@ bool Query_compressed_log_event::write(Log_event_writer *writer)
   compressed_size= alloc_size= binlog_get_compress_len(q_len);
   buffer= (uchar*) my_safe_alloca(alloc_size);
   if (buffer &&
-      !binlog_buf_compress((uchar*) query, buffer, q_len, &compressed_size))
+      !binlog_buf_compress((uchar*) query, buffer, q_len, &compressed_size,
+                           (uint) opt_bin_log_compress_alg))
   {
     /*
       Write the compressed event. We have to temporarily store the event
@@ -2917,7 +2919,7 @@ Gtid_log_event::Gtid_log_event(THD *thd_arg, uint64 seq_no_arg,
     pad_to_size(0), flags2((standalone ? FL_STANDALONE : 0) |
            (commit_id_arg ? FL_GROUP_COMMIT_ID : 0)),
     flags_extra(0), extra_engines(0),
-    thread_id(thd_arg->variables.pseudo_thread_id)
+    thread_id(thd_arg->variables.pseudo_thread_id), writeset_seq_no(0)
 {
   cache_type= cache_type_arg;
   bool is_tmp_table= thd_arg->lex->stmt_accessed_temp_table();
@@ -3057,6 +3059,7 @@ Gtid_log_event::get_size() const noexcept
                              flags_extra & FL_EXTRA_MULTI_ENGINE_E1,
                              flags_extra & (FL_COMMIT_ALTER_E1 | FL_ROLLBACK_ALTER_E1),
                              flags_extra & FL_EXTRA_THREAD_ID,
+                             flags_extra & FL_EXTRA_WRITESET,
                              (fl_xa ? xid.bqual_length : 0),
                              (fl_xa ? xid.gtrid_length : 0));
 }
@@ -3140,6 +3143,12 @@ Gtid_log_event::write(Log_event_writer *writer)
     write_len+= 4;
   }
 
+  if (flags_extra & FL_EXTRA_WRITESET)
+  {
+    int8store(buf + write_len, writeset_seq_no);
+    write_len+= 8;
+  }
+
   if (write_len < GTID_HEADER_LEN)
   {
     bzero(buf+write_len, GTID_HEADER_LEN-write_len);
@@ -4784,8 +4793,8 @@ Rows_log_event::Rows_log_event(THD *thd_arg, TABLE *tbl_arg,
     m_type(event_type), m_extra_row_data(0)
 #ifdef HAVE_REPLICATION
     , m_curr_row(NULL), m_curr_row_end(NULL),
-    m_key(NULL), m_key_info(NULL), m_key_nr(0),
-    master_had_triggers(0)
+    m_key(NULL), m_key_info(NULL), m_key_nr(0), m_hash_scan(NULL),
+    m_prefetch(NULL), master_had_triggers(0)
 #endif
 {
   /*
@@ -6363,7 +6372,8 @@ bool Rows_log_event::write_compressed(Log_event_writer *writer)
   m_rows_buf= (uchar*) my_safe_alloca(alloc_size);
   if(m_rows_buf &&
      !binlog_buf_compress(m_rows_buf_tmp, m_rows_buf,
-                          (uint32)(m_rows_cur_tmp - m_rows_buf_tmp), &comlen))
+                          (uint32)(m_rows_cur_tmp - m_rows_buf_tmp), &comlen,
+                          (uint) opt_bin_log_compress_alg))
   {
     m_rows_cur= comlen + m_rows_buf;
     ret= Log_event::write(writer);
@@ -8254,6 +8264,326 @@ static int end_of_file_error(rpl_group_info *rgi)
          ? HA_ERR_END_OF_FILE : HA_ERR_RECORD_CHANGED;
 }
 
+/**
+  Positions of the rows of a DELETE or UPDATE rows event in a table
+  without a usable key.
+
+  Without a key find_row() has to scan the whole table for every row of
+  the event. Instead, Rows_log_event::hash_scan_rows() unpacks all before
+  images once, hashes them on the values compared by record_compare(), and
+  matches every row of a single table scan against this hash. The position
+  of the table row is stored with the before image it is equal to, and
+  find_row() reads the row with rnd_pos(). The row read is compared with
+  the before image again, so a row that is not found this way is still
+  looked for with a table scan.
+
+  Both the before images and the table rows are hashed and compared on the
+  fields that the before images have, which are the same for all rows of
+  the event. They are kept in before_cols, as unpacking an after image
+  marks more fields in TABLE::has_value_set.
+*/
+
+class Rows_hash_scan
+{
+public:
+  struct Row
+  {
+    const uchar *image;         /* Start of the before image in the event */
+    uchar *record;              /* Before image unpacked as a record */
+    uchar *ref;                 /* Position of the table row, or NULL */
+    Row *next;                  /* Next row of the event */
+    Row *next_in_bucket;
+    ulong hash;
+  };
+
+  MEM_ROOT mem_root;
+  Row *first, **last_next;
+  Row *cursor;                  /* Row to be looked for by find_row() */
+  Row **buckets;
+  ulong bucket_mask;
+  uint rows;
+  MY_BITMAP before_cols;        /* Fields that the before images have */
+
+  Rows_hash_scan()
+    :first(NULL), last_next(&first), cursor(NULL), buckets(NULL),
+     bucket_mask(0), rows(0)
+  {
+    init_sql_alloc(PSI_INSTRUMENT_ME, &mem_root, 8192, 0,
+                   MYF(MY_THREAD_SPECIFIC));
+  }
+  ~Rows_hash_scan() { free_root(&mem_root, MYF(0)); }
+
+  /*
+    Hash the fields of record[0] that record_compare() compares. Fields
+    that are not read are skipped, as their value in a row read from the
+    table is undefined.
+  */
+  static ulong hash_record(TABLE *table)
+  {
+    Hasher hasher;
+    bool all_values_set= bitmap_is_set_all(&table->has_value_set);
+    for (Field **ptr= table->field; *ptr; ptr++)
+    {
+      Field *f= *ptr;
+      if (f->vcol_info || !bitmap_is_set(table->read_set, f->field_index) ||
+          (!all_values_set && !f->has_explicit_value()))
+        continue;
+      f->hash(&hasher);
+    }
+    return (ulong) hasher.finalize();
+  }
+
+  /*
+    Add the before image unpacked in record[0]. TABLE::has_value_set must
+    have only the fields of the before image.
+  */
+  bool add(TABLE *table, const uchar *image)
+  {
+    Row *row;
+    if (!rows)
+    {
+      my_bitmap_map *buf= (my_bitmap_map*)
+        alloc_root(&mem_root, bitmap_buffer_size(table->s->fields));
+      if (!buf || my_bitmap_init(&before_cols, buf, table->s->fields))
+        return true;
+      bitmap_copy(&before_cols, &table->has_value_set);
+    }
+    if (!(row= (Row*) alloc_root(&mem_root, sizeof(Row))) ||
+        !(row->record= (uchar*) memdup_root(&mem_root, table->record[0],
+                                            table->s->reclength)))
+      return true;
+    row->image= image;
+    row->ref= NULL;
+    row->hash= hash_record(table);
+    row->next= NULL;
+    *last_next= row;
+    last_next= &row->next;
+    rows++;
+    return false;
+  }
+
+  bool build_hash()
+  {
+    ulong size= 1;
+    while (size < rows * 2)
+      size<<= 1;
+    if (!(buckets= (Row**) alloc_root(&mem_root, size * sizeof(Row*))))
+      return true;
+    bzero(buckets, size * sizeof(Row*));
+    bucket_mask= size - 1;
+    /* Add in reverse order, so that equal rows are matched in event order */
+    Row **order= (Row**) alloc_root(&mem_root, rows * sizeof(Row*));
+    if (!order)
+      return true;
+    uint i= 0;
+    for (Row *row= first; row; row= row->next)
+      order[i++]= row;
+    while (i-- > 0)
+    {
+      Row **bucket= buckets + (order[i]->hash & bucket_mask);
+      order[i]->next_in_bucket= *bucket;
+      *bucket= order[i];
+    }
+    cursor= first;
+    return false;
+  }
+
+  /*
+    Find the first before image without a position that is equal to the
+    table row in record[0], and give it the current position of the handler
+  */
+  bool match(TABLE *table)
+  {
+    ulong hash= hash_record(table);
+    for (Row *row= buckets[hash & bucket_mask]; row; row= row->next_in_bucket)
+    {
+      if (row->ref || row->hash != hash)
+        continue;
+      memcpy(table->record[1], row->record, table->s->reclength);
+      if (record_compare(table))
+        continue;
+      table->file->position(table->record[0]);
+      return !(row->ref= (uchar*) memdup_root(&mem_root, table->file->ref,
+                                              table->file->ref_length));
+    }
+    return false;
+  }
+
+  /* Position of the table row found for the before image at @c image */
+  const uchar *position(const uchar *image)
+  {
+    while (cursor && cursor->image < image)
+      cursor= cursor->next;
+    if (!cursor || cursor->image != image)
+      return NULL;
+    return cursor->ref;
+  }
+};
+
+
+/**
+  Find the rows of a DELETE or UPDATE event with a single table scan, see
+  Rows_log_event.
+
+  Used when the table has no key that find_row() can use and the event
+  has more than one row. If anything fails, m_hash_scan is left NULL and
+  every row is looked for with its own table scan, as before.
+
+  @param cols_ai  Columns of the after image for UPDATE, NULL for DELETE
+*/
+
+void Rows_log_event::hash_scan_rows(const rpl_group_info *rgi,
+                                    MY_BITMAP const *cols_ai)
+{
+  TABLE *table= m_table;
+  RPL_TABLE_LIST *tl= (RPL_TABLE_LIST*) table->pos_in_table_list;
+  const uchar *saved_row= m_curr_row, *saved_row_end= m_curr_row_end;
+  Rows_hash_scan *hash_scan;
+  int error= 0;
+  DBUG_ENTER("Rows_log_event::hash_scan_rows");
+  DBUG_ASSERT(!m_hash_scan);
+
+  /*
+    Versioned tables compare a row by a value that depends on each row,
+    see find_row(). Converted blob values are not kept in the event, so
+    the unpacked record cannot be kept either.
+  */
+  if (m_key_info || table->versioned() || tl->m_online_alter_copy_fields ||
+      (tl->m_conv_table && table->s->blob_fields) ||
+      DBUG_IF("rpl_disable_hash_scan"))
+    DBUG_VOID_RETURN;
+
+  if (!(hash_scan= new Rows_hash_scan()))
+    DBUG_VOID_RETURN;
+
+  thd_proc_info(thd, "Rows_log_event::hash_scan_rows()");
+  {
+    Check_level_instant_set clis(thd, CHECK_FIELD_IGNORE);
+    for (m_curr_row= m_rows_buf; m_curr_row < m_rows_end; )
+    {
+      const uchar *image= m_curr_row;
+      table->reset_default_fields();
+      restore_record(table, s->default_values);
+      if ((error= unpack_row(rgi, table, m_width, m_curr_row, &m_cols,
+                             &m_curr_row_end, m_rows_end)))
+        break;
+      normalize_null_bits(table);
+      if ((error= hash_scan->add(table, image)))
+        break;
+      m_curr_row= m_curr_row_end;
+      if (cols_ai)
+      {
+        if ((error= unpack_row(rgi, table, m_width, m_curr_row, cols_ai,
+                               &m_curr_row_end, m_rows_end)))
+          break;
+        m_curr_row= m_curr_row_end;
+      }
+    }
+  }
+  m_curr_row= saved_row;
+  m_curr_row_end= saved_row_end;
+
+  if (error || hash_scan->rows < 2 || hash_scan->build_hash() ||
+      table->file->ha_rnd_init_with_error(1))
+    goto err;
+
+  bitmap_copy(&table->has_value_set, &hash_scan->before_cols);
+  while (!(error= table->file->ha_rnd_next(table->record[0])))
+  {
+    if (hash_scan->match(table))
+      break;
+  }
+  table->file->ha_rnd_end();
+  if (error != HA_ERR_END_OF_FILE)
+    goto err;
+
+  table->reset_default_fields();
+  m_hash_scan= hash_scan;
+  statistic_increment(slave_rows_hash_scans, LOCK_status);
+  DBUG_PRINT("info", ("%u rows located with a hash scan", hash_scan->rows));
+  DBUG_VOID_RETURN;
+
+err:
+  table->reset_default_fields();
+  delete hash_scan;
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Queue the keys of the rows of a DELETE or UPDATE event for the prefetch
+  threads, see rpl_rows_prefetch.h.
+
+  Only done for events with enough rows, that find_row() looks up with a
+  unique key of an InnoDB table. If anything fails, the rows are just not
+  read ahead.
+
+  @param cols_ai  Columns of the after image for UPDATE, NULL for DELETE
+*/
+
+void Rows_log_event::prefetch_rows(const rpl_group_info *rgi,
+                                   MY_BITMAP const *cols_ai)
+{
+  TABLE *table= m_table;
+  RPL_TABLE_LIST *tl= (RPL_TABLE_LIST*) table->pos_in_table_list;
+  const uchar *saved_row= m_curr_row, *saved_row_end= m_curr_row_end;
+  Rows_prefetch_batch *batch;
+  int error= 0;
+  DBUG_ENTER("Rows_log_event::prefetch_rows");
+  DBUG_ASSERT(!m_prefetch);
+
+  if (!opt_slave_rows_prefetch_threads || !m_key_info ||
+      (m_key_info->flags & (HA_NOSAME | HA_NULL_PART_KEY)) != HA_NOSAME ||
+      m_usable_key_parts != m_key_info->user_defined_key_parts ||
+      table->file->partition_ht()->db_type != DB_TYPE_INNODB ||
+      table->s->tmp_table != NO_TMP_TABLE || table->versioned() ||
+      tl->m_online_alter_copy_fields || tl->m_conv_table)
+    DBUG_VOID_RETURN;
+
+  if (!(batch= new Rows_prefetch_batch(table, m_key_nr,
+                                       (uint) opt_slave_rows_prefetch_threads)))
+    DBUG_VOID_RETURN;
+  if (batch->init())
+    goto err;
+
+  {
+    Check_level_instant_set clis(thd, CHECK_FIELD_IGNORE);
+    for (m_curr_row= m_rows_buf; m_curr_row < m_rows_end; )
+    {
+      restore_record(table, s->default_values);
+      if ((error= unpack_row(rgi, table, m_width, m_curr_row, &m_cols,
+                             &m_curr_row_end, m_rows_end)))
+        break;
+      key_copy(m_key, table->record[0], m_key_info, 0);
+      if ((error= batch->add(m_key)))
+        break;
+      m_curr_row= m_curr_row_end;
+      if (cols_ai)
+      {
+        if ((error= unpack_row(rgi, table, m_width, m_curr_row, cols_ai,
+                               &m_curr_row_end, m_rows_end)))
+          break;
+        m_curr_row= m_curr_row_end;
+      }
+    }
+  }
+  m_curr_row= saved_row;
+  m_curr_row_end= saved_row_end;
+
+  if (error || batch->rows < ROWS_PREFETCH_MIN_ROWS ||
+      rpl_rows_prefetch.submit(batch))
+    goto err;
+
+  m_prefetch= batch;
+  DBUG_PRINT("info", ("%lu rows queued for prefetch", batch->rows));
+  DBUG_VOID_RETURN;
+
+err:
+  batch->unref();
+  DBUG_VOID_RETURN;
+}
+
+
 /**
   Locate the current row in event's table.
 
@@ -8304,6 +8634,11 @@ int Rows_log_event::find_row(rpl_group_info *rgi)
     Todo: fix wl3228 hld that requires defauls for all types of events
   */
   
+  /*
+    The after image of the previous row may have marked fields that the
+    before image does not have. record_compare() must not compare them.
+  */
+  table->reset_default_fields();
   restore_record(table, s->default_values);
   error= unpack_current_row(rgi);
 
@@ -8502,6 +8837,26 @@ int Rows_log_event::find_row(rpl_group_info *rgi)
   }
   else
   {
+    if (m_hash_scan)
+    {
+      if (const uchar *ref= m_hash_scan->position(m_curr_row))
+      {
+        DBUG_PRINT("info",("locating record using hash scan (rnd_pos)"));
+        if (unlikely((error= table->file->ha_rnd_init_with_error(0))))
+          goto end;
+        if (!(error= table->file->ha_rnd_pos(table->record[0],
+                                             (uchar*) ref)) &&
+            !record_compare(table, m_vers_from_plain))
+        {
+          is_table_scan= true;
+          goto end;
+        }
+        /* The row has changed since the hash scan, use a table scan */
+        table->file->ha_rnd_end();
+        error= 0;
+      }
+    }
+
     DBUG_PRINT("info",("locating record using table scan (rnd_next)"));
     /* We use this to test that the correct key is used in test cases. */
     DBUG_EXECUTE_IF("slave_crash_if_table_scan", abort(););
@@ -8602,7 +8957,13 @@ Delete_rows_log_event::do_before_row_operations(const rpl_group_info *rgi,
   if (do_invoke_trigger())
     m_table->prepare_triggers_for_delete_stmt_or_event();
 
-  return find_key(rgi);
+  int err;
+  if ((err= find_key(rgi)))
+    return err;
+
+  hash_scan_rows(rgi, NULL);
+  prefetch_rows(rgi, NULL);
+  return 0;
 }
 
 int 
@@ -8612,6 +8973,10 @@ Delete_rows_log_event::do_after_row_operations(int error)
   my_free(m_key);
   m_key= NULL;
   m_key_info= NULL;
+  delete m_hash_scan;
+  m_hash_scan= NULL;
+  rpl_rows_prefetch.release(m_prefetch);
+  m_prefetch= NULL;
 
   return error;
 }
@@ -8726,6 +9091,9 @@ Update_rows_log_event::do_before_row_operations(const rpl_group_info *rgi,
   if ((err= find_key(rgi)))
     return err;
 
+  hash_scan_rows(rgi, &m_cols_ai);
+  prefetch_rows(rgi, &m_cols_ai);
+
   if (do_invoke_trigger())
     m_table->prepare_triggers_for_update_stmt_or_event();
 
@@ -8740,6 +9108,10 @@ Update_rows_log_event::do_after_row_operations(int error)
   my_free(m_key); // Free for multi_malloc
   m_key= NULL;
   m_key_info= NULL;
+  delete m_hash_scan;
+  m_hash_scan= NULL;
+  rpl_rows_prefetch.release(m_prefetch);
+  m_prefetch= NULL;
 
   return error;
 }
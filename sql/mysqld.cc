@@ -83,6 +83,8 @@
 #endif /* WITH_WSREP */
 #include "proxy_protocol.h"
 #include "gtid_index.h"
+#include "rpl_writeset.h"
+#include "rpl_binlog_tail.h"
 
 #include "sql_callback.h"
 #include "threadpool.h"
@@ -379,6 +381,7 @@ static plugin_ref opt_binlog_engine_plugin;
 const char *opt_binlog_directory;
 handlerton *opt_binlog_engine_hton;
 bool opt_bin_log_compress;
+ulong opt_bin_log_compress_alg= BINLOG_COMPRESS_ZLIB;
 uint opt_bin_log_compress_min_len;
 my_bool opt_log, debug_assert_if_crashed_table= 0, opt_help= 0;
 my_bool debug_assert_on_not_freed_memory= 0;
@@ -524,11 +527,15 @@ ulong specialflag=0;
 ulong binlog_cache_use= 0, binlog_cache_disk_use= 0;
 ulong binlog_stmt_cache_use= 0, binlog_stmt_cache_disk_use= 0;
 ulong binlog_gtid_index_hit= 0, binlog_gtid_index_miss= 0;
+ulong binlog_dump_cache_hit= 0, binlog_dump_cache_miss= 0;
+ulong binlog_dump_sendfile_events= 0;
 ulong max_connections, max_connect_errors;
 uint max_password_errors;
 ulong extra_max_connections;
 uint max_digest_length= 0;
 ulong slave_retried_transactions;
+ulong slave_rows_hash_scans, slave_rows_prefetched;
+ulong slave_events_decoded_ahead;
 ulong transactions_multi_engine;
 ulong rpl_transactions_multi_engine;
 ulong transactions_gtid_foreign_engine;
@@ -960,7 +967,7 @@ PSI_mutex_key key_BINLOG_LOCK_index, key_BINLOG_LOCK_binlog_use,
   key_LOCK_status, key_LOCK_temp_pool,
   key_LOCK_system_variables_hash, key_LOCK_thd_data, key_LOCK_thd_kill,
   key_LOCK_user_conn, key_LOCK_uuid_short_generator, key_LOG_LOCK_log,
-  key_gtid_index_lock,
+  key_gtid_index_lock, key_LOCK_writeset_history,
   key_master_info_data_lock, key_master_info_run_lock,
   key_master_info_sleep_lock, key_master_info_start_stop_lock,
   key_master_info_start_alter_lock,
@@ -976,7 +983,8 @@ PSI_mutex_key key_RELAYLOG_LOCK_index;
 PSI_mutex_key key_LOCK_relaylog_end_pos;
 PSI_mutex_key key_LOCK_thread_id;
 PSI_mutex_key key_LOCK_slave_state, key_LOCK_binlog_state,
-  key_LOCK_rpl_thread, key_LOCK_rpl_thread_pool, key_LOCK_parallel_entry;
+  key_LOCK_rpl_thread, key_LOCK_rpl_thread_pool, key_LOCK_parallel_entry,
+  key_LOCK_rows_prefetch, key_LOCK_event_decode;
 PSI_mutex_key key_LOCK_rpl_semi_sync_master_enabled;
 PSI_mutex_key key_LOCK_binlog;
 
@@ -1046,6 +1054,7 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_uuid_short_generator, "LOCK_uuid_short_generator", PSI_FLAG_GLOBAL},
   { &key_LOG_LOCK_log, "LOG::LOCK_log", 0},
   { &key_gtid_index_lock, "Gtid_index_writer::gtid_index_mutex", 0},
+  { &key_LOCK_writeset_history, "Rpl_writeset_history::LOCK_writeset_history", 0},
   { &key_master_info_data_lock, "Master_info::data_lock", 0},
   { &key_master_info_start_stop_lock, "Master_info::start_stop_lock", 0},
   { &key_master_info_run_lock, "Master_info::run_lock", 0},
@@ -1074,6 +1083,8 @@ static PSI_mutex_info all_server_mutexes[]=
   { &key_LOCK_rpl_thread, "LOCK_rpl_thread", 0},
   { &key_LOCK_rpl_thread_pool, "LOCK_rpl_thread_pool", 0},
   { &key_LOCK_parallel_entry, "LOCK_parallel_entry", 0},
+  { &key_LOCK_rows_prefetch, "LOCK_rows_prefetch", 0},
+  { &key_LOCK_event_decode, "LOCK_event_decode", 0},
   { &key_LOCK_ack_receiver, "Ack_receiver::mutex", 0},
   { &key_LOCK_rpl_semi_sync_master_enabled, "LOCK_rpl_semi_sync_master_enabled", 0},
   { &key_LOCK_binlog, "LOCK_binlog", 0}
@@ -1086,7 +1097,7 @@ PSI_rwlock_key key_rwlock_LOCK_grant, key_rwlock_LOCK_logger,
   key_rwlock_LOCK_vers_stats, key_rwlock_LOCK_stat_serial,
   key_rwlock_LOCK_ssl_refresh,
   key_rwlock_THD_list,
-  key_rwlock_LOCK_all_status_vars;
+  key_rwlock_LOCK_all_status_vars, key_rwlock_LOCK_binlog_tail;
 
 static PSI_rwlock_info all_server_rwlocks[]=
 {
@@ -1104,7 +1115,8 @@ static PSI_rwlock_info all_server_rwlocks[]=
   { &key_rwlock_LOCK_stat_serial, "TABLE_SHARE::LOCK_stat_serial", 0},
   { &key_rwlock_LOCK_ssl_refresh, "LOCK_ssl_refresh", PSI_FLAG_GLOBAL },
   { &key_rwlock_THD_list, "THD_list::lock", PSI_FLAG_GLOBAL },
-  { &key_rwlock_LOCK_all_status_vars, "LOCK_all_status_vars", PSI_FLAG_GLOBAL }
+  { &key_rwlock_LOCK_all_status_vars, "LOCK_all_status_vars", PSI_FLAG_GLOBAL },
+  { &key_rwlock_LOCK_binlog_tail, "Binlog_tail_cache::LOCK_binlog_tail", PSI_FLAG_GLOBAL }
 };
 
 #ifdef HAVE_MMAP
@@ -1135,7 +1147,8 @@ PSI_cond_key key_TC_LOG_MMAP_COND_queue_busy;
 PSI_cond_key key_COND_rpl_thread_queue, key_COND_rpl_thread,
   key_COND_rpl_thread_stop, key_COND_rpl_thread_pool,
   key_COND_parallel_entry, key_COND_group_commit_orderer,
-  key_COND_prepare_ordered, key_COND_slave_deadlock_handler;
+  key_COND_prepare_ordered, key_COND_slave_deadlock_handler,
+  key_COND_rows_prefetch, key_COND_event_decode, key_COND_event_decoded;
 PSI_cond_key key_COND_wait_gtid, key_COND_gtid_ignore_duplicates;
 PSI_cond_key key_COND_ack_receiver;
 
@@ -1183,6 +1196,9 @@ static PSI_cond_info all_server_conds[]=
   { &key_COND_group_commit_orderer, "COND_group_commit_orderer", 0},
   { &key_COND_prepare_ordered, "COND_prepare_ordered", 0},
   { &key_COND_slave_deadlock_handler, "COND_slave_deadlock_handler", 0},
+  { &key_COND_rows_prefetch, "COND_rows_prefetch", 0},
+  { &key_COND_event_decode, "COND_event_decode", 0},
+  { &key_COND_event_decoded, "COND_event_decoded", 0},
   { &key_COND_start_thread, "COND_start_thread", PSI_FLAG_GLOBAL},
   { &key_COND_wait_gtid, "COND_wait_gtid", 0},
   { &key_COND_gtid_ignore_duplicates, "COND_gtid_ignore_duplicates", 0},
@@ -1194,7 +1210,8 @@ static PSI_cond_info all_server_conds[]=
 PSI_thread_key key_thread_delayed_insert,
   key_thread_handle_manager, key_thread_main,
   key_thread_one_connection, key_thread_signal_hand,
-  key_thread_slave_deadlock_handler, key_rpl_parallel_thread;
+  key_thread_slave_deadlock_handler, key_rpl_parallel_thread,
+  key_thread_rows_prefetch, key_thread_event_decode;
 PSI_thread_key key_thread_ack_receiver;
 
 static PSI_thread_info all_server_threads[]=
@@ -1206,7 +1223,9 @@ static PSI_thread_info all_server_threads[]=
   { &key_thread_signal_hand, "signal_handler", PSI_FLAG_GLOBAL},
   { &key_thread_slave_deadlock_handler, "slave_deadlock_handler", PSI_FLAG_GLOBAL},
   { &key_thread_ack_receiver, "Ack_receiver", PSI_FLAG_GLOBAL},
-  { &key_rpl_parallel_thread, "rpl_parallel", 0}
+  { &key_rpl_parallel_thread, "rpl_parallel", 0},
+  { &key_thread_rows_prefetch, "rows_prefetch", 0},
+  { &key_thread_event_decode, "event_decode", 0}
 };
 
 #ifdef HAVE_MMAP
@@ -2000,6 +2019,10 @@ static void clean_up(bool print_message, bool use_dummy_thd)
   injector::free_instance();
   mysql_bin_log.cleanup();
   Gtid_index_writer::gtid_index_cleanup();
+  rpl_writeset_history.destroy();
+#ifdef HAVE_REPLICATION
+  binlog_tail_cache.destroy();
+#endif
   if (opt_binlog_engine_plugin)
     plugin_unlock(0, opt_binlog_engine_plugin);
 
@@ -4088,6 +4111,10 @@ static int init_common_variables()
   */
   mysql_bin_log.init_pthread_objects();
   Gtid_index_writer::gtid_index_init();
+  rpl_writeset_history.init();
+#ifdef HAVE_REPLICATION
+  binlog_tail_cache.init();
+#endif
 
 #if LONG_SIZE == 4
   /* TODO: remove this when my_time_t is 64 bit compatible */
@@ -7898,6 +7925,9 @@ SHOW_VAR status_vars[]= {
   {"Binlog_bytes_written",     (char*) offsetof(STATUS_VAR, binlog_bytes_written), SHOW_LONGLONG_STATUS},
   {"Binlog_cache_disk_use",    (char*) &binlog_cache_disk_use,  SHOW_LONG},
   {"Binlog_cache_use",         (char*) &binlog_cache_use,       SHOW_LONG},
+  {"Binlog_dump_cache_hit",    (char*) &binlog_dump_cache_hit, SHOW_LONG},
+  {"Binlog_dump_cache_miss",   (char*) &binlog_dump_cache_miss, SHOW_LONG},
+  {"Binlog_dump_sendfile_events", (char*) &binlog_dump_sendfile_events, SHOW_LONG},
   {"Binlog_gtid_index_hit",    (char*) &binlog_gtid_index_hit, SHOW_LONG},
   {"Binlog_gtid_index_miss",   (char*) &binlog_gtid_index_miss, SHOW_LONG},
   {"Binlog_stmt_cache_disk_use",(char*) &binlog_stmt_cache_disk_use,  SHOW_LONG},
@@ -7994,6 +8024,8 @@ SHOW_VAR status_vars[]= {
   {"Max_memory_used",          (char*) &show_max_memory_used, SHOW_SIMPLE_FUNC},
   {"Memory_used",              (char*) &show_memory_used, SHOW_SIMPLE_FUNC},
   {"Memory_used_initial",      (char*) &start_memory_used, SHOW_LONGLONG_NOFLUSH},
+  {"Memroot_block_cache_hits", (char*) &my_root_block_cache_hits, SHOW_LONGLONG},
+  {"Memroot_block_cache_misses", (char*) &my_root_block_cache_misses, SHOW_LONGLONG},
   {"Resultset_metadata_skipped", (char *) offsetof(STATUS_VAR, skip_metadata_count),SHOW_LONG_STATUS},
   {"Not_flushed_delayed_rows", (char*) &delayed_rows_in_use,    SHOW_LONG_NOFLUSH},
   {"Open_files",               (char*) &my_file_opened,         SHOW_SINT},
@@ -8039,6 +8071,8 @@ SHOW_VAR status_vars[]= {
   {"Qcache_total_blocks",      (char*) &query_cache.total_blocks, SHOW_LONG_NOFLUSH},
   {"Queries",                  (char*) &show_queries,            SHOW_SIMPLE_FUNC},
   {"Query_time",               (char*) offsetof(STATUS_VAR, query_time), SHOW_MICROSECOND_STATUS},
+  {"Query_template_cache_hits", (char*) offsetof(STATUS_VAR, query_template_cache_hits), SHOW_LONG_STATUS},
+  {"Query_template_cache_misses", (char*) offsetof(STATUS_VAR, query_template_cache_misses), SHOW_LONG_STATUS},
   {"Questions",                (char*) offsetof(STATUS_VAR, questions), SHOW_LONG_STATUS},
 #ifdef HAVE_REPLICATION
   {"Rpl_status",               (char*) &show_rpl_status,          SHOW_SIMPLE_FUNC},
@@ -8053,9 +8087,12 @@ SHOW_VAR status_vars[]= {
   {"Slaves_connected",        (char*) &binlog_dump_thread_count, SHOW_ATOMIC_COUNTER_UINT32_T},
   {"Slaves_running",          (char*) &show_slaves_running, SHOW_SIMPLE_FUNC },
   {"Slave_connections",       (char*) offsetof(STATUS_VAR, com_register_slave), SHOW_LONG_STATUS},
+  {"Slave_events_decoded_ahead",(char*) &slave_events_decoded_ahead, SHOW_LONG},
   {"Slave_heartbeat_period",   (char*) &show_heartbeat_period, SHOW_SIMPLE_FUNC},
   {"Slave_received_heartbeats",(char*) &show_slave_received_heartbeats, SHOW_SIMPLE_FUNC},
   {"Slave_retried_transactions",(char*)&slave_retried_transactions, SHOW_LONG},
+  {"Slave_rows_hash_scans",    (char*) &slave_rows_hash_scans,  SHOW_LONG},
+  {"Slave_rows_prefetched",    (char*) &slave_rows_prefetched,  SHOW_LONG},
   {"Slave_running",            (char*) &show_slave_running,     SHOW_SIMPLE_FUNC},
   {"Slave_skipped_errors",     (char*) &slave_skipped_errors, SHOW_LONGLONG},
 #endif
@@ -8129,6 +8166,7 @@ SHOW_VAR status_vars[]= {
   {"Update_scan",	       (char*) offsetof(STATUS_VAR, update_scan_count), SHOW_LONG_STATUS},
   {"Uptime",                   (char*) &show_starttime,         SHOW_SIMPLE_FUNC},
   {"Uptime_since_flush_status",(char*) &show_flushstatustime,   SHOW_SIMPLE_FUNC},
+  {"Vector_index_bulk_builds", (char*) offsetof(STATUS_VAR, vector_index_bulk_builds), SHOW_LONG_STATUS},
 #ifdef WITH_WSREP
   {"wsrep_connected",         (char*) &wsrep_connected,         SHOW_BOOL},
   {"wsrep_ready",             (char*) &wsrep_show_ready,        SHOW_FUNC},
@@ -8329,6 +8367,8 @@ static int mysql_init_variables(void)
   specialflag= 0;
   binlog_cache_use=  binlog_cache_disk_use= 0;
   binlog_gtid_index_hit= binlog_gtid_index_miss= 0;
+  binlog_dump_cache_hit= binlog_dump_cache_miss= 0;
+  binlog_dump_sendfile_events= 0;
   max_used_connections= slow_launch_threads = 0;
   max_used_connections_time= 0;
   mysqld_user= mysqld_chroot= opt_init_file= opt_bin_logname = 0;
@@ -8390,6 +8430,8 @@ static int mysql_init_variables(void)
   report_user= report_password = report_host= 0;	/* TO BE DELETED */
   opt_relay_logname= opt_relaylog_index_name= 0;
   slave_retried_transactions= 0;
+  slave_rows_hash_scans= slave_rows_prefetched= 0;
+  slave_events_decoded_ahead= 0;
   transactions_multi_engine= 0;
   rpl_transactions_multi_engine= 0;
   transactions_gtid_foreign_engine= 0;
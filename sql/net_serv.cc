@@ -453,6 +453,66 @@ my_bool my_net_write(NET *net, const uchar *packet, size_t len)
 }
 
 
+#ifdef HAVE_SENDFILE
+/**
+  Write a logical packet, of which all but the first head_len bytes are
+  sent from a file with sendfile().
+
+  The packet must fit in one physical packet, and compression must not be
+  used, as the bytes from the file are sent as they are.
+
+  @param net       NET handler, with a TCP/IP or Unix socket
+  @param head      First bytes of the packet
+  @param head_len  Length of head
+  @param file      File with the rest of the packet
+  @param offset    Position of the rest of the packet in the file
+  @param len       Length of the rest of the packet
+
+  @retval 0  ok
+  @retval 1  error
+*/
+
+my_bool my_net_write_file(NET *net, const uchar *head, size_t head_len,
+                          File file, my_off_t offset, size_t len)
+{
+  uchar buff[NET_HEADER_SIZE];
+  size_t length;
+  my_bool rc;
+  DBUG_ENTER("my_net_write_file");
+  DBUG_ASSERT(!net->compress);
+  DBUG_ASSERT(head_len + len < MAX_PACKET_LENGTH);
+
+  if (unlikely(!net->vio)) /* nowhere to write */
+    DBUG_RETURN(0);
+
+  MYSQL_NET_WRITE_START(head_len + len);
+  int3store(buff, head_len + len);
+  buff[3]= (uchar) net->pkt_nr++;
+  if (net_write_buff(net, buff, NET_HEADER_SIZE) ||
+      net_write_buff(net, head, head_len) || net_flush(net))
+  {
+    MYSQL_NET_WRITE_DONE(1);
+    DBUG_RETURN(1);
+  }
+
+  net->reading_or_writing= 2;
+  length= vio_sendfile(net->vio, file, offset, len);
+  if ((rc= length != len))
+  {
+    net->error= 2;                              /* Close socket */
+    net->last_errno= (ssize_t(length) < 0 && vio_should_retry(net->vio) ?
+                      ER_NET_WRITE_INTERRUPTED : ER_NET_ERROR_ON_WRITE);
+    MYSQL_SERVER_my_error(net->last_errno, MYF(0));
+  }
+  else
+    update_statistics(thd_increment_bytes_sent(net->thd, length));
+  net->reading_or_writing= 0;
+  MYSQL_NET_WRITE_DONE(rc);
+  DBUG_RETURN(rc);
+}
+#endif /* HAVE_SENDFILE */
+
+
 /**
   Send a command to the server.
 
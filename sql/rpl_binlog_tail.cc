@@ -0,0 +1,280 @@
+/*
+   Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "mariadb.h"
+#include "sql_priv.h"
+#include "mysqld.h"
+#include "rpl_binlog_tail.h"
+
+#ifdef HAVE_REPLICATION
+
+ulong opt_binlog_dump_cache_size= 0;
+
+Binlog_tail_cache binlog_tail_cache;
+
+
+/* write_function of the IO_CACHE of the active binlog file */
+
+static int binlog_tail_write(IO_CACHE *info, const uchar *data, size_t length)
+{
+  return binlog_tail_cache.write(info, data, length);
+}
+
+
+/*
+  read_function of the IO_CACHE of a dump thread reading the active binlog
+  file. Like _my_b_cache_read(), it fills the buffer of the cache, or reads
+  directly into the caller's buffer when more than the buffer is wanted,
+  but from the ring when it has the bytes.
+*/
+
+static int binlog_tail_read(IO_CACHE *info, uchar *buf, size_t count)
+{
+  Binlog_tail_reader *reader= (Binlog_tail_reader*) info->append_read_pos;
+  /* pos_in_file always point on where info->buffer was read */
+  my_off_t pos= info->pos_in_file + (size_t) (info->read_end - info->buffer);
+
+  if (count >= info->read_length)
+  {
+    if (pos + count <= info->end_of_file &&
+        binlog_tail_cache.read(reader->file_no, pos, buf, count) == count)
+    {
+      info->pos_in_file= pos + count;
+      info->read_pos= info->read_end= info->buffer;
+      info->seek_not_done= 1;
+      reader->hits++;
+      return 0;
+    }
+  }
+  else if (pos + count <= info->end_of_file)
+  {
+    size_t length= (size_t) MY_MIN(info->read_length,
+                                   info->end_of_file - pos);
+    if ((length= binlog_tail_cache.read(reader->file_no, pos, info->buffer,
+                                        length)) >= count)
+    {
+      info->pos_in_file= pos;
+      info->read_pos= info->buffer + count;
+      info->read_end= info->buffer + length;
+      info->seek_not_done= 1;
+      memcpy(buf, info->buffer, count);
+      reader->hits++;
+      return 0;
+    }
+  }
+  reader->misses++;
+  return reader->file_read_function(info, buf, count);
+}
+
+
+Binlog_tail_cache::Binlog_tail_cache()
+  :m_file_write_function(NULL), m_buf(NULL), m_size(0), m_start(0), m_end(0),
+   m_file_no(0), m_last_file_no(0), m_inited(false)
+{
+  m_file_name[0]= 0;
+}
+
+
+void Binlog_tail_cache::init()
+{
+  mysql_rwlock_init(key_rwlock_LOCK_binlog_tail, &LOCK_binlog_tail);
+  m_inited= true;
+}
+
+
+void Binlog_tail_cache::destroy()
+{
+  if (!m_inited)
+    return;
+  my_free(m_buf);
+  m_buf= NULL;
+  m_size= 0;
+  mysql_rwlock_destroy(&LOCK_binlog_tail);
+  m_inited= false;
+}
+
+
+/**
+  Start copying what is written to a new active binlog file into the ring
+
+  @param log   IO_CACHE of the file, just opened
+  @param name  Name of the file, as in the binlog index
+*/
+
+void Binlog_tail_cache::start_file(IO_CACHE *log, const char *name)
+{
+  if (!opt_binlog_dump_cache_size)
+    return;
+  DBUG_ASSERT(log->type == WRITE_CACHE && !log->share &&
+              !(log->myflags & MY_ENCRYPT));
+
+  mysql_rwlock_wrlock(&LOCK_binlog_tail);
+  if (!m_buf)
+  {
+    if (!(m_buf= (uchar*) my_malloc(PSI_INSTRUMENT_ME,
+                                    opt_binlog_dump_cache_size, MYF(MY_WME))))
+    {
+      mysql_rwlock_unlock(&LOCK_binlog_tail);
+      return;
+    }
+    m_size= opt_binlog_dump_cache_size;
+  }
+  m_file_no= ++m_last_file_no;
+  strmake_buf(m_file_name, name);
+  m_start= m_end= my_b_tell(log);
+  mysql_rwlock_unlock(&LOCK_binlog_tail);
+
+  m_file_write_function= log->write_function;
+  log->write_function= binlog_tail_write;
+}
+
+
+/* Empty the ring, when the active binlog file is closed */
+
+void Binlog_tail_cache::end_file()
+{
+  if (!opt_binlog_dump_cache_size)
+    return;
+  mysql_rwlock_wrlock(&LOCK_binlog_tail);
+  m_file_no= 0;
+  m_file_name[0]= 0;
+  m_start= m_end= 0;
+  mysql_rwlock_unlock(&LOCK_binlog_tail);
+}
+
+
+int Binlog_tail_cache::write(IO_CACHE *log, const uchar *data, size_t length)
+{
+  my_off_t pos= log->pos_in_file;
+  int res= m_file_write_function(log, data, length);
+  /* On error the next write does not follow the ring, and empties it */
+  if (log->pos_in_file > pos)
+    append(pos, data, (size_t) (log->pos_in_file - pos));
+  return res;
+}
+
+
+/* Add bytes written at pos in the active file to the ring */
+
+void Binlog_tail_cache::append(my_off_t pos, const uchar *data, size_t length)
+{
+  size_t offset, first;
+  mysql_rwlock_wrlock(&LOCK_binlog_tail);
+  if (!m_file_no)
+    goto end;
+  if (pos != m_end)
+    m_start= m_end= pos;
+  if (length > m_size)
+  {
+    data+= length - m_size;
+    pos+= length - m_size;
+    length= m_size;
+    m_start= m_end= pos;
+  }
+  offset= (size_t) (m_end % m_size);
+  first= MY_MIN(length, m_size - offset);
+  memcpy(m_buf + offset, data, first);
+  memcpy(m_buf, data + first, length - first);
+  m_end+= length;
+  if (m_end - m_start > m_size)
+    m_start= m_end - m_size;
+end:
+  mysql_rwlock_unlock(&LOCK_binlog_tail);
+}
+
+
+/**
+  Copy bytes of the active binlog file from the ring
+
+  @param file_no  Binlog_tail_reader::file_no of the reader
+  @param pos      Position in the file of the first byte wanted
+  @param buf      Where to copy the bytes
+  @param length   Number of bytes wanted
+
+  @return Number of bytes copied, which is less than length if the ring
+          does not have all of them, and 0 if the ring does not have the
+          first one
+*/
+
+size_t Binlog_tail_cache::read(ulonglong file_no, my_off_t pos, uchar *buf,
+                               size_t length)
+{
+  size_t offset, first;
+  mysql_rwlock_rdlock(&LOCK_binlog_tail);
+  if (file_no != m_file_no || pos < m_start || pos >= m_end)
+    length= 0;
+  else
+  {
+    set_if_smaller(length, (size_t) (m_end - pos));
+    offset= (size_t) (pos % m_size);
+    first= MY_MIN(length, m_size - offset);
+    memcpy(buf, m_buf + offset, first);
+    memcpy(buf + first, m_buf, length - first);
+  }
+  mysql_rwlock_unlock(&LOCK_binlog_tail);
+  return length;
+}
+
+
+/**
+  Let a dump thread read a binlog file from the ring, if it is the active
+  file
+
+  @param reader  State of the reader, which must live until detach_reader()
+  @param log     IO_CACHE the dump thread reads the file with
+  @param name    Name of the file, as in the binlog index
+*/
+
+void Binlog_tail_cache::attach_reader(Binlog_tail_reader *reader,
+                                      IO_CACHE *log, const char *name)
+{
+  reader->log= NULL;
+  reader->file_no= 0;
+  reader->hits= reader->misses= 0;
+  if (!opt_binlog_dump_cache_size)
+    return;
+  DBUG_ASSERT(log->type == READ_CACHE && !log->share &&
+              !(log->myflags & MY_ENCRYPT));
+
+  mysql_rwlock_rdlock(&LOCK_binlog_tail);
+  if (m_file_no && !strcmp(name, m_file_name))
+    reader->file_no= m_file_no;
+  mysql_rwlock_unlock(&LOCK_binlog_tail);
+  if (!reader->file_no)
+    return;
+
+  reader->log= log;
+  reader->file_read_function= log->read_function;
+  log->read_function= binlog_tail_read;
+  log->append_read_pos= (uchar*) reader;
+}
+
+
+void Binlog_tail_cache::detach_reader(Binlog_tail_reader *reader)
+{
+  if (!reader->log)
+    return;
+  reader->log->read_function= reader->file_read_function;
+  reader->log->append_read_pos= NULL;
+  reader->log= NULL;
+  mysql_mutex_lock(&LOCK_status);
+  binlog_dump_cache_hit+= reader->hits;
+  binlog_dump_cache_miss+= reader->misses;
+  mysql_mutex_unlock(&LOCK_status);
+}
+
+#endif /* HAVE_REPLICATION */
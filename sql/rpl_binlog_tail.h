@@ -0,0 +1,91 @@
+/*
+   Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef RPL_BINLOG_TAIL_H
+#define RPL_BINLOG_TAIL_H
+
+/*
+  In-memory copy of the end of the active binlog file, shared by the binlog
+  dump threads.
+
+  Every dump thread reads the binlog through its own IO_CACHE. When the
+  slaves are caught up, they all read the same few most recently written
+  bytes, each with its own read() calls.
+
+  With --binlog-dump-cache-size=N, the IO_CACHE of the active binlog file
+  copies everything it writes to the file into a ring buffer of N bytes.
+  The IO_CACHE of a dump thread reading the same file fills its buffer from
+  the ring when the bytes it needs are still there, and reads the file
+  otherwise, eg. when the slave lags behind by more than N bytes.
+
+  The ring is only for the active binlog file. It is emptied when the file
+  is closed, and a reader of a file that is no longer active, or of an
+  earlier file of the same name before RESET MASTER, always reads the file.
+*/
+
+#ifdef HAVE_REPLICATION
+
+extern ulong opt_binlog_dump_cache_size;
+
+/* State of one dump thread reading a binlog file */
+struct Binlog_tail_reader
+{
+  IO_CACHE *log;
+  int (*file_read_function)(IO_CACHE *, uchar *, size_t);
+  /* File_no of the ring when the file was opened, 0 if not the active file */
+  ulonglong file_no;
+  ulong hits, misses;
+};
+
+
+class Binlog_tail_cache
+{
+public:
+  Binlog_tail_cache();
+  void init();
+  void destroy();
+
+  /* Writer side, called with LOCK_log */
+  void start_file(IO_CACHE *log, const char *name);
+  void end_file();
+  int write(IO_CACHE *log, const uchar *data, size_t length);
+
+  /* Reader side */
+  void attach_reader(Binlog_tail_reader *reader, IO_CACHE *log,
+                     const char *name);
+  void detach_reader(Binlog_tail_reader *reader);
+  size_t read(ulonglong file_no, my_off_t pos, uchar *buf, size_t length);
+
+private:
+  void append(my_off_t pos, const uchar *data, size_t length);
+
+  int (*m_file_write_function)(IO_CACHE *, const uchar *, size_t);
+  mysql_rwlock_t LOCK_binlog_tail;
+  uchar *m_buf;
+  size_t m_size;
+  /* The ring has the bytes of the active file from m_start to m_end */
+  my_off_t m_start, m_end;
+  /* Incremented for every file, 0 when no file is active */
+  ulonglong m_file_no, m_last_file_no;
+  char m_file_name[FN_REFLEN];
+  bool m_inited;
+};
+
+extern Binlog_tail_cache binlog_tail_cache;
+
+#endif /* HAVE_REPLICATION */
+#endif /* RPL_BINLOG_TAIL_H */
@@ -0,0 +1,362 @@
+/*
+   Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "mariadb.h"
+#include "sql_priv.h"
+#include "mysqld.h"
+#include "log_event.h"
+#include "rpl_event_decode.h"
+
+#ifdef HAVE_REPLICATION
+
+ulong opt_slave_parallel_decode_threads= 0;
+
+Rpl_event_decoder rpl_event_decoder;
+
+
+/*
+  Events that change how the events after them are read. These are not
+  read ahead of, and are decoded by the driver itself.
+*/
+
+static bool is_decode_barrier(uint type)
+{
+  return type == FORMAT_DESCRIPTION_EVENT || type == START_EVENT_V3 ||
+         type == START_ENCRYPTION_EVENT;
+}
+
+
+static const char *read_error_message(int res)
+{
+  switch (res) {
+  case LOG_READ_BOGUS:
+    return "Event invalid";
+  case LOG_READ_IO:
+    return "read error";
+  case LOG_READ_MEM:
+    return "Out of memory";
+  case LOG_READ_TRUNC:
+    return "Event truncated";
+  case LOG_READ_TOO_LARGE:
+    return "Event too big";
+  case LOG_READ_DECRYPT:
+    return "Event decryption failure";
+  default:
+    DBUG_ASSERT(0);
+    return "internal error";
+  }
+}
+
+
+void Event_decode_job::decode()
+{
+  if ((ev= Log_event::read_log_event((uchar*) packet.ptr(), packet.length(),
+                                     &error, fdle, crc_check, false)))
+    ev->register_temp_buf((uchar*) packet.release(), true);
+  else if (!error)
+    error= "Unknown event type";
+}
+
+
+/**
+  Read the next event from the relay log, and the events after it for
+  the decode threads
+
+  @param log        Relay log, positioned at the event
+  @param out_error  Set to 1 on error, as for Log_event::read_log_event()
+  @param fdle       Format of the relay log
+  @param crc_check  Verify the checksums of the events
+  @param end_pos    Set to the relay log position after the event
+
+  @return The event read, or NULL on error or at the end of the log. The
+          log is positioned after the events read ahead, which are taken
+          with next_event().
+*/
+
+Log_event *
+Relay_log_decode_ahead::read_event(IO_CACHE *log, int *out_error,
+                                   const Format_description_log_event *fdle,
+                                   my_bool crc_check, my_off_t *end_pos)
+{
+  Log_event *ev;
+  DBUG_ASSERT(!m_count);
+  ev= Log_event::read_log_event(log, out_error, fdle, crc_check);
+  *end_pos= my_b_tell(log);
+  if (ev && !is_decode_barrier(ev->get_type_code()))
+    read_ahead(log, fdle, crc_check);
+  return ev;
+}
+
+
+void Relay_log_decode_ahead::read_ahead(IO_CACHE *log,
+                                        const Format_description_log_event
+                                        *fdle, my_bool crc_check)
+{
+  my_off_t pos= my_b_tell(log);
+  ulonglong bytes= 0;
+
+  m_first= 0;
+  while (m_count < DECODE_AHEAD_MAX_EVENTS &&
+         bytes < opt_slave_parallel_max_queued)
+  {
+    Event_decode_job *job= m_jobs + m_count;
+    int res;
+
+    job->packet.length(0);
+    if ((res= Log_event::read_log_event(log, &job->packet, fdle,
+                                        BINLOG_CHECKSUM_ALG_OFF)))
+    {
+      if (res == LOG_READ_EOF)
+        break;
+      /* Let the error be reported when the driver gets to the event */
+      job->error= read_error_message(res);
+      job->state= Event_decode_job::DONE;
+      log->error= 0;
+      m_count++;
+      break;
+    }
+    job->end_pos= my_b_tell(log);
+    job->size= job->end_pos - pos;
+    job->fdle= fdle;
+    job->crc_check= crc_check;
+    pos= job->end_pos;
+    bytes+= job->size;
+    m_count++;
+    if (is_decode_barrier((uchar) job->packet[EVENT_TYPE_OFFSET]))
+      break;
+    if (rpl_event_decoder.submit(job))
+      break;
+  }
+}
+
+
+/**
+  Take the next event read ahead
+
+  @param[out] end_pos  Relay log position after the event
+  @param[out] size     Size of the event in the relay log
+  @param[out] error    Set on error
+
+  @return The event, or NULL on error
+*/
+
+Log_event *Relay_log_decode_ahead::next_event(my_off_t *end_pos,
+                                              ulonglong *size,
+                                              const char **error)
+{
+  Event_decode_job *job= m_jobs + m_first;
+  Log_event *ev;
+  DBUG_ASSERT(m_count);
+
+  if (job->state == Event_decode_job::IDLE)
+    job->decode();
+  else
+    rpl_event_decoder.wait(job);
+
+  *end_pos= job->end_pos;
+  *size= job->size;
+  *error= job->error;
+  ev= job->ev;
+  job->ev= NULL;
+  job->error= NULL;
+  job->state= Event_decode_job::IDLE;
+  job->packet.free();
+  m_first++;
+  m_count--;
+  return ev;
+}
+
+
+/* Throw away the events read ahead, when the SQL thread stops */
+
+void Relay_log_decode_ahead::clear()
+{
+  for (; m_count; m_first++, m_count--)
+  {
+    Event_decode_job *job= m_jobs + m_first;
+    if (job->state != Event_decode_job::IDLE)
+      rpl_event_decoder.wait(job);
+    delete job->ev;
+    job->ev= NULL;
+    job->error= NULL;
+    job->state= Event_decode_job::IDLE;
+    job->packet.free();
+  }
+  m_first= 0;
+}
+
+
+Rpl_event_decoder::Rpl_event_decoder()
+  :m_threads(0), m_stop(false), m_inited(false)
+{
+}
+
+
+void Rpl_event_decoder::init()
+{
+  mysql_mutex_init(key_LOCK_event_decode, &LOCK_event_decode,
+                   MY_MUTEX_INIT_SLOW);
+  mysql_cond_init(key_COND_event_decode, &COND_event_decode, NULL);
+  mysql_cond_init(key_COND_event_decoded, &COND_event_decoded, NULL);
+  m_stop= false;
+  m_inited= true;
+}
+
+
+/*
+  Stop the decode threads. Called at shutdown, when the SQL threads are
+  already gone.
+*/
+
+void Rpl_event_decoder::stop()
+{
+  if (!m_inited)
+    return;
+  mysql_mutex_lock(&LOCK_event_decode);
+  m_stop= true;
+  mysql_cond_broadcast(&COND_event_decode);
+  while (m_threads)
+    mysql_cond_wait(&COND_event_decode, &LOCK_event_decode);
+  DBUG_ASSERT(m_queue.empty());
+  mysql_mutex_unlock(&LOCK_event_decode);
+}
+
+
+void Rpl_event_decoder::destroy()
+{
+  if (!m_inited)
+    return;
+  stop();
+  mysql_cond_destroy(&COND_event_decoded);
+  mysql_cond_destroy(&COND_event_decode);
+  mysql_mutex_destroy(&LOCK_event_decode);
+  m_inited= false;
+}
+
+
+pthread_handler_t handle_event_decode(void *arg)
+{
+  Rpl_event_decoder *pool= (Rpl_event_decoder*) arg;
+
+  my_thread_init();
+  my_thread_set_name("event_decode");
+  pool->run();
+  pool->thread_exit();
+  my_thread_end();
+  return 0;
+}
+
+
+bool Rpl_event_decoder::start_threads(uint count)
+{
+  mysql_mutex_assert_owner(&LOCK_event_decode);
+  while (m_threads < count)
+  {
+    pthread_t th;
+    if (mysql_thread_create(key_thread_event_decode, &th, &connection_attrib,
+                            handle_event_decode, this))
+    {
+      sql_print_error("Failed to create slave event decode thread");
+      return m_threads == 0;
+    }
+    m_threads++;
+  }
+  return false;
+}
+
+
+void Rpl_event_decoder::thread_exit()
+{
+  mysql_mutex_lock(&LOCK_event_decode);
+  m_threads--;
+  mysql_cond_broadcast(&COND_event_decode);
+  mysql_mutex_unlock(&LOCK_event_decode);
+}
+
+
+void Rpl_event_decoder::run()
+{
+  mysql_mutex_lock(&LOCK_event_decode);
+  for (;;)
+  {
+    Event_decode_job *job;
+    while (!m_stop && m_queue.empty())
+      mysql_cond_wait(&COND_event_decode, &LOCK_event_decode);
+    if (m_stop)
+      break;
+    job= &m_queue.front();
+    m_queue.pop_front();
+    job->state= Event_decode_job::RUNNING;
+    mysql_mutex_unlock(&LOCK_event_decode);
+
+    job->decode();
+    statistic_increment(slave_events_decoded_ahead, &LOCK_status);
+
+    mysql_mutex_lock(&LOCK_event_decode);
+    job->state= Event_decode_job::DONE;
+    mysql_cond_broadcast(&COND_event_decoded);
+  }
+  mysql_mutex_unlock(&LOCK_event_decode);
+}
+
+
+/**
+  Queue an event for the decode threads
+
+  @retval false  The event is queued, and must be given to wait()
+  @retval true   No decode thread could be started
+*/
+
+bool Rpl_event_decoder::submit(Event_decode_job *job)
+{
+  mysql_mutex_lock(&LOCK_event_decode);
+  if (m_stop || !opt_slave_parallel_decode_threads ||
+      start_threads((uint) opt_slave_parallel_decode_threads))
+  {
+    mysql_mutex_unlock(&LOCK_event_decode);
+    return true;
+  }
+  job->state= Event_decode_job::QUEUED;
+  m_queue.push_back(*job);
+  mysql_cond_signal(&COND_event_decode);
+  mysql_mutex_unlock(&LOCK_event_decode);
+  return false;
+}
+
+
+/*
+  Wait for an event to be decoded. If no decode thread has taken it yet,
+  it is decoded by the caller.
+*/
+
+void Rpl_event_decoder::wait(Event_decode_job *job)
+{
+  mysql_mutex_lock(&LOCK_event_decode);
+  if (job->state == Event_decode_job::QUEUED)
+  {
+    m_queue.remove(*job);
+    job->state= Event_decode_job::RUNNING;
+    mysql_mutex_unlock(&LOCK_event_decode);
+    job->decode();
+    return;
+  }
+  while (job->state != Event_decode_job::DONE)
+    mysql_cond_wait(&COND_event_decoded, &LOCK_event_decode);
+  mysql_mutex_unlock(&LOCK_event_decode);
+}
+
+#endif /* HAVE_REPLICATION */
@@ -0,0 +1,126 @@
+/*
+   Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef RPL_EVENT_DECODE_H
+#define RPL_EVENT_DECODE_H
+
+/*
+  Decoding of relay log events ahead of the SQL driver thread.
+
+  With parallel replication the SQL driver thread reads every event from
+  the relay log, verifies its checksum, decompresses it and constructs the
+  Log_event, and only then hands it to rpl_parallel::do_event(). With many
+  small transactions the driver becomes the bottleneck before the workers.
+
+  With --slave-parallel-decode-threads=N, whenever the driver reads an
+  event it also reads the raw bytes of the events following it in the
+  relay log file, up to DECODE_AHEAD_MAX_EVENTS events and
+  @@slave_parallel_max_queued bytes, and queues them for N decode threads.
+  The following calls of next_event() then just take the decoded events in
+  order. The raw reads stay in the driver, as they depend on the locking of
+  the hot relay log and on the decryption state.
+
+  A read-ahead stops after a Format_description, Start_encryption or
+  Start_v3 event, as these change how the events after them are read. Such
+  events are decoded by the driver itself once all events before them are
+  taken.
+*/
+
+#ifdef HAVE_REPLICATION
+#include <ilist.h>
+
+extern ulong opt_slave_parallel_decode_threads;
+
+/* Largest number of events read ahead of the driver */
+static constexpr uint DECODE_AHEAD_MAX_EVENTS= 64;
+
+class Log_event;
+class Format_description_log_event;
+
+/* One event read ahead */
+class Event_decode_job: public ilist_node<>
+{
+public:
+  enum state_t { IDLE, QUEUED, RUNNING, DONE };
+
+  Event_decode_job() :fdle(NULL), ev(NULL), error(NULL), end_pos(0), size(0),
+    state(IDLE), crc_check(false) {}
+  void decode();
+
+  String packet;
+  const Format_description_log_event *fdle;
+  Log_event *ev;
+  const char *error;
+  my_off_t end_pos;             /* Relay log position after the event */
+  ulonglong size;
+  state_t state;                /* Protected by LOCK_event_decode */
+  bool crc_check;
+};
+
+
+/* The events read ahead by one SQL driver thread */
+class Relay_log_decode_ahead
+{
+public:
+  Relay_log_decode_ahead() :m_first(0), m_count(0) {}
+  ~Relay_log_decode_ahead() { DBUG_ASSERT(!m_count); }
+  bool pending() const { return m_count != 0; }
+  Log_event *read_event(IO_CACHE *log, int *out_error,
+                        const Format_description_log_event *fdle,
+                        my_bool crc_check, my_off_t *end_pos);
+  Log_event *next_event(my_off_t *end_pos, ulonglong *size,
+                        const char **error);
+  void clear();
+
+private:
+  void read_ahead(IO_CACHE *log, const Format_description_log_event *fdle,
+                  my_bool crc_check);
+
+  Event_decode_job m_jobs[DECODE_AHEAD_MAX_EVENTS];
+  uint m_first, m_count;
+};
+
+
+/* The decode threads */
+class Rpl_event_decoder
+{
+public:
+  Rpl_event_decoder();
+  void init();
+  void stop();
+  void destroy();
+  bool submit(Event_decode_job *job);
+  void wait(Event_decode_job *job);
+  void run();
+  void thread_exit();
+
+private:
+  bool start_threads(uint count);
+
+  mysql_mutex_t LOCK_event_decode;
+  mysql_cond_t COND_event_decode;
+  mysql_cond_t COND_event_decoded;
+  ilist<Event_decode_job> m_queue;
+  uint m_threads;
+  bool m_stop;
+  bool m_inited;
+};
+
+extern Rpl_event_decoder rpl_event_decoder;
+
+#endif /* HAVE_REPLICATION */
+#endif /* RPL_EVENT_DECODE_H */
@@ -3517,6 +3517,21 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
         */
         new_gco= false;
       }
+      else if (mode > SLAVE_PARALLEL_MINIMAL &&
+               (gtid_ev->flags_extra & Gtid_log_event::FL_EXTRA_WRITESET) &&
+               gtid_ev->seq_no > e->last_seq_no &&
+               gtid_ev->writeset_seq_no < e->gco_start_seq_no &&
+               !(flags & group_commit_orderer::FORCE_SWITCH))
+      {
+        /*
+          The master found that the last earlier event group changing any
+          of the same rows is before the current batch. So it is enough to
+          wait for the previous batch like the event groups in this one do,
+          and we can run in parallel without speculation.
+        */
+        new_gco= false;
+        flags= gco->flags;
+      }
       else if ((mode >= SLAVE_PARALLEL_OPTIMISTIC) &&
                !(flags & group_commit_orderer::FORCE_SWITCH))
       {
@@ -3590,8 +3605,10 @@ rpl_parallel::do_event(rpl_group_info *serial_rgi, Log_event *ev,
       }
       gco->flags|= force_switch_flag;
       e->current_gco= gco;
+      e->gco_start_seq_no= gtid_ev->seq_no;
     }
     rgi->gco= gco;
+    e->last_seq_no= gtid_ev->seq_no;
 
     qev->rgi= e->current_group_info= rgi;
     e->current_sub_id= rgi->gtid_sub_id;
@@ -468,6 +468,14 @@ struct rpl_parallel_entry {
   uint64 pause_sub_id;
   /* Total count of event groups queued so far. */
   uint64 count_queued_event_groups;
+  /*
+    GTID seq_no of the last event group queued, and of the first event group
+    in current_gco. An event group whose writeset dependency
+    (Gtid_log_event::writeset_seq_no) is before gco_start_seq_no does not
+    conflict with anything in current_gco, and can join it.
+  */
+  uint64 last_seq_no;
+  uint64 gco_start_seq_no;
   /*
     Count of event groups that have started (but not necessarily completed)
     the commit phase. We use this to know when every event group in a previous
@@ -25,6 +25,7 @@
 #include "sql_class.h"                   /* THD */
 #include "log_event.h"
 #include "rpl_parallel.h"
+#include "rpl_event_decode.h"
 
 struct RPL_TABLE_LIST;
 class Master_info;
@@ -216,6 +217,13 @@ class Relay_log_info:
   char event_relay_log_name[FN_REFLEN];
   ulonglong event_relay_log_pos;
   ulonglong future_event_relay_log_pos;
+#ifdef HAVE_REPLICATION
+  /*
+    Events read from the relay log ahead of the current one, see
+    rpl_event_decode.h. Only used by the SQL driver thread.
+  */
+  Relay_log_decode_ahead decode_ahead;
+#endif
   /*
     The master log name for current event. Only used in parallel replication.
   */
@@ -0,0 +1,331 @@
+/*
+   Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "mariadb.h"
+#include "sql_priv.h"
+#include "mysqld.h"
+#include "sql_class.h"
+#include "sql_base.h"                   // open_and_lock_tables
+#include "key.h"                        // key_hashnr
+#include "rpl_rows_prefetch.h"
+
+#ifdef HAVE_REPLICATION
+
+ulong opt_slave_rows_prefetch_threads= 0;
+
+Rpl_rows_prefetch rpl_rows_prefetch;
+
+
+Rows_prefetch_batch::Rows_prefetch_batch(TABLE *table, uint keynr_arg,
+                                         uint parts_arg)
+  :key_info(table->key_info + keynr_arg), part(NULL), keynr(keynr_arg),
+   key_length(table->key_info[keynr_arg].key_length), parts(parts_arg),
+   rows(0), refs(1), cancelled(false)
+{
+  db.str= db_buf;
+  db.length= strmake(db_buf, table->s->db.str, NAME_LEN) - db_buf;
+  table_name.str= table_name_buf;
+  table_name.length= strmake(table_name_buf, table->s->table_name.str,
+                             NAME_LEN) - table_name_buf;
+  tabledef_version_length= MY_MIN(table->s->tabledef_version.length,
+                                  sizeof(tabledef_version));
+  memcpy(tabledef_version, table->s->tabledef_version.str,
+         tabledef_version_length);
+}
+
+
+Rows_prefetch_batch::~Rows_prefetch_batch()
+{
+  if (part)
+  {
+    for (uint i= 0; i < parts; i++)
+      delete_dynamic(&part[i].keys);
+    my_free(part);
+  }
+}
+
+
+bool Rows_prefetch_batch::init()
+{
+  /*
+    The keys are read by the prefetch threads, and the last of them frees
+    the batch, so nothing is allocated as MY_THREAD_SPECIFIC.
+  */
+  if (!(part= (Part*) my_malloc(PSI_INSTRUMENT_ME, parts * sizeof(Part),
+                                MYF(MY_ZEROFILL))))
+    return true;
+  for (uint i= 0; i < parts; i++)
+  {
+    part[i].batch= this;
+    if (my_init_dynamic_array(PSI_INSTRUMENT_ME, &part[i].keys, key_length,
+                              0, 256, MYF(0)))
+      return true;
+  }
+  return false;
+}
+
+
+/* Add the key of a row to the part given by the hash of the key */
+
+bool Rows_prefetch_batch::add(const uchar *key)
+{
+  ulong hash= key_hashnr(key_info, key_info->user_defined_key_parts, key);
+  if (insert_dynamic(&part[hash % parts].keys, key))
+    return true;
+  rows++;
+  return false;
+}
+
+
+Rpl_rows_prefetch::Rpl_rows_prefetch()
+  :m_queue(NULL), m_queue_last(&m_queue), m_threads(0), m_stop(false),
+   m_inited(false)
+{
+}
+
+
+void Rpl_rows_prefetch::init()
+{
+  mysql_mutex_init(key_LOCK_rows_prefetch, &LOCK_rows_prefetch,
+                   MY_MUTEX_INIT_SLOW);
+  mysql_cond_init(key_COND_rows_prefetch, &COND_rows_prefetch, NULL);
+  m_stop= false;
+  m_inited= true;
+}
+
+
+/*
+  Stop the prefetch threads. Called at shutdown, when the slave worker
+  threads are already gone.
+*/
+
+void Rpl_rows_prefetch::stop()
+{
+  Rows_prefetch_batch::Part *part, *next;
+  if (!m_inited)
+    return;
+  mysql_mutex_lock(&LOCK_rows_prefetch);
+  m_stop= true;
+  mysql_cond_broadcast(&COND_rows_prefetch);
+  while (m_threads)
+    mysql_cond_wait(&COND_rows_prefetch, &LOCK_rows_prefetch);
+  part= m_queue;
+  m_queue= NULL;
+  m_queue_last= &m_queue;
+  mysql_mutex_unlock(&LOCK_rows_prefetch);
+
+  for (; part; part= next)
+  {
+    next= part->next;
+    part->batch->unref();
+  }
+}
+
+
+void Rpl_rows_prefetch::destroy()
+{
+  if (!m_inited)
+    return;
+  stop();
+  mysql_cond_destroy(&COND_rows_prefetch);
+  mysql_mutex_destroy(&LOCK_rows_prefetch);
+  m_inited= false;
+}
+
+
+pthread_handler_t handle_rows_prefetch(void *arg)
+{
+  Rpl_rows_prefetch *pool= (Rpl_rows_prefetch*) arg;
+  THD *thd;
+
+  my_thread_init();
+  my_thread_set_name("rows_prefetch");
+  thd= new THD(next_thread_id());
+  thd->system_thread= SYSTEM_THREAD_SLAVE_BACKGROUND;
+  thd->store_globals();
+  thd->security_ctx->skip_grants();
+  thd->set_command(COM_DAEMON);
+  thd->set_psi(PSI_CALL_get_thread());
+  thd->variables.wsrep_on= 0;
+  /* Do not take any row locks, and do not wait long for anything else */
+  thd->variables.tx_isolation= ISO_READ_UNCOMMITTED;
+  thd->variables.lock_wait_timeout= 1;
+  thd->variables.option_bits&=
+    ~(ulonglong)(OPTION_NOT_AUTOCOMMIT | OPTION_BEGIN | OPTION_BIN_LOG);
+
+  pool->run(thd);
+
+  delete thd;
+  pool->thread_exit();
+  my_thread_end();
+  return 0;
+}
+
+
+bool Rpl_rows_prefetch::start_threads(uint count)
+{
+  mysql_mutex_assert_owner(&LOCK_rows_prefetch);
+  while (m_threads < count)
+  {
+    pthread_t th;
+    if (mysql_thread_create(key_thread_rows_prefetch, &th, &connection_attrib,
+                            handle_rows_prefetch, this))
+    {
+      sql_print_error("Failed to create slave rows prefetch thread");
+      return true;
+    }
+    m_threads++;
+  }
+  return false;
+}
+
+
+void Rpl_rows_prefetch::thread_exit()
+{
+  mysql_mutex_lock(&LOCK_rows_prefetch);
+  m_threads--;
+  mysql_cond_broadcast(&COND_rows_prefetch);
+  mysql_mutex_unlock(&LOCK_rows_prefetch);
+}
+
+
+void Rpl_rows_prefetch::run(THD *thd)
+{
+  mysql_mutex_lock(&LOCK_rows_prefetch);
+  for (;;)
+  {
+    Rows_prefetch_batch::Part *part;
+    thd_proc_info(thd, "Waiting for rows to prefetch");
+    while (!m_stop && !m_queue)
+      mysql_cond_wait(&COND_rows_prefetch, &LOCK_rows_prefetch);
+    if (m_stop)
+      break;
+    part= m_queue;
+    if (!(m_queue= part->next))
+      m_queue_last= &m_queue;
+    mysql_mutex_unlock(&LOCK_rows_prefetch);
+
+    if (!part->batch->cancelled.load(std::memory_order_relaxed))
+      prefetch(thd, part);
+    part->batch->unref();
+
+    mysql_mutex_lock(&LOCK_rows_prefetch);
+  }
+  mysql_mutex_unlock(&LOCK_rows_prefetch);
+}
+
+
+/* Read the rows of one part of a batch */
+
+void Rpl_rows_prefetch::prefetch(THD *thd, Rows_prefetch_batch::Part *part)
+{
+  Rows_prefetch_batch *batch= part->batch;
+  Query_tables_list lex_backup;
+  TABLE_LIST tlist;
+  TABLE *table;
+  ulong rows= 0;
+
+  thd_proc_info(thd, "Prefetching rows");
+  thd->reset_for_next_command();
+  thd->lex->reset_n_backup_query_tables_list(&lex_backup);
+  tlist.init_one_table(&batch->db, &batch->table_name, NULL, TL_READ);
+  if (open_and_lock_tables(thd, &tlist, FALSE,
+                           MYSQL_OPEN_IGNORE_GLOBAL_READ_LOCK))
+    goto end;
+  table= tlist.table;
+
+  /* The worker holds a metadata lock, so this only fails for a new table */
+  if (table->s->tabledef_version.length != batch->tabledef_version_length ||
+      memcmp(table->s->tabledef_version.str, batch->tabledef_version,
+             batch->tabledef_version_length) ||
+      batch->keynr >= table->s->keys ||
+      table->key_info[batch->keynr].key_length != batch->key_length)
+    goto end;
+
+  table->mark_index_columns(batch->keynr, table->read_set);
+  if (table->file->ha_index_init(batch->keynr, 0))
+    goto end;
+  for (size_t i= 0; i < part->keys.elements; i++)
+  {
+    if (!(i % 64) &&
+        (batch->cancelled.load(std::memory_order_relaxed) || thd->killed))
+      break;
+    table->file->ha_index_read_map(table->record[0],
+                                   part->keys.buffer +
+                                   i * part->keys.size_of_element,
+                                   HA_WHOLE_KEY, HA_READ_KEY_EXACT);
+    rows++;
+  }
+  table->file->ha_index_end();
+
+end:
+  thd->clear_error();
+  if (tlist.table && ha_commit_trans(thd, FALSE))
+    ha_rollback_trans(thd, FALSE);
+  close_thread_tables(thd);
+  thd->release_transactional_locks();
+  thd->lex->restore_backup_query_tables_list(&lex_backup);
+  statistic_add(slave_rows_prefetched, rows, &LOCK_status);
+}
+
+
+/**
+  Queue the parts of a batch for the prefetch threads
+
+  @retval false  The batch is queued, and must be given to release() when
+                 the worker is done with the event
+  @retval true   Error, the batch is not queued
+*/
+
+bool Rpl_rows_prefetch::submit(Rows_prefetch_batch *batch)
+{
+  mysql_mutex_lock(&LOCK_rows_prefetch);
+  if (m_stop || start_threads(batch->parts))
+  {
+    mysql_mutex_unlock(&LOCK_rows_prefetch);
+    return true;
+  }
+  for (uint i= 0; i < batch->parts; i++)
+  {
+    Rows_prefetch_batch::Part *part= batch->part + i;
+    if (!part->keys.elements)
+      continue;
+    batch->refs.fetch_add(1, std::memory_order_relaxed);
+    part->next= NULL;
+    *m_queue_last= part;
+    m_queue_last= &part->next;
+  }
+  mysql_cond_broadcast(&COND_rows_prefetch);
+  mysql_mutex_unlock(&LOCK_rows_prefetch);
+  return false;
+}
+
+
+/* Stop prefetching a batch, and drop the reference of the worker */
+
+void Rpl_rows_prefetch::release(Rows_prefetch_batch *batch)
+{
+  if (!batch)
+    return;
+  DBUG_EXECUTE_IF("rpl_rows_prefetch_wait",
+                  while (batch->refs.load() > 1)
+                    my_sleep(1000););
+  batch->cancelled.store(true, std::memory_order_relaxed);
+  batch->unref();
+}
+
+#endif /* HAVE_REPLICATION */
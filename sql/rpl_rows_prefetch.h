@@ -0,0 +1,116 @@
+/*
+   Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef RPL_ROWS_PREFETCH_H
+#define RPL_ROWS_PREFETCH_H
+
+/*
+  Read-ahead of the rows changed by large row events on the slave.
+
+  All rows of a transaction are changed by one worker thread, in one
+  storage engine transaction that cannot be shared with other threads. For
+  a DELETE or UPDATE rows event with many rows, much of the time of the
+  worker goes to waiting for the pages of the rows to be read from disk.
+
+  With --slave-rows-prefetch-threads=N, the worker first copies the key that
+  find_row() will use for each before image, partitions the keys on their
+  hash into N parts, and queues the parts for N prefetch threads. These
+  look the rows up in their own READ UNCOMMITTED transactions, which take
+  no row locks, so that the pages are in the buffer pool by the time the
+  worker gets to the rows. The prefetch stops when the worker is done with
+  the event.
+*/
+
+#ifdef HAVE_REPLICATION
+#include <atomic>
+
+extern ulong opt_slave_rows_prefetch_threads;
+
+/* Events with fewer rows than this are not prefetched */
+static constexpr uint ROWS_PREFETCH_MIN_ROWS= 100;
+
+struct TABLE;
+class THD;
+
+/* The keys of the rows of one rows event */
+class Rows_prefetch_batch
+{
+public:
+  struct Part
+  {
+    Rows_prefetch_batch *batch;
+    Part *next;
+    DYNAMIC_ARRAY keys;
+  };
+
+  Rows_prefetch_batch(TABLE *table, uint keynr, uint parts);
+  ~Rows_prefetch_batch();
+  bool init();
+  bool add(const uchar *key);
+  void unref()
+  {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      delete this;
+  }
+
+  LEX_CSTRING db, table_name;
+  uchar tabledef_version[MY_UUID_SIZE];
+  size_t tabledef_version_length;
+  KEY *key_info;                /* Only used by the worker */
+  Part *part;
+  uint keynr, key_length, parts;
+  ulong rows;
+  /* The worker and every part queued hold a reference */
+  std::atomic<uint> refs;
+  /* Set when the worker is done with the event */
+  std::atomic<bool> cancelled;
+
+private:
+  char db_buf[NAME_LEN + 1];
+  char table_name_buf[NAME_LEN + 1];
+};
+
+
+/* The prefetch threads */
+class Rpl_rows_prefetch
+{
+public:
+  Rpl_rows_prefetch();
+  void init();
+  void stop();
+  void destroy();
+  bool submit(Rows_prefetch_batch *batch);
+  void release(Rows_prefetch_batch *batch);
+  void run(THD *thd);
+  void thread_exit();
+
+private:
+  bool start_threads(uint count);
+  void prefetch(THD *thd, Rows_prefetch_batch::Part *part);
+
+  mysql_mutex_t LOCK_rows_prefetch;
+  mysql_cond_t COND_rows_prefetch;
+  Rows_prefetch_batch::Part *m_queue, **m_queue_last;
+  uint m_threads;
+  bool m_stop;
+  bool m_inited;
+};
+
+extern Rpl_rows_prefetch rpl_rows_prefetch;
+
+#endif /* HAVE_REPLICATION */
+#endif /* RPL_ROWS_PREFETCH_H */
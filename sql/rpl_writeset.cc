@@ -0,0 +1,311 @@
+/*
+   Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#include "mariadb.h"
+#include "sql_priv.h"
+#include "mysqld.h"
+#include "table.h"
+#include "key.h"                                // key_copy, key_hashnr
+#include "rpl_writeset.h"
+
+ulong opt_binlog_dependency_tracking= BINLOG_DEPENDENCY_TRACKING_COMMIT_ORDER;
+ulong opt_binlog_dependency_history_size= 25000;
+
+Rpl_writeset_history rpl_writeset_history;
+
+
+Rpl_writeset::Rpl_writeset()
+  :m_keys(PSI_INSTRUMENT_MEM, 0, 64)
+{
+  reset();
+}
+
+
+void Rpl_writeset::reset()
+{
+  if (m_keys.elements() > 1024)
+    m_keys.free_memory();
+  m_keys.clear();
+  /*
+    Rows changed while the tracking was off are not in the writeset, so a
+    transaction only gets one if the tracking was on when it started.
+  */
+  m_valid= opt_binlog_dependency_tracking ==
+           BINLOG_DEPENDENCY_TRACKING_WRITESET;
+}
+
+
+void Rpl_writeset::invalidate()
+{
+  m_valid= false;
+  m_keys.clear();
+}
+
+
+/*
+  Hash a key value. The table and key number are included, so that equal
+  values in different keys do not conflict.
+*/
+
+static ulonglong writeset_hash(TABLE *table, uint keynr, const uchar *key)
+{
+  KEY *key_info= table->key_info + keynr;
+  uchar buff[8];
+  Hasher hasher;
+  int4store(buff, keynr);
+  int4store(buff + 4, key_hashnr(key_info, key_info->user_defined_key_parts,
+                                 key));
+  hasher.add(&my_charset_bin, table->s->table_cache_key.str,
+             table->s->table_cache_key.length);
+  hasher.add(&my_charset_bin, buff, sizeof(buff));
+  return hasher.finalize();
+}
+
+
+/*
+  Check that all parts of a key have a value in the row. With
+  binlog_row_image=MINIMAL or NOBLOB, or when applying such row events,
+  the columns that were not read or written hold defaults or the bytes
+  of an earlier row.
+*/
+
+static bool key_in_row(TABLE *table, KEY *key_info, bool after_image)
+{
+  for (uint j= 0; j < key_info->user_defined_key_parts; j++)
+  {
+    uint fieldnr= key_info->key_part[j].fieldnr - 1;
+    if (!bitmap_is_set(table->read_set, fieldnr) &&
+        !(after_image && table->rpl_write_set &&
+          bitmap_is_set(table->rpl_write_set, fieldnr)))
+      return false;
+  }
+  return true;
+}
+
+
+/**
+  Add the unique key values of a row to the writeset
+
+  @param table        Table the row belongs to
+  @param record       Row, in the format of table->record[0]
+  @param after_image  The row is the after image of an insert or update,
+                      so the columns in rpl_write_set have a value too
+*/
+
+void Rpl_writeset::add_row(TABLE *table, const uchar *record,
+                           bool after_image)
+{
+  uchar key[MAX_KEY_LENGTH];
+  uint unique_keys= 0;
+
+  if (!m_valid)
+    return;
+  /*
+    Rows in other tables that refer to this one, or that this one refers
+    to, are not in the writeset, and neither are the values of long unique
+    keys.
+  */
+  if (opt_binlog_dependency_tracking != BINLOG_DEPENDENCY_TRACKING_WRITESET ||
+      table->s->long_unique_table || !table->file->can_switch_engines())
+  {
+    invalidate();
+    return;
+  }
+
+  for (uint i= 0; i < table->s->keys; i++)
+  {
+    KEY *key_info= table->key_info + i;
+    bool null_value= false;
+    if (!(key_info->flags & HA_NOSAME))
+      continue;
+    if (!key_in_row(table, key_info, after_image))
+    {
+      invalidate();
+      return;
+    }
+    unique_keys++;
+    /* A NULL value does not conflict with anything */
+    for (uint j= 0; j < key_info->user_defined_key_parts; j++)
+    {
+      KEY_PART_INFO *key_part= key_info->key_part + j;
+      if (key_part->null_bit &&
+          (record[key_part->null_offset] & key_part->null_bit))
+        null_value= true;
+    }
+    if (null_value)
+      continue;
+    key_copy(key, record, key_info, 0);
+    if (m_keys.append(writeset_hash(table, i, key)))
+    {
+      invalidate();
+      return;
+    }
+  }
+
+  if (!unique_keys || m_keys.elements() > opt_binlog_dependency_history_size)
+    invalidate();
+}
+
+
+Rpl_writeset_history::Rpl_writeset_history()
+  :m_entries(NULL), m_size(0), m_used(0), m_max_used(0),
+   m_barrier_seq_no(0), m_last_seq_no(0), m_domain_id(0), m_active(false)
+{
+}
+
+
+void Rpl_writeset_history::init()
+{
+  mysql_mutex_init(key_LOCK_writeset_history, &LOCK_writeset_history,
+                   MY_MUTEX_INIT_FAST);
+}
+
+
+void Rpl_writeset_history::destroy()
+{
+  my_free(m_entries);
+  m_entries= NULL;
+  m_size= 0;
+  mysql_mutex_destroy(&LOCK_writeset_history);
+}
+
+
+void Rpl_writeset_history::clear(uint64 barrier_seq_no)
+{
+  if (m_used)
+    bzero(m_entries, m_size * sizeof(Entry));
+  m_used= 0;
+  m_barrier_seq_no= barrier_seq_no;
+}
+
+
+/*
+  Make the hash table fit @@binlog_transaction_dependency_history_size
+  entries at no more than half full
+*/
+
+bool Rpl_writeset_history::resize()
+{
+  ulong size= 16;
+  while (size < opt_binlog_dependency_history_size * 2)
+    size<<= 1;
+  if (size != m_size)
+  {
+    Entry *entries= (Entry*) my_malloc(PSI_INSTRUMENT_ME,
+                                       size * sizeof(Entry),
+                                       MYF(MY_ZEROFILL));
+    if (!entries)
+      return true;
+    my_free(m_entries);
+    m_entries= entries;
+    m_size= size;
+    m_used= 0;
+  }
+  m_max_used= opt_binlog_dependency_history_size;
+  return false;
+}
+
+
+/**
+  Forget all writesets. Called when the dependency tracking is changed, as
+  the transactions binlogged meanwhile are not in the history.
+*/
+
+void Rpl_writeset_history::reset()
+{
+  mysql_mutex_lock(&LOCK_writeset_history);
+  m_active= false;
+  mysql_mutex_unlock(&LOCK_writeset_history);
+}
+
+
+/**
+  Find the last transaction that a transaction being binlogged depends on,
+  and add its writeset to the history.
+
+  @param writeset    Writeset of the transaction, NULL if it has none
+  @param domain_id   Replication domain of the transaction
+  @param seq_no      GTID seq_no of the transaction
+  @param depends_on  Set to the seq_no of the last earlier transaction in
+                     the domain that changed a row with the same key value
+
+  @retval false  *depends_on is set
+  @retval true   The dependency is not known, and the transaction must be
+                 assumed to depend on all earlier transactions
+*/
+
+bool Rpl_writeset_history::get_dependency(const Rpl_writeset *writeset,
+                                          uint32 domain_id, uint64 seq_no,
+                                          uint64 *depends_on)
+{
+  bool res= true;
+  mysql_mutex_lock(&LOCK_writeset_history);
+
+  /*
+    The history is only kept for one domain. It is started again when the
+    domain changes or the seq_no goes backwards.
+  */
+  uint64 prev_seq_no= m_last_seq_no;
+  if (!m_active || m_domain_id != domain_id || seq_no <= m_last_seq_no)
+  {
+    if (resize())
+      goto end;
+    clear(seq_no);
+    m_domain_id= domain_id;
+    m_active= true;
+    m_last_seq_no= seq_no;
+    goto end;
+  }
+  m_last_seq_no= seq_no;
+
+  if (!writeset || !writeset->is_valid() ||
+      m_max_used != opt_binlog_dependency_history_size)
+  {
+    if (m_max_used != opt_binlog_dependency_history_size && resize())
+    {
+      m_active= false;
+      goto end;
+    }
+    clear(seq_no);
+    goto end;
+  }
+
+  if (m_used + writeset->elements() > m_max_used)
+    clear(prev_seq_no);
+
+  *depends_on= m_barrier_seq_no;
+  for (size_t i= 0; i < writeset->elements(); i++)
+  {
+    ulonglong key= writeset->at(i) ? writeset->at(i) : 1;
+    ulong pos= (ulong) key & (m_size - 1);
+    while (m_entries[pos].key && m_entries[pos].key != key)
+      pos= (pos + 1) & (m_size - 1);
+    if (m_entries[pos].key)
+      set_if_bigger(*depends_on, m_entries[pos].seq_no);
+    else
+    {
+      m_entries[pos].key= key;
+      m_used++;
+    }
+    m_entries[pos].seq_no= seq_no;
+  }
+  res= false;
+
+end:
+  mysql_mutex_unlock(&LOCK_writeset_history);
+  return res;
+}
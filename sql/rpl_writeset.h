@@ -0,0 +1,106 @@
+/*
+   Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+*/
+
+#ifndef RPL_WRITESET_H
+#define RPL_WRITESET_H
+
+#include "sql_array.h"
+
+/*
+  Writeset based dependency tracking for parallel replication.
+
+  With --binlog-transaction-dependency-tracking=WRITESET, the hashes of the
+  unique key values of all rows changed by a transaction (its writeset) are
+  collected while the rows are binlogged. When the GTID event is written,
+  the writeset is looked up in the history of recently binlogged writesets,
+  giving the seq_no of the last earlier transaction in the same replication
+  domain that changed one of the same rows. This is stored in the GTID event
+  (Gtid_log_event::FL_EXTRA_WRITESET), and the parallel slave can start the
+  transaction in parallel with everything after that one.
+
+  A transaction gets no writeset if it changes a table without a unique
+  key, a table with foreign keys, if it contains anything but row events,
+  or if it changes more rows than the history can hold.
+*/
+
+enum enum_binlog_dependency_tracking
+{
+  BINLOG_DEPENDENCY_TRACKING_COMMIT_ORDER= 0,
+  BINLOG_DEPENDENCY_TRACKING_WRITESET= 1
+};
+
+extern ulong opt_binlog_dependency_tracking;
+extern ulong opt_binlog_dependency_history_size;
+
+struct TABLE;
+
+/* The writeset of the transaction in one binlog cache */
+class Rpl_writeset
+{
+public:
+  Rpl_writeset();
+  void reset();
+  void add_row(TABLE *table, const uchar *record, bool after_image);
+  bool is_valid() const { return m_valid; }
+  size_t elements() const { return m_keys.elements(); }
+  ulonglong at(size_t i) const { return m_keys.at(i); }
+
+private:
+  void invalidate();
+  Dynamic_array<ulonglong> m_keys;
+  bool m_valid;
+};
+
+
+/* The writesets of the last transactions written to the binlog */
+class Rpl_writeset_history
+{
+public:
+  Rpl_writeset_history();
+  void init();
+  void destroy();
+  bool get_dependency(const Rpl_writeset *writeset, uint32 domain_id,
+                      uint64 seq_no, uint64 *depends_on);
+  void reset();
+
+private:
+  struct Entry
+  {
+    ulonglong key;
+    uint64 seq_no;
+  };
+  void clear(uint64 barrier_seq_no);
+  bool resize();
+
+  mysql_mutex_t LOCK_writeset_history;
+  Entry *m_entries;
+  ulong m_size;                 /* Number of slots, a power of 2 */
+  ulong m_used;
+  ulong m_max_used;
+  /*
+    Every transaction depends at least on this one, as the history does
+    not know about the transactions before it.
+  */
+  uint64 m_barrier_seq_no;
+  uint64 m_last_seq_no;
+  uint32 m_domain_id;
+  bool m_active;                /* m_domain_id and m_barrier_seq_no are set */
+};
+
+extern Rpl_writeset_history rpl_writeset_history;
+
+#endif /* RPL_WRITESET_H */
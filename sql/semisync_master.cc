@@ -68,10 +68,32 @@ static ulonglong timespec_to_usec(const struct timespec *ts)
   return (ulonglong) ts->tv_sec * TIME_MILLION + ts->tv_nsec / TIME_THOUSAND;
 }
 
-static int
-signal_waiting_transaction(THD *waiting_thd, bool thd_valid,
-                           const char *binlog_file, my_off_t binlog_pos)
+static void add_wait_time(const struct timespec &start_ts)
 {
+  int wait_time= get_wait_time(start_ts);
+  if (wait_time < 0)
+    rpl_semi_sync_master_timefunc_fails++;
+  else
+  {
+    rpl_semi_sync_master_trx_wait_num++;
+    rpl_semi_sync_master_trx_wait_time+= wait_time;
+  }
+}
+
+/*
+  Wake up the thread waiting in commit_trx() for a transaction removed from
+  Active_tranx. Called under LOCK_binlog.
+
+  The waiter sleeps on its own THD::LOCK_wakeup_ready, not on LOCK_binlog,
+  and its status counters are updated here. So when one ACK covers many
+  transactions, the threads woken up return without queueing up on
+  LOCK_binlog one after the other.
+*/
+
+static void wake_waiting_transaction(Tranx_node *node,
+                                     enum_semi_sync_wakeup reason)
+{
+  THD *waiting_thd= node->thd;
   /*
     It is possible that the connection thd waiting for an ACK was killed. In
     such circumstance, the connection thread will nullify the thd member of its
@@ -81,8 +103,32 @@ signal_waiting_transaction(THD *waiting_thd, bool thd_valid,
     is defensive coding to not signal an invalid THD if we somewhere
     accidentally did not remove the transaction from the list.
   */
-  if (waiting_thd && thd_valid)
-    mysql_cond_signal(&waiting_thd->COND_wakeup_ready);
+  if (!waiting_thd || !node->thd_valid)
+    return;
+
+  add_wait_time(node->wait_start);
+  if (reason == SEMI_SYNC_WAKEUP_ACK)
+    rpl_semi_sync_master_yes_transactions++;
+  rpl_semi_sync_master_wait_sessions--;
+  node->thd_valid= false;
+
+  mysql_mutex_lock(&waiting_thd->LOCK_wakeup_ready);
+  waiting_thd->semi_sync_wakeup= reason;
+  mysql_cond_signal(&waiting_thd->COND_wakeup_ready);
+  mysql_mutex_unlock(&waiting_thd->LOCK_wakeup_ready);
+}
+
+/* The transaction is acknowledged by a slave */
+static int signal_waiting_transaction(Tranx_node *node)
+{
+  wake_waiting_transaction(node, SEMI_SYNC_WAKEUP_ACK);
+  return 0;
+}
+
+/* The transaction will not be acknowledged, e.g. semi-sync is switched off */
+static int clear_waiting_transaction(Tranx_node *node)
+{
+  wake_waiting_transaction(node, SEMI_SYNC_WAKEUP_CLEAR);
   return 0;
 }
 
@@ -269,8 +315,7 @@ void Active_tranx::clear_active_tranx_nodes(
     if ((log_file_name != NULL) &&
         compare(new_front, log_file_name, log_file_pos) > 0)
       break;
-    pre_delete_hook(new_front->thd, new_front->thd_valid,
-                    new_front->log_name, new_front->log_pos);
+    pre_delete_hook(new_front);
     new_front = new_front->next;
   }
 
@@ -585,7 +630,7 @@ void Repl_semi_sync_master::remove_slave()
     */
     DBUG_ASSERT(m_active_tranxs);
     m_active_tranxs->clear_active_tranx_nodes(NULL, 0,
-                                              signal_waiting_transaction);
+                                              clear_waiting_transaction);
   }
   unlock();
 }
@@ -887,6 +932,7 @@ int Repl_semi_sync_master::commit_trx(const char *trx_wait_binlog_name,
     struct timespec start_ts;
     struct timespec abstime;
     int wait_result;
+    uint8 wakeup;
     PSI_stage_info old_stage;
     THD *thd= current_thd;
     bool aborted __attribute__((unused)) = 0;
@@ -896,10 +942,6 @@ int Repl_semi_sync_master::commit_trx(const char *trx_wait_binlog_name,
     /* Acquire the mutex. */
     lock();
 
-    /* This must be called after acquired the lock */
-    THD_ENTER_COND(thd, &thd->COND_wakeup_ready, &LOCK_binlog,
-                   &stage_waiting_for_semi_sync_ack_from_slave, &old_stage);
-
     /* This is the real check inside the mutex. */
     if (!get_master_enabled() || !is_on())
       goto l_end;
@@ -979,6 +1021,8 @@ int Repl_semi_sync_master::commit_trx(const char *trx_wait_binlog_name,
         that might leave a dangling THD in the list.
       */
       tranx_entry->thd_valid= true;
+      tranx_entry->wait_start= start_ts;
+      thd->semi_sync_wakeup= SEMI_SYNC_WAKEUP_NONE;
 
       /* Let us update the info about the minimum binlog position of waiting
        * threads.
@@ -1027,9 +1071,46 @@ int Repl_semi_sync_master::commit_trx(const char *trx_wait_binlog_name,
                               m_wait_file_name, (ulong)m_wait_file_pos));
 
       create_timeout(&abstime, &start_ts);
-      wait_result= mysql_cond_timedwait(&thd->COND_wakeup_ready, &LOCK_binlog,
-                                        &abstime);
-      rpl_semi_sync_master_wait_sessions--;
+      unlock();
+
+      /*
+        Sleep on our own mutex, so that the ACK receiver does not have to
+        hand LOCK_binlog over to every thread it wakes up.
+      */
+      mysql_mutex_lock(&thd->LOCK_wakeup_ready);
+      THD_ENTER_COND(thd, &thd->COND_wakeup_ready, &thd->LOCK_wakeup_ready,
+                     &stage_waiting_for_semi_sync_ack_from_slave, &old_stage);
+      wait_result= 0;
+      while (!thd->semi_sync_wakeup && !wait_result && !thd_killed(thd))
+        wait_result= mysql_cond_timedwait(&thd->COND_wakeup_ready,
+                                          &thd->LOCK_wakeup_ready, &abstime);
+      wakeup= thd->semi_sync_wakeup;
+      THD_EXIT_COND(thd, &old_stage);
+
+      if (wakeup == SEMI_SYNC_WAKEUP_ACK)
+      {
+        /* The ACK receiver has updated the status counters */
+        DBUG_RETURN(0);
+      }
+
+      lock();
+      /* The ACK may have come after the timeout or kill */
+      if (thd->semi_sync_wakeup == SEMI_SYNC_WAKEUP_ACK)
+      {
+        unlock();
+        DBUG_RETURN(0);
+      }
+
+      if (thd->semi_sync_wakeup == SEMI_SYNC_WAKEUP_NONE)
+      {
+        /* We are still in Active_tranx, so nobody has counted this wait */
+        if (m_active_tranxs)
+          m_active_tranxs->unlink_thd_as_waiter(trx_wait_binlog_name,
+                                                trx_wait_binlog_pos);
+        rpl_semi_sync_master_wait_sessions--;
+        if (!wait_result)
+          add_wait_time(start_ts);
+      }
 
       if (wait_result != 0)
       {
@@ -1046,45 +1127,29 @@ int Repl_semi_sync_master::commit_trx(const char *trx_wait_binlog_name,
       }
       else
       {
-        int wait_time;
-
-        wait_time = get_wait_time(start_ts);
-        if (wait_time < 0)
-        {
-          DBUG_PRINT("semisync", ("Replication semi-sync getWaitTime fail at "
-                                  "wait position (%s, %lu)",
-                                  trx_wait_binlog_name,
-                                  (ulong)trx_wait_binlog_pos));
-          rpl_semi_sync_master_timefunc_fails++;
-        }
-        else
-        {
-          rpl_semi_sync_master_trx_wait_num++;
-          rpl_semi_sync_master_trx_wait_time += wait_time;
-
-          DBUG_EXECUTE_IF("testing_cond_var_per_thd", {
-            /*
-              DBUG log warning to ensure we have either recieved our ACK; or
-              have timed out and are awoken in an off state. Test
-              rpl.rpl_semi_sync_cond_var_per_thd scans the logs to ensure this
-              warning is not present.
-            */
-            bool valid_wakeup=
-                (!get_master_enabled() || !is_on() || thd->is_killed() ||
-                 0 <= Active_tranx::compare(
-                          m_reply_file_name, m_reply_file_pos,
-                          trx_wait_binlog_name, trx_wait_binlog_pos));
-            if (!valid_wakeup)
-            {
-              sql_print_warning(
-                  "Thread awaiting semi-sync ACK was awoken before its "
-                  "ACK. THD (%llu), Wait coord: (%s, %llu), ACK coord: (%s, "
-                  "%llu)",
-                  thd->thread_id, trx_wait_binlog_name, trx_wait_binlog_pos,
-                  m_reply_file_name, m_reply_file_pos);
-            }
-          });
-        }
+        DBUG_EXECUTE_IF("testing_cond_var_per_thd", {
+          /*
+            DBUG log warning to ensure we have either recieved our ACK; or
+            have timed out and are awoken in an off state. Test
+            rpl.rpl_semi_sync_cond_var_per_thd scans the logs to ensure this
+            warning is not present.
+          */
+          bool valid_wakeup=
+              (!get_master_enabled() || !is_on() || thd->is_killed() ||
+               !rpl_semi_sync_master_clients ||
+               0 <= Active_tranx::compare(
+                        m_reply_file_name, m_reply_file_pos,
+                        trx_wait_binlog_name, trx_wait_binlog_pos));
+          if (!valid_wakeup)
+          {
+            sql_print_warning(
+                "Thread awaiting semi-sync ACK was awoken before its "
+                "ACK. THD (%llu), Wait coord: (%s, %llu), ACK coord: (%s, "
+                "%llu)",
+                thd->thread_id, trx_wait_binlog_name, trx_wait_binlog_pos,
+                m_reply_file_name, m_reply_file_pos);
+          }
+        });
       }
     }
 
@@ -1114,9 +1179,7 @@ int Repl_semi_sync_master::commit_trx(const char *trx_wait_binlog_name,
     else
       rpl_semi_sync_master_no_transactions++;
 
-    /* The lock held will be released by thd_exit_cond, so no need to
-       call unlock() here */
-    THD_EXIT_COND(thd, &old_stage);
+    unlock();
   }
 
   DBUG_RETURN(0);
@@ -1147,7 +1210,7 @@ void Repl_semi_sync_master::switch_off()
   /* Clear the active transaction list. */
   if (m_active_tranxs)
     m_active_tranxs->clear_active_tranx_nodes(NULL, 0,
-                                              signal_waiting_transaction);
+                                              clear_waiting_transaction);
 
   if (m_state)
   {
@@ -1214,9 +1277,33 @@ int Repl_semi_sync_master::reserve_sync_header(String* packet)
   DBUG_RETURN(0);
 }
 
+/*
+  Events that are never the last event of a transaction, so that no thread
+  can wait for an ACK of their position
+*/
+
+static bool never_ends_transaction(uint event_type)
+{
+  switch (event_type) {
+  case GTID_EVENT:
+  case ANNOTATE_ROWS_EVENT:
+  case TABLE_MAP_EVENT:
+  case INTVAR_EVENT:
+  case RAND_EVENT:
+  case USER_VAR_EVENT:
+  case PARTIAL_ROW_DATA_EVENT:
+    return true;
+  default:
+    return LOG_EVENT_IS_WRITE_ROW((Log_event_type) event_type) ||
+           LOG_EVENT_IS_UPDATE_ROW((Log_event_type) event_type) ||
+           LOG_EVENT_IS_DELETE_ROW((Log_event_type) event_type);
+  }
+}
+
 int Repl_semi_sync_master::update_sync_header(THD* thd, unsigned char *packet,
                                               const char *log_file_name,
                                               my_off_t log_file_pos,
+                                              uint event_type,
                                               bool* need_sync)
 {
   int  cmp = 0;
@@ -1232,6 +1319,20 @@ int Repl_semi_sync_master::update_sync_header(THD* thd, unsigned char *packet,
     DBUG_RETURN(0);
   }
 
+  /*
+    While semi-sync is on, only the events ending a transaction are waited
+    for, so the other events are sent without taking LOCK_binlog. They make
+    most of the events of a transaction, and the dump thread would otherwise
+    compete with the committing threads for the mutex on each of them. If
+    is_on() is read stale, at worst a reply for switching semi-sync on is
+    requested at a later event.
+  */
+  if (is_on() && never_ends_transaction(event_type))
+  {
+    *need_sync = false;
+    DBUG_RETURN(0);
+  }
+
   lock();
 
   /* This is the real check inside the mutex. */
@@ -28,11 +28,22 @@ extern PSI_mutex_key key_LOCK_binlog;
 extern PSI_cond_key key_COND_binlog_send;
 #endif
 
+/* Why a thread waiting for a semi-sync ACK was woken up */
+enum enum_semi_sync_wakeup
+{
+  SEMI_SYNC_WAKEUP_NONE= 0,
+  /* The transaction is acknowledged */
+  SEMI_SYNC_WAKEUP_ACK,
+  /* The transaction was removed without an ACK, e.g. semi-sync is off */
+  SEMI_SYNC_WAKEUP_CLEAR
+};
+
 struct Tranx_node {
   char              log_name[FN_REFLEN];
   bool              thd_valid;             /* thd is valid for signalling */
   my_off_t          log_pos;
   THD               *thd;                   /* The thread awaiting an ACK */
+  struct timespec   wait_start;      /* When thd started to wait for an ACK */
   struct Tranx_node *next;            /* the next node in the sorted list */
   struct Tranx_node *hash_next;    /* the next node during hash collision */
 };
@@ -293,7 +304,7 @@ class Tranx_node_allocator
 };
 
 /**
-  Function pointer type to run on the contents of an Active_tranx node.
+  Function pointer type to run on an Active_tranx node.
 
   Return 0 for success, 1 for error.
 
@@ -301,9 +312,7 @@ class Tranx_node_allocator
   its invocation. See the context in which it is called to know.
 */
 
-typedef int (*active_tranx_action)(THD *trx_thd, bool thd_valid,
-                                   const char *log_file_name,
-                                   my_off_t trx_log_file_pos);
+typedef int (*active_tranx_action)(Tranx_node *node);
 
 /**
    This class manages memory for active transaction list.
@@ -653,6 +662,7 @@ class Repl_semi_sync_master
    *  packet        - (IN)  the packet containing the replication event
    *  log_file_name - (IN)  the event ending position's file name
    *  log_file_pos  - (IN)  the event ending position's file offset
+   *  event_type    - (IN)  type of the event
    *  need_sync     - (IN)  identify if flush_net is needed to call.
    *  server_id     - (IN)  master server id number
    *
@@ -662,6 +672,7 @@ class Repl_semi_sync_master
   int update_sync_header(THD* thd, unsigned char *packet,
                          const char *log_file_name,
                          my_off_t log_file_pos,
+                         uint event_type,
                          bool* need_sync);
 
   /* Called when a transaction finished writing binlog events.
@@ -63,6 +63,8 @@ Master_info_index *master_info_index;
 
 #include "rpl_tblmap.h"
 #include "rpl_parallel.h"
+#include "rpl_rows_prefetch.h"
+#include "rpl_event_decode.h"
 #include "sql_show.h"
 #include "semisync_slave.h"
 #include "sql_manager.h"
@@ -665,6 +667,8 @@ int init_slave()
 
   if (global_rpl_thread_pool.init(opt_slave_parallel_threads))
     return 1;
+  rpl_rows_prefetch.init();
+  rpl_event_decoder.init();
 
   slave_background_thread_gtid_loaded= false;
   mysql_manager_submit(bg_rpl_load_gtid_slave_state, NULL);
@@ -1403,6 +1407,8 @@ void slave_prepare_for_shutdown()
   // It's safe to destruct worker pool now when
   // all driver threads are gone.
   global_rpl_thread_pool.deactivate();
+  rpl_rows_prefetch.stop();
+  rpl_event_decoder.stop();
 }
 
 /*
@@ -1436,6 +1442,8 @@ void end_slave()
   stop_slave_deadlock_handler_thread();
 
   global_rpl_thread_pool.destroy();
+  rpl_rows_prefetch.destroy();
+  rpl_event_decoder.destroy();
   free_all_rpl_filters();
   DBUG_VOID_RETURN;
 }
@@ -5696,7 +5704,8 @@ pthread_handler_t handle_slave_sql(void *arg)
   DBUG_ASSERT(rli->slave_running == MYSQL_SLAVE_RUN_NOT_CONNECT); // tracking buffer overrun
   /* When master_pos_wait() wakes up it will check this and terminate */
   rli->slave_running= MYSQL_SLAVE_NOT_RUN;
-  /* Forget the relay log's format */
+  /* Forget the events read ahead, and the relay log's format */
+  rli->decode_ahead.clear();
   delete rli->relay_log.description_event_for_sql_thread;
   rli->relay_log.description_event_for_sql_thread= 0;
   rli->reset_inuse_relaylog();
@@ -7221,6 +7230,21 @@ static Log_event* next_event(rpl_group_info *rgi, ulonglong *event_size)
 
   while (!sql_slave_killed(rgi))
   {
+    if (rli->decode_ahead.pending())
+    {
+      /* The event was read together with an earlier one */
+      const char *error;
+      my_off_t end_pos;
+      if (!(ev= rli->decode_ahead.next_event(&end_pos, event_size, &error)))
+      {
+        sql_print_error("Error in Log_event::read_log_event(): '%s'", error);
+        errmsg= "slave SQL thread aborted because of I/O error";
+        goto err;
+      }
+      rli->future_event_relay_log_pos= end_pos;
+      DBUG_RETURN(ev);
+    }
+
     /*
       We can have two kinds of log reading:
       hot_log:
@@ -7284,16 +7308,26 @@ static Log_event* next_event(rpl_group_info *rgi, ulonglong *event_size)
     */
     old_pos= rli->event_relay_log_pos;
     int error;
-    if ((ev= Log_event::read_log_event(cur_log, &error,
+    my_off_t end_pos;
+    if (opt_slave_parallel_decode_threads && rli->mi->using_parallel())
+      ev= rli->decode_ahead.read_event(cur_log, &error,
                                        rli->relay_log.description_event_for_sql_thread,
-                                       opt_slave_sql_verify_checksum)))
-
+                                       opt_slave_sql_verify_checksum,
+                                       &end_pos);
+    else
+    {
+      ev= Log_event::read_log_event(cur_log, &error,
+                                    rli->relay_log.description_event_for_sql_thread,
+                                    opt_slave_sql_verify_checksum);
+      end_pos= my_b_tell(cur_log);
+    }
+    if (ev)
     {
       /*
         read it while we have a lock, to avoid a mutex lock in
         inc_event_relay_log_pos()
       */
-      rli->future_event_relay_log_pos= my_b_tell(cur_log);
+      rli->future_event_relay_log_pos= end_pos;
       *event_size= rli->future_event_relay_log_pos - old_pos;
 
       if (hot_log)
@@ -10222,6 +10222,7 @@ int TABLE::unlock_hlindexes()
 {
   if (hlindex && hlindex->in_use)
   {
+    (void) hlindexes_end_bulk_insert(true); // only if not ended on error
     hlindex->file->ha_external_unlock(in_use);
     hlindex->in_use= 0;
   }
@@ -10237,6 +10238,32 @@ int TABLE::hlindexes_on_insert()
   return 0;
 }
 
+/*
+  Insert the following rows into empty hlindexes all at once, at
+  hlindexes_end_bulk_insert(). For ALTER TABLE and LOAD DATA
+*/
+int TABLE::hlindexes_start_bulk_insert()
+{
+  DBUG_ASSERT(s->hlindexes() == (hlindex != NULL));
+  if (hlindex && hlindex->in_use)
+    if (int err= mhnsw_start_bulk_insert(this, key_info + s->keys))
+      return err;
+  return 0;
+}
+
+/*
+  @param abort  discard the rows inserted since hlindexes_start_bulk_insert(),
+                when the statement is rolled back
+*/
+int TABLE::hlindexes_end_bulk_insert(bool abort)
+{
+  DBUG_ASSERT(s->hlindexes() == (hlindex != NULL));
+  if (hlindex && hlindex->in_use)
+    if (int err= mhnsw_end_bulk_insert(this, abort))
+      return err;
+  return 0;
+}
+
 int TABLE::hlindexes_on_update()
 {
   DBUG_ASSERT(s->hlindexes() == (hlindex != NULL));
@@ -10271,7 +10298,12 @@ int TABLE::hlindexes_on_delete_all(bool truncate)
   return 0;
 }
 
-int TABLE::hlindex_read_first(uint nr, Item *item, ulonglong limit)
+/*
+  @param cond  WHERE condition that depends only on this table, to return
+               only rows that satisfy it, or NULL
+*/
+int TABLE::hlindex_read_first(uint nr, Item *item, ulonglong limit,
+                              Item *cond)
 {
   DBUG_ASSERT(s->hlindexes() == 1);
   DBUG_ASSERT(nr == s->keys);
@@ -10281,7 +10313,7 @@ int TABLE::hlindex_read_first(uint nr, Item *item, ulonglong limit)
 
   DBUG_ASSERT(hlindex->in_use == in_use);
 
-  return mhnsw_read_first(this, key_info + s->keys, item, limit);
+  return mhnsw_read_first(this, key_info + s->keys, item, limit, cond);
 }
 
 int TABLE::hlindex_read_next()
@@ -61,6 +61,7 @@
 #include "wsrep_mysqld.h"
 #include "sql_connect.h"
 #include "sql_cursor.h"                         //Select_materialize
+#include "sql_prepare.h"                       // query_template_cache_free
 #ifdef WITH_WSREP
 #include "wsrep_thd.h"
 #include "wsrep_trans_observer.h"
@@ -847,7 +848,7 @@ THD::THD(my_thread_id id, bool is_wsrep_applier)
   */
   init_sql_alloc(key_memory_thd_main_mem_root,
                  &main_mem_root, DEFAULT_ROOT_BLOCK_SIZE, 0,
-                 MYF(MY_THREAD_SPECIFIC));
+                 MYF(MY_THREAD_SPECIFIC | MY_ROOT_USE_BLOCK_CACHE));
 
   /*
     Allocation of user variables for binary logging is always done with main
@@ -892,6 +893,7 @@ THD::THD(my_thread_id id, bool is_wsrep_applier)
   query_id= 0;
   query_name_consts= 0;
   semisync_info= 0;
+  semi_sync_wakeup= 0;
 
 #ifndef DBUG_OFF
   expected_semi_sync_offs= 0;
@@ -1611,6 +1613,7 @@ void THD::change_user(void)
   /* cannot clear map if it'll free the currently executing statement */
   DBUG_ASSERT(stmt_arena->is_conventional());
   stmt_map.reset();
+  query_template_cache_free(this);
   my_hash_init(key_memory_user_var_entry, &user_vars,
                Lex_ident_user_var::charset_info(),
                USER_VARS_HASH_SIZE, 0, 0, get_var_key, free_user_var,
@@ -1778,6 +1781,7 @@ void THD::cleanup(void)
 
   mysql_ull_cleanup(this);
   stmt_map.reset();
+  query_template_cache_free(this);
   /* All metadata locks must have been released by now. */
   DBUG_ASSERT(!mdl_context.has_locks());
 
@@ -1821,6 +1825,7 @@ void THD::free_connection()
   main_security_ctx.destroy();
   /* close all prepared statements, to save memory */
   stmt_map.reset();
+  query_template_cache_free(this);
   free_connection_done= 1;
 #if defined(ENABLED_PROFILING)
   profiling.restart();                          // Reset profiling
@@ -4903,6 +4908,22 @@ void TMP_TABLE_PARAM::init()
 }
 
 
+void TMP_TABLE_PARAM::cleanup()
+{
+  if (copy_field)				/* Fix for Intel compiler */
+  {
+    delete [] copy_field;
+    copy_field= NULL;
+    copy_field_end= NULL;
+  }
+  if (group_hash)
+  {
+    delete group_hash;
+    group_hash= NULL;
+  }
+}
+
+
 void thd_increment_bytes_sent(void *thd, size_t length)
 {
   /* thd == 0 when close_connection() calls net_send_error() */
@@ -378,8 +378,16 @@ class Key_part_spec :public Sql_alloc {
   Lex_ident_column field_name;
   uint length;
   bool generated, asc;
+  /*
+    The expression of a key part like KEY ((a + b)). field_name is empty
+    until mysql_prepare_create_table() adds a hidden column for it.
+  */
+  Virtual_column_info *expr;
   Key_part_spec(const LEX_CSTRING *name, uint len, bool gen= false)
-    : field_name(*name), length(len), generated(gen), asc(1)
+    : field_name(*name), length(len), generated(gen), asc(1), expr(NULL)
+  {}
+  Key_part_spec(Virtual_column_info *expr_arg)
+    : length(0), generated(false), asc(1), expr(expr_arg)
   {}
   bool operator==(const Key_part_spec& other) const;
   /**
@@ -901,6 +909,7 @@ typedef struct system_variables
   uint in_subquery_conversion_threshold;
   uint log_slow_max_query_length;
   uint max_open_cursors;
+  uint query_template_cache_size;
   int max_user_connections;
 
   /**
@@ -919,6 +928,7 @@ typedef struct system_variables
   my_bool binlog_annotate_row_events;
   my_bool binlog_direct_non_trans_update;
   my_bool column_compression_zlib_wrap;
+  my_bool tmp_memory_table_blobs;
   my_bool sysdate_is_now;
   my_bool wsrep_on;
   my_bool wsrep_dirty_reads;
@@ -996,6 +1006,8 @@ typedef struct system_status_var
   ulong com_stmt_fetch;
   ulong com_stmt_reset;
   ulong com_stmt_close;
+  ulong query_template_cache_hits;
+  ulong query_template_cache_misses;
 
   ulong com_register_slave;
   ulong created_tmp_disk_tables_;
@@ -1056,6 +1068,7 @@ typedef struct system_status_var
   ulong filesort_scan_count_;
   ulong filesort_pq_sorts_;
   ulong optimizer_join_prefixes_check_calls;
+  ulong vector_index_bulk_builds;   /* +1 when a vector index is built in bulk */
 
   /* Features used */
   ulong feature_custom_aggregate_functions; /* +1 when custom aggregate
@@ -3438,6 +3451,9 @@ class THD: public THD_count, /* this must be first */
   Statement *last_stmt;
   Statement *cur_stmt= 0;
 
+  /* Statements prepared from query templates, see query_template_cache_size */
+  class Query_template_cache *query_template_cache= 0;
+
   inline void set_last_stmt(Statement *stmt)
   { last_stmt= (is_error() ? NULL : stmt); }
   inline void clear_last_stmt() { last_stmt= NULL; }
@@ -3555,6 +3571,13 @@ class THD: public THD_count, /* this must be first */
 
   /* If this is a semisync slave connection. */
   bool semi_sync_slave;
+  /*
+    Why a thread waiting for a semi-sync ACK in
+    Repl_semi_sync_master::commit_trx() was woken up, see
+    enum_semi_sync_wakeup. Set under both Repl_semi_sync_master::LOCK_binlog
+    and LOCK_wakeup_ready.
+  */
+  uint8 semi_sync_wakeup;
   /* Several threads may share this thd. Used with parallel repair */
   bool shared_thd;
   /*
@@ -6055,10 +6078,9 @@ class THD: public THD_count, /* this must be first */
     Flag, mutex and condition for a thread to wait for a signal from another
     thread.
 
-    Currently used to wait for group commit to complete, and COND_wakeup_ready
-    is used for threads to wait on semi-sync ACKs (though is protected by
-    Repl_semi_sync_master::LOCK_binlog). Note the following relationships
-    between these two use-cases when using
+    Currently used to wait for group commit to complete, and for threads to
+    wait on semi-sync ACKs (see semi_sync_wakeup). Note the following
+    relationships between these two use-cases when using
     rpl_semi_sync_master_wait_point=AFTER_SYNC during group commit:
       1) Non-leader threads use COND_wakeup_ready to wait for the leader thread
          to complete binlog commit.
@@ -7038,6 +7060,8 @@ class TMP_TABLE_PARAM :public Sql_alloc
     TRUE <=> create_tmp_table will create only the TABLE structure.
   */
   bool skip_create_table;
+  /* In-memory hash table used by end_update(), if any */
+  class Group_by_hash *group_hash;
 
   TMP_TABLE_PARAM()
     :copy_field(0), group_parts(0),
@@ -7045,7 +7069,8 @@ class TMP_TABLE_PARAM :public Sql_alloc
      using_outer_summary_function(0),
      schema_table(0), materialized_subquery(0), force_not_null_cols(0),
      precomputed_group_by(0), group_concat(0),
-     force_copy_fields(0), bit_fields_as_long(0), skip_create_table(0)
+     force_copy_fields(0), bit_fields_as_long(0), skip_create_table(0),
+     group_hash(0)
   {
     init();
   }
@@ -7054,15 +7079,7 @@ class TMP_TABLE_PARAM :public Sql_alloc
     cleanup();
   }
   void init(void);
-  inline void cleanup(void)
-  {
-    if (copy_field)				/* Fix for Intel compiler */
-    {
-      delete [] copy_field;
-      copy_field= NULL;
-      copy_field_end= NULL;
-    }
-  }
+  void cleanup(void);
 };
 
 
@@ -33,6 +33,21 @@
   impact in the case when the cache is not applicable)
 */
 #define EXPCACHE_CHECK_HIT_RATIO_AFTER 200
+/**
+  Initial number of slots of the Expression_cache_hash hash table
+  (must be a power of 2)
+*/
+#define EXPCACHE_HASH_INITIAL_SIZE 64
+/**
+  Number of counters to estimate how often a set of parameters was missed
+  (must be a power of 2)
+*/
+#define EXPCACHE_FREQUENCY_COUNTERS 4096
+/**
+  Number of misses after which a set of parameters is put into the cache
+  once the cache has been full
+*/
+#define EXPCACHE_MIN_FREQUENCY_TO_ADMIT 2
 
 /*
   Expression cache is used only for caching subqueries now, so its statistic
@@ -137,6 +152,15 @@ void Expression_cache_tmptable::init()
     DBUG_PRINT("error", ("we need only heap table"));
     goto error;
   }
+  /* Heap tables can store blobs but not index them */
+  for (uint i= 1; i < items.elements; i++)
+  {
+    if (cache_table->field[i]->flags & BLOB_FLAG)
+    {
+      DBUG_PRINT("error", ("blob parameter"));
+      goto error;
+    }
+  }
 
   field_counter= 1;
 
@@ -344,5 +368,647 @@ void Expression_cache_tmptable::print(String *str, enum_query_type query_type)
 }
 
 
+/**
+  Entry of the Expression_cache_hash hash table: the packed parameters
+  followed by the result
+*/
+
+struct Expression_cache_hash::Entry
+{
+  ulonglong hash;
+  uint key_length;
+  uint result_length;
+  bool result_null;
+
+  uchar *key() { return (uchar*) (this + 1); }
+  uchar *result() { return key() + key_length; }
+};
+
+
+Expression_cache_hash::Expression_cache_hash(THD *thd_arg,
+                                             List<Item> &dependants,
+                                             Item *value)
+  :thd(thd_arg), tmptable(NULL), tracker(NULL), items(dependants), val(value),
+   key_parts(NULL), key_part_count(0), slots(NULL), size(0), records(0),
+   memory_used(0), memory_limit(0), frequency(NULL),
+   admission_control(FALSE), key_hash(0), key_null(FALSE),
+   result_type(INT_RESULT), result_precision(0), result_scale(0),
+   result_item(NULL), null_result_item(NULL), hit(0), miss(0), inited(FALSE)
+{
+  DBUG_ENTER("Expression_cache_hash::Expression_cache_hash");
+  init_alloc_root(PSI_INSTRUMENT_ME, &entry_root, 4096, 0,
+                  MYF(MY_THREAD_SPECIFIC));
+  DBUG_VOID_RETURN;
+}
+
+
+Expression_cache_hash::~Expression_cache_hash()
+{
+  /* Add accumulated statistics */
+  statistic_add(subquery_cache_miss, miss, &LOCK_status);
+  statistic_add(subquery_cache_hit, hit, &LOCK_status);
+
+  if (tmptable)
+    delete tmptable;                  // Detaches the tracker from the cache
+  else
+  {
+    update_tracker();
+    if (tracker)
+      tracker->detach_from_cache();
+  }
+  tracker= NULL;
+  my_free(slots);
+  my_free(frequency);
+  free_root(&entry_root, MYF(0));
+}
+
+
+/**
+  Disable cache
+*/
+
+void Expression_cache_hash::disable_cache()
+{
+  my_free(slots);
+  slots= NULL;
+  my_free(frequency);
+  frequency= NULL;
+  free_root(&entry_root, MYF(0));
+  size= records= 0;
+  update_tracker();
+  if (tracker)
+    tracker->detach_from_cache();
+}
+
+
+/**
+  Describe how the parameters of the expression are packed into the key
+
+  @retval FALSE OK
+  @retval TRUE  Some parameter can't be hashed, or out of memory
+*/
+
+bool Expression_cache_hash::init_key_parts()
+{
+  List_iterator_fast<Item> li(items);
+  Item *item;
+  Key_part *part;
+
+  if (!(key_parts= part= (Key_part*) thd->alloc(sizeof(Key_part) *
+                                                items.elements)))
+    return TRUE;
+  for (; (item= li++); part++)
+  {
+    if (!item->type_handler()->is_traditional_scalar_type())
+      return TRUE;
+    part->length= 8;
+    switch (item->cmp_type()) {
+    case INT_RESULT:
+      part->type= PART_INT;
+      break;
+    case REAL_RESULT:
+      part->type= PART_REAL;
+      break;
+    case DECIMAL_RESULT:
+      part->type= PART_DECIMAL;
+      part->precision= item->decimal_precision();
+      part->scale= item->decimals;
+      part->length= my_decimal_get_binary_size(part->precision, part->scale);
+      break;
+    case STRING_RESULT:
+      part->type= PART_STRING;
+      part->charset= item->collation.collation;
+      break;
+    case TIME_RESULT:
+      /* TIMESTAMP values are compared in UTC */
+      if (item->field_type() == MYSQL_TYPE_TIMESTAMP)
+        return TRUE;
+      part->type= (item->field_type() == MYSQL_TYPE_TIME ?
+                   PART_TIME : PART_DATETIME);
+      break;
+    case ROW_RESULT:
+      return TRUE;
+    }
+  }
+  key_part_count= items.elements;
+  return FALSE;
+}
+
+
+/**
+  Create the items returning the cached results
+
+  @details
+  Only results that can be returned by a basic constant without any change
+  of their value and metadata are supported.
+
+  @retval FALSE OK
+  @retval TRUE  The result can't be cached, or out of memory
+*/
+
+bool Expression_cache_hash::init_result()
+{
+  if (!val->type_handler()->is_traditional_scalar_type())
+    return TRUE;
+  switch (val->field_type()) {
+  case MYSQL_TYPE_TINY:
+  case MYSQL_TYPE_SHORT:
+  case MYSQL_TYPE_INT24:
+  case MYSQL_TYPE_LONG:
+  case MYSQL_TYPE_LONGLONG:
+    result_type= INT_RESULT;
+    if (!(result_item= new (thd->mem_root) Item_int(thd, (longlong) 0,
+                                                    val->max_length)))
+      return TRUE;
+    result_item->unsigned_flag= val->unsigned_flag;
+    break;
+  case MYSQL_TYPE_NEWDECIMAL:
+    result_type= DECIMAL_RESULT;
+    result_precision= val->decimal_precision();
+    result_scale= val->decimals;
+    if (!(result_item= new (thd->mem_root) Item_decimal(thd, (longlong) 0,
+                                                        FALSE)))
+      return TRUE;
+    break;
+  case MYSQL_TYPE_VARCHAR:
+  case MYSQL_TYPE_VAR_STRING:
+  case MYSQL_TYPE_TINY_BLOB:
+  case MYSQL_TYPE_MEDIUM_BLOB:
+  case MYSQL_TYPE_BLOB:
+  case MYSQL_TYPE_LONG_BLOB:
+    result_type= STRING_RESULT;
+    if (!(result_item= new (thd->mem_root) Item_string(thd, "", (size_t) 0,
+                                                       val->collation.collation)))
+      return TRUE;
+    break;
+  default:
+    return TRUE;
+  }
+  return !(null_result_item= new (thd->mem_root) Item_null(thd));
+}
+
+
+/**
+  Initialize the hash table for the expression cache
+
+  @details
+  If the parameters or the result of the expression are of types that
+  are not supported, the cache is done by Expression_cache_tmptable.
+*/
+
+void Expression_cache_hash::init()
+{
+  DBUG_ENTER("Expression_cache_hash::init");
+  DBUG_ASSERT(!inited);
+  inited= TRUE;
+
+  if (items.elements == 0)
+  {
+    DBUG_PRINT("info", ("All parameters were removed by optimizer."));
+    DBUG_VOID_RETURN;
+  }
+
+  if (init_key_parts() || init_result())
+  {
+    DBUG_PRINT("info", ("types can't be hashed, using a temporary table"));
+    if ((tmptable= new Expression_cache_tmptable(thd, items, val)))
+    {
+      tmptable->set_tracker(tracker);
+      tmptable->init();
+    }
+    DBUG_VOID_RETURN;
+  }
+
+  memory_limit= MY_MIN(thd->variables.tmp_memory_table_size,
+                       thd->variables.max_heap_table_size);
+  if (!memory_limit)
+  {
+    DBUG_PRINT("info", ("in-memory temporary tables are disabled"));
+    update_tracker();
+    DBUG_VOID_RETURN;
+  }
+
+  if (!(frequency= (uchar*) my_malloc(PSI_INSTRUMENT_ME,
+                                      EXPCACHE_FREQUENCY_COUNTERS,
+                                      MYF(MY_THREAD_SPECIFIC | MY_ZEROFILL))) ||
+      resize(EXPCACHE_HASH_INITIAL_SIZE))
+  {
+    DBUG_PRINT("error", ("allocating the hash table failed"));
+    disable_cache();
+    DBUG_VOID_RETURN;
+  }
+  memory_used+= EXPCACHE_FREQUENCY_COUNTERS;
+
+  update_tracker();
+  DBUG_VOID_RETURN;
+}
+
+
+/**
+  Change the number of slots of the hash table
+
+  @retval FALSE OK
+  @retval TRUE  Out of memory
+*/
+
+bool Expression_cache_hash::resize(uint new_size)
+{
+  Entry **new_slots;
+  if (!(new_slots= (Entry**) my_malloc(PSI_INSTRUMENT_ME,
+                                       new_size * sizeof(Entry*),
+                                       MYF(MY_THREAD_SPECIFIC | MY_ZEROFILL))))
+    return TRUE;
+  for (uint i= 0; i < size; i++)
+  {
+    if (Entry *entry= slots[i])
+    {
+      uint idx= (uint) entry->hash & (new_size - 1);
+      while (new_slots[idx])
+        idx= (idx + 1) & (new_size - 1);
+      new_slots[idx]= entry;
+    }
+  }
+  my_free(slots);
+  memory_used= memory_used + new_size * sizeof(Entry*) - size * sizeof(Entry*);
+  slots= new_slots;
+  size= new_size;
+  return FALSE;
+}
+
+
+/**
+  Remove all entries from the cache
+
+  @details
+  From now on a set of parameters is only put into the cache if it was
+  missed before, so that the frequent ones stay in the cache. The
+  counters of misses are halved to follow changes of the distribution
+  of the parameters.
+*/
+
+void Expression_cache_hash::flush()
+{
+  bzero(slots, size * sizeof(Entry*));
+  free_root(&entry_root, MYF(MY_MARK_BLOCKS_FREE));
+  memory_used= size * sizeof(Entry*) + EXPCACHE_FREQUENCY_COUNTERS;
+  records= 0;
+  for (uint i= 0; i < EXPCACHE_FREQUENCY_COUNTERS; i++)
+    frequency[i]>>= 1;
+  admission_control= TRUE;
+}
+
+
+/**
+  Pack the current values of the parameters into key_buff and calculate
+  their hash value
+
+  @retval FALSE OK
+  @retval TRUE  The parameters can't be cached (NULL value or error)
+*/
+
+bool Expression_cache_hash::pack_key()
+{
+  List_iterator_fast<Item> li(items);
+  Key_part *part= key_parts;
+  Hasher hasher;
+  Item *item;
+
+  key_buff.length(0);
+  for (; (item= li++); part++)
+  {
+    uchar buff[8];
+    switch (part->type) {
+    case PART_INT:
+      int8store(buff, item->val_int());
+      break;
+    case PART_REAL:
+    {
+      double nr= item->val_real();
+      if (nr == 0.0)
+        nr= 0.0;                                // -0.0 is equal to 0.0
+      float8store(buff, nr);
+      break;
+    }
+    case PART_TIME:
+      int8store(buff, item->val_time_packed(thd));
+      break;
+    case PART_DATETIME:
+      int8store(buff, item->val_datetime_packed(thd));
+      break;
+    case PART_DECIMAL:
+    {
+      my_decimal decimal_buff, *dec= item->val_decimal(&decimal_buff);
+      uchar *pos;
+      if (item->null_value || key_buff.reserve(part->length))
+        return TRUE;
+      pos= (uchar*) key_buff.ptr() + key_buff.length();
+      if (dec->to_binary(pos, part->precision, part->scale, 0) &
+          ~E_DEC_TRUNCATED)
+        return TRUE;
+      hasher.add(&my_charset_bin, pos, part->length);
+      key_buff.length(key_buff.length() + part->length);
+      continue;
+    }
+    case PART_STRING:
+    {
+      String *str= item->val_str(&tmp_value);
+      if (item->null_value)
+        return TRUE;
+      int4store(buff, (uint32) str->length());
+      if (key_buff.append((char*) buff, 4) ||
+          key_buff.append(str->ptr(), str->length()))
+        return TRUE;
+      hasher.add(part->charset, str->ptr(), str->length());
+      continue;
+    }
+    }
+    if (item->null_value || key_buff.append((char*) buff, 8))
+      return TRUE;
+    hasher.add(&my_charset_bin, buff, 8);
+  }
+  key_hash= hasher.finalize();
+  return FALSE;
+}
+
+
+/**
+  Compare two packed keys
+*/
+
+bool Expression_cache_hash::key_eq(const uchar *key1, const uchar *key2) const
+{
+  const Key_part *part= key_parts, *end= key_parts + key_part_count;
+  for (; part < end; part++)
+  {
+    if (part->type == PART_STRING)
+    {
+      size_t length1= uint4korr(key1), length2= uint4korr(key2);
+      if (my_ci_strnncollsp(part->charset, key1 + 4, length1,
+                            key2 + 4, length2))
+        return FALSE;
+      key1+= 4 + length1;
+      key2+= 4 + length2;
+    }
+    else
+    {
+      if (memcmp(key1, key2, part->length))
+        return FALSE;
+      key1+= part->length;
+      key2+= part->length;
+    }
+  }
+  return TRUE;
+}
+
+
+/**
+  Find the slot of a key, or the empty slot where it should be put
+*/
+
+Expression_cache_hash::Entry **
+Expression_cache_hash::find_slot(const uchar *key, ulonglong hash)
+{
+  uint idx= (uint) hash & (size - 1);
+  Entry *entry;
+  while ((entry= slots[idx]) &&
+         (entry->hash != hash || !key_eq(entry->key(), key)))
+    idx= (idx + 1) & (size - 1);
+  return slots + idx;
+}
+
+
+/**
+  Get the item returning the result stored in a cache entry
+*/
+
+Item *Expression_cache_hash::restore_result(Entry *entry)
+{
+  if (entry->result_null)
+    return null_result_item;
+  switch (result_type) {
+  case INT_RESULT:
+    ((Item_int*) result_item)->value= sint8korr(entry->result());
+    break;
+  case DECIMAL_RESULT:
+  {
+    my_decimal dec(entry->result(), result_precision, result_scale);
+    ((Item_decimal*) result_item)->set_decimal_value(&dec);
+    break;
+  }
+  default:
+    DBUG_ASSERT(result_type == STRING_RESULT);
+    result_item->str_value.set((const char*) entry->result(),
+                               entry->result_length,
+                               val->collation.collation);
+    break;
+  }
+  return result_item;
+}
+
+
+/**
+  Check if a given set of parameters of the expression is in the cache
+
+  @param [out] value     the expression value found in the cache if any
+
+  @retval Expression_cache::HIT if the set of parameters is in the cache
+  @retval Expression_cache::MISS - otherwise
+  @retval Expression_cache::ERROR - error evaluating the parameters
+*/
+
+Expression_cache::result Expression_cache_hash::check_value(Item **value)
+{
+  Entry *entry;
+  DBUG_ENTER("Expression_cache_hash::check_value");
+
+  if (tmptable)
+    DBUG_RETURN(tmptable->check_value(value));
+  if (!slots)
+    DBUG_RETURN(Expression_cache::MISS);
+
+  if (!(key_null= pack_key()) &&
+      (entry= *find_slot((uchar*) key_buff.ptr(), key_hash)))
+  {
+    hit++;
+    *value= restore_result(entry);
+    DBUG_RETURN(Expression_cache::HIT);
+  }
+  if (unlikely(thd->is_error()))
+    DBUG_RETURN(Expression_cache::ERROR);
+
+  if (((++miss) == EXPCACHE_CHECK_HIT_RATIO_AFTER) &&
+      ((double)hit / ((double)hit + miss)) <
+      EXPCACHE_MIN_HIT_RATE_FOR_MEM_TABLE)
+  {
+    DBUG_PRINT("info",
+               ("Early check: hit rate is not so good to keep the cache"));
+    disable_cache();
+  }
+  else if (!key_null)
+  {
+    uchar *counter= frequency + ((key_hash >> 32) &
+                                 (EXPCACHE_FREQUENCY_COUNTERS - 1));
+    if (*counter < UCHAR_MAX)
+      (*counter)++;
+  }
+  DBUG_RETURN(Expression_cache::MISS);
+}
+
+
+/**
+  Put a new entry into the expression cache
+
+  @param value     the result of the expression to be put into the cache
+
+  @details
+  The function puts the value into the cache as the result of the
+  expression for the set of parameters of the preceding check_value().
+  The hash table grows until it reaches the memory limit of in-memory
+  temporary tables. Then the cache is either disabled if the hit rate is
+  bad, or emptied and used only for frequent sets of parameters.
+
+  @retval FALSE OK
+  @retval TRUE  Error
+*/
+
+my_bool Expression_cache_hash::put_value(Item *value)
+{
+  uchar decimal_buff[DECIMAL_MAX_FIELD_SIZE];
+  my_decimal decimal_value;
+  String *str= NULL;
+  longlong nr= 0;
+  size_t result_length= 0, entry_length;
+  Entry *entry, **slot;
+  DBUG_ENTER("Expression_cache_hash::put_value");
+  DBUG_ASSERT(inited);
+
+  if (tmptable)
+    DBUG_RETURN(tmptable->put_value(value));
+  if (!slots || key_null)
+  {
+    DBUG_PRINT("info", ("Not cached so behave as we successfully put value"));
+    DBUG_RETURN(FALSE);
+  }
+  if (admission_control &&
+      frequency[(key_hash >> 32) & (EXPCACHE_FREQUENCY_COUNTERS - 1)] <
+      EXPCACHE_MIN_FREQUENCY_TO_ADMIT)
+  {
+    DBUG_PRINT("info", ("Parameters are not frequent enough to be cached"));
+    DBUG_RETURN(FALSE);
+  }
+
+  switch (result_type) {
+  case INT_RESULT:
+    nr= value->val_int();
+    result_length= 8;
+    break;
+  case DECIMAL_RESULT:
+  {
+    my_decimal *dec= value->val_decimal(&decimal_value);
+    result_length= my_decimal_get_binary_size(result_precision,
+                                              result_scale);
+    if (!value->null_value &&
+        (dec->to_binary(decimal_buff, result_precision, result_scale, 0) &
+         ~E_DEC_TRUNCATED))
+      DBUG_RETURN(FALSE);
+    break;
+  }
+  default:
+    if ((str= value->val_str(&tmp_value)))
+      result_length= str->length();
+    break;
+  }
+  if (unlikely(thd->is_error()))
+  {
+    disable_cache();
+    DBUG_RETURN(TRUE);
+  }
+  if (value->null_value)
+    result_length= 0;
+
+  entry_length= ALIGN_SIZE(sizeof(Entry) + key_buff.length() + result_length);
+  if (records >= size / 2 &&
+      memory_used + entry_length + size * sizeof(Entry*) <= memory_limit)
+  {
+    /* Grow the hash table while it fits into the memory limit */
+    if (resize(size * 2))
+    {
+      disable_cache();
+      DBUG_RETURN(FALSE);
+    }
+  }
+  if (records >= size / 2 || memory_used + entry_length > memory_limit)
+  {
+    double hit_rate= ((double)hit / ((double)hit + miss));
+    DBUG_ASSERT(miss > 0);
+    if (hit_rate < EXPCACHE_MIN_HIT_RATE_FOR_MEM_TABLE)
+    {
+      DBUG_PRINT("info", ("hit rate is not so good to keep the cache"));
+      disable_cache();
+      DBUG_RETURN(FALSE);
+    }
+    DBUG_PRINT("info", ("cache is full, keep only frequent parameters"));
+    flush();
+    if (memory_used + entry_length > memory_limit)
+      DBUG_RETURN(FALSE);
+  }
+
+  if (!(entry= (Entry*) alloc_root(&entry_root, entry_length)))
+  {
+    disable_cache();
+    DBUG_RETURN(FALSE);
+  }
+  entry->hash= key_hash;
+  entry->key_length= key_buff.length();
+  entry->result_length= (uint) result_length;
+  entry->result_null= value->null_value;
+  memcpy(entry->key(), key_buff.ptr(), key_buff.length());
+  if (!entry->result_null)
+  {
+    switch (result_type) {
+    case INT_RESULT:
+      int8store(entry->result(), nr);
+      break;
+    case DECIMAL_RESULT:
+      memcpy(entry->result(), decimal_buff, result_length);
+      break;
+    default:
+      memcpy(entry->result(), str->ptr(), result_length);
+      break;
+    }
+  }
+
+  slot= find_slot(entry->key(), key_hash);
+  DBUG_ASSERT(!*slot);
+  *slot= entry;
+  records++;
+  memory_used+= entry_length;
+  DBUG_RETURN(FALSE);
+}
+
+
+void Expression_cache_hash::print(String *str, enum_query_type query_type)
+{
+  List_iterator<Item> li(items);
+  Item *item;
+  bool is_first= TRUE;
+
+  if (tmptable)
+  {
+    tmptable->print(str, query_type);
+    return;
+  }
+  str->append('<');
+  while ((item= li++))
+  {
+    if (!is_first)
+      str->append(',');
+    item->print(str, query_type);
+    is_first= FALSE;
+  }
+  str->append('>');
+}
+
+
 const char *Expression_cache_tracker::state_str[3]=
 {"uninitialized", "disabled", "enabled"};
@@ -31,6 +31,8 @@
 
 extern ulong subquery_cache_miss, subquery_cache_hit;
 
+class Expression_cache_tracker;
+
 class Expression_cache :public Sql_alloc
 {
 public:
@@ -68,6 +70,11 @@ class Expression_cache :public Sql_alloc
     Save this object's statistics into Expression_cache_tracker object
   */
   virtual void update_tracker()= 0;
+
+  /**
+    Set the object to save EXPLAIN/ANALYZE statistics into
+  */
+  virtual void set_tracker(Expression_cache_tracker *st)= 0;
 };
 
 struct st_table_ref;
@@ -120,7 +127,7 @@ class Expression_cache_tmptable :public Expression_cache
   bool is_inited() override { return inited; };
   void init() override;
 
-  void set_tracker(Expression_cache_tracker *st)
+  void set_tracker(Expression_cache_tracker *st) override
   {
     tracker= st;
     update_tracker();
@@ -161,4 +168,122 @@ class Expression_cache_tmptable :public Expression_cache
   bool inited;
 };
 
+
+/**
+  Implementation of expression cache over an in-memory hash table
+
+  @details
+  The values of the parameters are packed into a key which is looked up
+  in an open addressing hash table, so no temporary table has to be
+  created. The table starts small and grows with the number of distinct
+  parameter sets up to the size limit of in-memory temporary tables.
+  When the limit is reached the cache is either switched off (bad hit
+  rate) or emptied, and from then on only parameter sets that were seen
+  before are admitted, so that the most frequent ones stay cached.
+
+  Expressions that have parameters or a result of a type that can't be
+  hashed or restored from the cache use Expression_cache_tmptable.
+*/
+
+class Expression_cache_hash :public Expression_cache
+{
+public:
+  Expression_cache_hash(THD *thd, List<Item> &dependants, Item *value);
+  virtual ~Expression_cache_hash();
+  result check_value(Item **value) override;
+  my_bool put_value(Item *value) override;
+
+  void print(String *str, enum_query_type query_type) override;
+  bool is_inited() override { return inited; };
+  void init() override;
+
+  void set_tracker(Expression_cache_tracker *st) override
+  {
+    tracker= st;
+    if (tmptable)
+      tmptable->set_tracker(st);
+    else
+      update_tracker();
+  }
+  void update_tracker() override
+  {
+    if (tmptable)
+      tmptable->update_tracker();
+    else if (tracker)
+    {
+      tracker->set(hit, miss, (inited ? (slots ?
+                                         Expression_cache_tracker::OK :
+                                         Expression_cache_tracker::STOPPED) :
+                               Expression_cache_tracker::UNINITED));
+    }
+  }
+
+private:
+  /* Type of a packed parameter value */
+  enum key_part_type {PART_INT, PART_REAL, PART_DECIMAL, PART_STRING,
+                      PART_TIME, PART_DATETIME};
+  struct Key_part
+  {
+    key_part_type type;
+    /* Length in the key, not used for PART_STRING */
+    uint length;
+    decimal_digits_t precision, scale;
+    /* Collation to compare and hash PART_STRING values */
+    CHARSET_INFO *charset;
+  };
+  struct Entry;
+
+  bool init_key_parts();
+  bool init_result();
+  bool pack_key();
+  bool key_eq(const uchar *key1, const uchar *key2) const;
+  Entry **find_slot(const uchar *key, ulonglong hash);
+  Item *restore_result(Entry *entry);
+  bool resize(uint new_size);
+  void flush();
+  void disable_cache();
+
+  /* Thread handle */
+  THD *thd;
+  /* Temporary table cache for types the hash does not support */
+  Expression_cache_tmptable *tmptable;
+  /* EXPALIN/ANALYZE statistics */
+  Expression_cache_tracker *tracker;
+  /* List of parameter items */
+  List<Item> &items;
+  /* Value Item example */
+  Item *val;
+  /* Description of the packed parameters, one per element of items */
+  Key_part *key_parts;
+  uint key_part_count;
+  /* Hash table, NULL if the cache is switched off */
+  Entry **slots;
+  /* Number of slots (a power of 2) and of used slots */
+  uint size, records;
+  /* Memory used by the cache and the maximum allowed */
+  ulonglong memory_used, memory_limit;
+  /* Memory for the entries */
+  MEM_ROOT entry_root;
+  /* Approximate number of misses of every parameter set, by hash value */
+  uchar *frequency;
+  /* Set when the cache was emptied because it reached its size limit */
+  bool admission_control;
+  /* Key of the current parameters and its hash value */
+  String key_buff;
+  ulonglong key_hash;
+  /* Set if the current parameters can't be cached (e.g. are NULL) */
+  bool key_null;
+  /* Buffer to read string parameters and the result */
+  String tmp_value;
+  /* Type of the result and precision/scale of DECIMAL results */
+  Item_result result_type;
+  decimal_digits_t result_precision, result_scale;
+  /* Items returning the result of the expression found in the cache */
+  Item *result_item, *null_result_item;
+  /* hit/miss counters */
+  ulong hit, miss;
+  /* Set on if the object has been successfully initialized with init() */
+  bool inited;
+};
+
 #endif /* SQL_EXPRESSION_CACHE_INCLUDED */
@@ -686,6 +686,11 @@ int mysql_load(THD *thd, const sql_exchange *ex, TABLE_LIST *table_list,
 
     if (prepare_for_replace(table, info.handle_duplicates, info.ignore))
       DBUG_RETURN(1);
+    if (int err= table->hlindexes_start_bulk_insert())
+    {
+      table->file->print_error(err, MYF(0));
+      DBUG_RETURN(1);
+    }
 
     thd_progress_init(thd, 2);
     fix_rownum_pointers(thd, thd->lex->current_select, &info.copied);
@@ -707,6 +712,15 @@ int mysql_load(THD *thd, const sql_exchange *ex, TABLE_LIST *table_list,
                             set_fields, set_values, read_info,
                             *ex->enclosed, skip_lines, ignore);
 
+    /* rows of a non-transactional table stay there on error, index them */
+    if (int err= table->hlindexes_end_bulk_insert(error &&
+                                             table->file->has_transactions()))
+    {
+      if (!error)
+        table->file->print_error(err, MYF(0));
+      error= 1;
+    }
+
     if (unlikely(finalize_replace(table, handle_duplicates, ignore)))
       DBUG_RETURN(1);
 
@@ -7917,9 +7917,12 @@ void mysql_parse(THD *thd, char *rawbuf, uint length,
   {
     LEX *lex= thd->lex;
 
-    bool err= parse_sql(thd, parser_state, NULL, true);
-
-    if (likely(!err))
+    if (thd->variables.query_template_cache_size &&
+        mysql_execute_query_template(thd, rawbuf, length))
+    {
+      /* Executed as a prepared statement from the query template cache */
+    }
+    else if (likely(!parse_sql(thd, parser_state, NULL, true)))
     {
       thd->m_statement_psi=
         MYSQL_REFINE_STATEMENT(thd->m_statement_psi,
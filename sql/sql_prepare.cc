@@ -101,6 +101,7 @@ When one supplies long data for a placeholder:
 #include "sql_derived.h" // mysql_derived_prepare,
                          // mysql_handle_derived
 #include "sql_cte.h"
+#include "sql_connect.h"                        // check_mqh
 #include "sql_cursor.h"
 #include "sql_show.h"
 #include "sql_repl.h"
@@ -174,7 +175,8 @@ class Prepared_statement: public Statement
   enum flag_values
   {
     IS_IN_USE= 1,
-    IS_SQL_PREPARE= 2
+    IS_SQL_PREPARE= 2,
+    IS_QUERY_TEMPLATE= 4
   };
 
   THD *thd;
@@ -225,6 +227,9 @@ class Prepared_statement: public Statement
   inline bool is_in_use() { return flags & (uint) IS_IN_USE; }
   inline bool is_sql_prepare() const { return flags & (uint) IS_SQL_PREPARE; }
   void set_sql_prepare() { flags|= (uint) IS_SQL_PREPARE; }
+  inline bool is_query_template() const
+  { return flags & (uint) IS_QUERY_TEMPLATE; }
+  void set_query_template() { flags|= (uint) IS_QUERY_TEMPLATE; }
   bool prepare(const char *packet, uint packet_length);
   bool execute_loop(String *expanded_query,
                     bool open_cursor,
@@ -3802,6 +3807,589 @@ void mysql_sql_stmt_execute(THD *thd)
 }
 
 
+/***************************************************************************
+  Query template cache
+
+  With query_template_cache_size > 0 a text protocol statement like
+
+    SELECT * FROM t1 WHERE a = 10 AND b IN ('x', 'y')
+
+  is converted to the template
+
+    SELECT * FROM t1 WHERE a = ? AND b IN (?, ?)
+
+  which is prepared once per connection and then executed as a prepared
+  statement with the literals of the query as parameters, as
+  EXECUTE stmt USING 10, 'x', 'y' would do. Statements that only differ in
+  literals, typical for ORMs, then skip parsing and name resolution.
+
+  Only literals after WHERE that are an operand of a comparison or LIKE,
+  or an element of an IN list, are replaced. Literals in the select list
+  of any SELECT of the statement, including subqueries in a select list,
+  are kept. Item names, result metadata and positional ORDER BY / GROUP BY
+  references are thus the same as with normal execution. The statement
+  digest is taken when the template is prepared and given to
+  performance_schema on every execution from the cache. Statements with
+  anything the scanner does not understand (comments, several statements,
+  placeholders...) and templates that give any error or warning on prepare
+  use normal parsing.
+****************************************************************************/
+
+/**
+  A prepared query template, or a template that could not be prepared
+*/
+
+class Query_template
+{
+public:
+  LEX_CSTRING key;
+  Prepared_statement *stmt;             // NULL if it can't be prepared
+  /*
+    Statement digest of the template, taken when it was prepared. It is
+    the same as the digest of the queries, as literals and placeholders
+    are both normalized to '?'.
+  */
+  sql_digest_storage digest;
+
+  Query_template(char *key_arg, size_t key_length, Prepared_statement *stmt_arg)
+   :key({key_arg, key_length}), stmt(stmt_arg)
+  {}
+  ~Query_template()
+  {
+    delete stmt;
+    my_free(digest.m_token_array);
+    my_free(const_cast<char*>(key.str));
+  }
+  void set_digest(const sql_digest_storage *from)
+  {
+    uchar *tokens;
+    if (!from->m_byte_count ||
+        !(tokens= (uchar*) my_malloc(key_memory_prepared_statement_map,
+                                     from->m_byte_count,
+                                     MYF(MY_THREAD_SPECIFIC))))
+      return;
+    digest.reset(tokens, from->m_byte_count);
+    digest.copy(from);
+  }
+};
+
+
+C_MODE_START
+
+static const uchar *get_query_template_key(const void *entry, size_t *length,
+                                           my_bool)
+{
+  const Query_template *templ= static_cast<const Query_template*>(entry);
+  *length= templ->key.length;
+  return reinterpret_cast<const uchar*>(templ->key.str);
+}
+
+static void delete_query_template(void *entry)
+{
+  delete static_cast<Query_template*>(entry);
+}
+
+C_MODE_END
+
+
+class Query_template_cache
+{
+  HASH m_hash;
+public:
+  Query_template_cache()
+  {
+    my_hash_init(key_memory_prepared_statement_map, &m_hash,
+                 &my_charset_bin, 16, 0, 0, get_query_template_key,
+                 delete_query_template, MYF(MY_THREAD_SPECIFIC));
+  }
+  ~Query_template_cache()
+  {
+    my_hash_free(&m_hash);
+  }
+  Query_template *find(const String &key)
+  {
+    return (Query_template*) my_hash_search(&m_hash, (uchar*) key.ptr(),
+                                            key.length());
+  }
+  /*
+    Add a template. Like the stored program cache, the whole cache is
+    flushed when it is full.
+  */
+  Query_template *insert(const String &key, Prepared_statement *stmt,
+                         ulong max_size)
+  {
+    Query_template *templ;
+    char *key_str;
+    if (m_hash.records >= max_size)
+      my_hash_reset(&m_hash);
+    if (!(key_str= (char*) my_memdup(key_memory_prepared_statement_map,
+                                     key.ptr(), key.length(),
+                                     MYF(MY_WME | MY_THREAD_SPECIFIC))))
+    {
+      delete stmt;
+      return NULL;
+    }
+    if (!(templ= new Query_template(key_str, key.length(), stmt)))
+    {
+      my_free(key_str);
+      delete stmt;
+      return NULL;
+    }
+    if (my_hash_insert(&m_hash, (uchar*) templ))
+    {
+      delete templ;
+      return NULL;
+    }
+    return templ;
+  }
+};
+
+
+void query_template_cache_free(THD *thd)
+{
+  delete thd->query_template_cache;
+  thd->query_template_cache= NULL;
+}
+
+
+static inline bool is_template_ident_char(uchar c)
+{
+  return my_isalnum(&my_charset_latin1, c) || c == '_' || c == '$' ||
+         c >= 0x80;
+}
+
+
+/**
+  Replace the literals of a query with placeholders
+
+  @param thd     Thread handle
+  @param query   Query in the client character set
+  @param length  Length of the query
+  @param templ   [OUT] Query with placeholders
+  @param params  [OUT] Literals that were replaced
+
+  @retval false  ok
+  @retval true   The query can't be used as a template, or error
+*/
+
+static bool make_query_template(THD *thd, const char *query, size_t length,
+                                String *templ, List<Item> *params)
+{
+  enum token_type
+  {
+    TOK_OTHER, TOK_WORD, TOK_COMPARISON, TOK_LIKE, TOK_IN, TOK_OPEN,
+    TOK_COMMA, TOK_LITERAL
+  };
+  const char *pos= query, *end= query + length, *copied= query;
+  const bool backslash_escapes=
+    !(thd->variables.sql_mode & MODE_NO_BACKSLASH_ESCAPES);
+  token_type prev= TOK_OTHER;
+  bool first_word= true, after_where= false, in_select_list= false;
+  uint depth= 0, in_list_depth= 0;
+  /* State of the enclosing parentheses, bit N for depth N + 1 */
+  ulonglong outer_after_where= 0, outer_select_list= 0;
+
+  while (pos < end)
+  {
+    const char *start= pos;
+    uchar c= (uchar) *pos;
+    Item *item= NULL;
+
+    if (my_isspace(&my_charset_latin1, c))
+    {
+      pos++;
+      continue;
+    }
+    /* Only SELECT, UPDATE and DELETE are considered */
+    if (first_word && !is_template_ident_char(c))
+      return true;
+
+    if (my_isdigit(&my_charset_latin1, c))
+    {
+      bool is_decimal= false, is_float= false;
+      while (pos < end && my_isdigit(&my_charset_latin1, *pos))
+        pos++;
+      if (pos < end && *pos == '.')
+      {
+        is_decimal= true;
+        for (pos++; pos < end && my_isdigit(&my_charset_latin1, *pos); pos++)
+        {}
+      }
+      if (pos < end && (*pos == 'e' || *pos == 'E'))
+      {
+        const char *exp= pos + 1;
+        if (exp < end && (*exp == '+' || *exp == '-'))
+          exp++;
+        if (exp == end || !my_isdigit(&my_charset_latin1, *exp))
+          return true;
+        is_float= true;
+        for (pos= exp; pos < end && my_isdigit(&my_charset_latin1, *pos);
+             pos++)
+        {}
+      }
+      if (pos < end && is_template_ident_char((uchar) *pos))
+      {
+        /* An identifier starting with digits or a hex/bit literal */
+        if (is_decimal || is_float)
+          return true;
+        while (pos < end && is_template_ident_char((uchar) *pos))
+          pos++;
+        prev= TOK_WORD;
+        continue;
+      }
+      if (after_where && !in_select_list && !outer_select_list &&
+          (prev == TOK_COMPARISON || prev == TOK_LIKE ||
+           (in_list_depth && in_list_depth == depth &&
+            (prev == TOK_OPEN || prev == TOK_COMMA))))
+      {
+        size_t len= (size_t) (pos - start);
+        if (is_float)
+          item= new (thd->mem_root) Item_float(thd, start, len);
+        else if (is_decimal)
+          item= new (thd->mem_root) Item_decimal(thd, start, len,
+                                                 thd->charset());
+        else
+        {
+          int error;
+          char *num_end= (char*) pos;
+          longlong value= my_strtoll10(start, &num_end, &error);
+          if (error)
+            item= new (thd->mem_root) Item_decimal(thd, start, len,
+                                                   thd->charset());
+          else if (value >= 0)
+            item= new (thd->mem_root) Item_int(thd, start, value, len);
+          else
+            item= new (thd->mem_root) Item_uint(thd, start, len);
+        }
+        if (!item)
+          return true;
+      }
+    }
+    else if (c == '\'')
+    {
+      bool is_8bit= false, is_simple= true;
+      for (pos++ ;; pos++)
+      {
+        if (pos >= end)
+          return true;
+        if (*pos == '\\' && backslash_escapes)
+        {
+          is_simple= false;
+          pos++;
+        }
+        else if (*pos == '\'')
+        {
+          if (pos + 1 < end && pos[1] == '\'')
+          {
+            is_simple= false;
+            pos++;
+          }
+          else
+            break;
+        }
+        else if ((uchar) *pos >= 0x80)
+          is_8bit= true;
+      }
+      pos++;                                    // Skip closing quote
+      const char *next= pos;
+      while (next < end && my_isspace(&my_charset_latin1, *next))
+        next++;
+      if (next < end && (*next == '\'' || *next == '"'))
+        return true;                            // 'a' 'b' concatenation
+      if (is_simple && after_where && !in_select_list &&
+          !outer_select_list &&
+          (prev == TOK_COMPARISON || prev == TOK_LIKE ||
+           (in_list_depth && in_list_depth == depth &&
+            (prev == TOK_OPEN || prev == TOK_COMMA))))
+      {
+        Lex_string_with_metadata_st str;
+        str.set(start + 1, (size_t) (pos - start - 2), is_8bit, '\'');
+        if (!(item= thd->make_string_literal(str)))
+          return true;
+      }
+    }
+    else if (c == '"' || c == '`')
+    {
+      /* Quoted identifier or a string that is kept in the template */
+      for (pos++ ;; pos++)
+      {
+        if (pos >= end)
+          return true;
+        if (*pos == '\\' && backslash_escapes && c == '"')
+          pos++;
+        else if (*pos == (char) c)
+        {
+          if (pos + 1 < end && pos[1] == (char) c)
+            pos++;
+          else
+            break;
+        }
+      }
+      pos++;
+      prev= TOK_WORD;
+      continue;
+    }
+    else if (is_template_ident_char(c))
+    {
+      while (pos < end && is_template_ident_char((uchar) *pos))
+        pos++;
+      Lex_ident_ci word(start, (size_t) (pos - start));
+      if (first_word)
+      {
+        if (!word.streq("SELECT"_LEX_CSTRING) &&
+            !word.streq("UPDATE"_LEX_CSTRING) &&
+            !word.streq("DELETE"_LEX_CSTRING))
+          return true;
+        first_word= false;
+      }
+      /*
+        Each SELECT of a UNION or a subquery starts a new select list.
+        Literals in a select list, also in the WHERE of its subqueries,
+        are part of the result column names and are kept.
+      */
+      if (word.streq("SELECT"_LEX_CSTRING))
+      {
+        after_where= false;
+        in_select_list= true;
+      }
+      else if (word.streq("FROM"_LEX_CSTRING))
+        in_select_list= false;
+      else if (word.streq("WHERE"_LEX_CSTRING))
+        after_where= true;
+      prev= word.streq("IN"_LEX_CSTRING) ? TOK_IN :
+            word.streq("LIKE"_LEX_CSTRING) ? TOK_LIKE : TOK_WORD;
+      continue;
+    }
+    else if (c == '<' || c == '>' || c == '=' || c == '!')
+    {
+      while (pos < end && (*pos == '<' || *pos == '>' || *pos == '=' ||
+                           *pos == '!'))
+        pos++;
+      Lex_cstring op(start, pos);
+      prev= (op.bin_eq("="_LEX_CSTRING) || op.bin_eq("<"_LEX_CSTRING) ||
+             op.bin_eq(">"_LEX_CSTRING) || op.bin_eq("<="_LEX_CSTRING) ||
+             op.bin_eq(">="_LEX_CSTRING) || op.bin_eq("<>"_LEX_CSTRING) ||
+             op.bin_eq("!="_LEX_CSTRING) || op.bin_eq("<=>"_LEX_CSTRING)) ?
+            TOK_COMPARISON : TOK_OTHER;
+      continue;
+    }
+    else
+    {
+      switch (c) {
+      case '(':
+        if (depth >= sizeof(outer_after_where) * 8)
+          return true;
+        if (after_where)
+          outer_after_where|= 1ULL << depth;
+        if (in_select_list)
+          outer_select_list|= 1ULL << depth;
+        depth++;
+        if (prev == TOK_IN)
+          in_list_depth= depth;
+        prev= TOK_OPEN;
+        break;
+      case ')':
+        if (!depth)
+          return true;
+        if (in_list_depth == depth)
+          in_list_depth= 0;
+        depth--;
+        after_where= outer_after_where & (1ULL << depth);
+        in_select_list= outer_select_list & (1ULL << depth);
+        outer_after_where&= ~(1ULL << depth);
+        outer_select_list&= ~(1ULL << depth);
+        prev= TOK_OTHER;
+        break;
+      case ',':
+        prev= TOK_COMMA;
+        break;
+      case '-':
+        if (pos + 1 < end && pos[1] == '-')
+          return true;                          // Comment
+        prev= TOK_OTHER;
+        break;
+      case '/':
+        if (pos + 1 < end && pos[1] == '*')
+          return true;                          // Comment or hint
+        prev= TOK_OTHER;
+        break;
+      case ';':
+      case '?':
+      case '#':
+      case '\\':
+        return true;
+      default:
+        prev= TOK_OTHER;
+        break;
+      }
+      pos++;
+      continue;
+    }
+
+    if (item)
+    {
+      if (templ->append(copied, (size_t) (start - copied)) ||
+          templ->append('?') ||
+          params->push_back(item, thd->mem_root))
+        return true;
+      copied= pos;
+    }
+    prev= TOK_LITERAL;
+  }
+  return params->is_empty() ||
+         templ->append(copied, (size_t) (end - copied));
+}
+
+
+/**
+  Make the cache key of a template: the template text and everything that
+  changes the meaning of it on prepare.
+*/
+
+static bool make_query_template_key(THD *thd, const String &templ,
+                                    String *key)
+{
+  char buff[8 + 4 + 4];
+  int8store(buff, thd->variables.sql_mode);
+  int4store(buff + 8, thd->variables.character_set_client->number);
+  int4store(buff + 12, thd->variables.collation_connection->number);
+  return key->append(buff, sizeof(buff)) ||
+         key->append(thd->db.str, thd->db.length) ||
+         key->append('\0') ||
+         key->append(templ);
+}
+
+
+/**
+  Execute a COM_QUERY statement through the query template cache
+
+  @param thd     Thread handle
+  @param query   Query text
+  @param length  Length of the query
+
+  @retval false  The query was not executed. It should be parsed and
+                 executed normally.
+  @retval true   The query was executed (successfully or not)
+*/
+
+bool mysql_execute_query_template(THD *thd, const char *query, size_t length)
+{
+  LEX *lex= thd->lex;
+  CSET_STRING orig_query= thd->query_string;
+  StringBuffer<STRING_BUFFER_USUAL_SIZE * 4> templ(&my_charset_bin);
+  StringBuffer<STRING_BUFFER_USUAL_SIZE * 4> key(&my_charset_bin);
+  List<Item> params;
+  Query_template *entry;
+  Prepared_statement *stmt;
+  Dummy_error_handler error_handler;
+  PSI_digest_locker *digest_locker;
+  bool res;
+  DBUG_ENTER("mysql_execute_query_template");
+
+  if (thd->get_command() != COM_QUERY || thd->slave_thread ||
+      thd->in_sub_stmt || !thd->m_digest ||
+      thd->charset()->escape_with_backslash_is_dangerous ||
+      thd->charset()->mbminlen > 1)
+    DBUG_RETURN(false);
+
+  thd->push_internal_handler(&error_handler);
+  res= make_query_template(thd, query, length, &templ, &params) ||
+       make_query_template_key(thd, templ, &key);
+  thd->pop_internal_handler();
+  if (res || error_handler.any_error())
+    DBUG_RETURN(false);
+
+  if (!thd->query_template_cache &&
+      !(thd->query_template_cache= new Query_template_cache()))
+    DBUG_RETURN(false);
+
+  if (!(entry= thd->query_template_cache->find(key)))
+  {
+    status_var_increment(thd->status_var.query_template_cache_misses);
+    if (!(stmt= new Prepared_statement(thd)))
+      DBUG_RETURN(false);
+    stmt->set_sql_prepare();
+    stmt->set_query_template();
+
+    thd->push_internal_handler(&error_handler);
+    {
+      Item_change_list_savepoint change_list_savepoint(thd);
+      res= stmt->prepare(templ.ptr(), (uint) templ.length());
+      thd->set_query(orig_query);
+      change_list_savepoint.rollback(thd);
+    }
+    thd->pop_internal_handler();
+
+    if (res || error_handler.any_error() ||
+        stmt->param_count != params.elements ||
+        (stmt->lex->sql_command != SQLCOM_SELECT &&
+         stmt->lex->sql_command != SQLCOM_UPDATE &&
+         stmt->lex->sql_command != SQLCOM_UPDATE_MULTI &&
+         stmt->lex->sql_command != SQLCOM_DELETE &&
+         stmt->lex->sql_command != SQLCOM_DELETE_MULTI))
+    {
+      /* Remember that the template can't be used */
+      delete stmt;
+      stmt= NULL;
+    }
+    if (!(entry= thd->query_template_cache->
+                 insert(key, stmt, thd->variables.query_template_cache_size)))
+      stmt= NULL;
+    if (!stmt)
+    {
+      /* The parser will take the digest of the query again */
+      thd->m_digest->m_digest_storage.reset();
+      DBUG_RETURN(false);
+    }
+    entry->set_digest(&thd->m_digest->m_digest_storage);
+  }
+  else if (entry->stmt)
+  {
+    /*
+      Without a cached digest (performance_schema did not want it when
+      the template was prepared) the query is parsed to get it.
+    */
+    digest_locker= MYSQL_DIGEST_START(thd->m_statement_psi);
+    if (digest_locker && entry->digest.is_empty())
+      DBUG_RETURN(false);
+    status_var_increment(thd->status_var.query_template_cache_hits);
+    MYSQL_DIGEST_END(digest_locker, &entry->digest);
+  }
+
+  if (!(stmt= entry->stmt) || stmt->is_in_use())
+    DBUG_RETURN(false);
+
+  lex->sql_command= stmt->lex->sql_command;
+  thd->m_statement_psi=
+    MYSQL_REFINE_STATEMENT(thd->m_statement_psi,
+                           sql_statement_info[lex->sql_command].m_key);
+#ifndef NO_EMBEDDED_ACCESS_CHECKS
+  if (mqh_used && thd->user_connect && check_mqh(thd, lex->sql_command))
+  {
+    thd->net.error= 0;
+    DBUG_RETURN(true);
+  }
+#endif
+
+  lex->prepared_stmt.set(Lex_ident_sys(), NULL, &params);
+  if (lex->prepared_stmt.params_fix_fields(thd))
+    DBUG_RETURN(true);
+
+  /* See comments on thd->free_list in mysql_sql_stmt_execute() */
+  SCOPE_VALUE(thd->free_list, (Item *) NULL);
+  SCOPE_EXIT([thd]() mutable { thd->free_items(); });
+  String expanded_query;
+  Item_change_list_savepoint change_list_savepoint(thd);
+  (void) stmt->execute_loop(&expanded_query, false, &stmt->result,
+                            &stmt->cursor, InstrSlice(0, 0), NULL, NULL);
+  change_list_savepoint.rollback(thd);
+
+  thd->set_query(orig_query);
+  stmt->lex->restore_set_statement_var();
+  DBUG_RETURN(true);
+}
+
+
 int sp_cursor::open_from_ps(THD *thd, const Lex_ident_sys &ps_name)
 {
   DBUG_ENTER("sp_cursor::open_from_ps");
@@ -4517,7 +5105,11 @@ bool Prepared_statement::prepare(const char *packet, uint packet_len)
   lex->context_analysis_only|= CONTEXT_ANALYSIS_ONLY_PREPARE;
 
 
-  error= (parse_sql(thd, & parser_state, NULL) ||
+  /*
+    A query template is prepared within the COM_QUERY statement it is
+    made from, and gives the digest of that statement.
+  */
+  error= (parse_sql(thd, & parser_state, NULL, is_query_template()) ||
           thd->is_error() ||
           init_param_array(this));
 
@@ -89,6 +89,8 @@ void mysqld_stmt_close(THD *thd, char *packet);
 void mysql_sql_stmt_prepare(THD *thd);
 void mysql_sql_stmt_execute(THD *thd);
 void mysql_sql_stmt_execute_immediate(THD *thd);
+bool mysql_execute_query_template(THD *thd, const char *query, size_t length);
+void query_template_cache_free(THD *thd);
 // Bind a dynamic cursor placeholder from an Item (from the USING clause)
 bool mysql_sql_stmt_set_placeholder(THD *thd, const Lex_ident_sys &ps_name,
                                     uint placeholder_offset, Item *value);
@@ -32,6 +32,7 @@
 #include "semisync_slave.h"
 #include "mysys_err.h"
 #include "gtid_index.h"
+#include "rpl_binlog_tail.h"
 
 
 enum enum_gtid_until_state {
@@ -43,6 +44,7 @@ enum enum_gtid_until_state {
 
 int max_binlog_dump_events = 0; // unlimited
 my_bool opt_sporadic_binlog_dump_fail = 0;
+ulong opt_binlog_dump_sendfile_min_size= 0;
 #ifndef DBUG_OFF
 static int binlog_dump_count = 0;
 #endif
@@ -1595,6 +1597,9 @@ gtid_check_binlog_file(slave_connection_state *state,
     */
   }
   statistic_increment(binlog_gtid_index_miss, &LOCK_status);
+  /* Let the next slave connecting find the position in an index. */
+  if (reader)
+    mysql_bin_log.queue_gtid_index_rebuild(buf);
 
   bzero((char*) &cache, sizeof(cache));
   if (unlikely((file= open_binlog(&cache, buf, out_errormsg)) == (File)-1))
@@ -1821,17 +1826,24 @@ gtid_index_lookup_pos(const char *name, uint32 offset, uint32 *out_start_seek,
   rpl_gtid *found_gtids;
   int res;
 
-  if (!(reader= new Gtid_index_reader_hot()) ||
-      reader->open_index_file(name))
+  if (!(reader= new Gtid_index_reader_hot()))
   {
     statistic_increment(binlog_gtid_index_miss, &LOCK_status);
     goto err;
   }
+  if (reader->open_index_file(name))
+  {
+    statistic_increment(binlog_gtid_index_miss, &LOCK_status);
+    mysql_bin_log.queue_gtid_index_rebuild(name);
+    goto err;
+  }
   opened= true;
   res= reader->search_offset(offset, &found_offset, &found_gtid_count);
   if (res <= 0)
   {
     statistic_increment(binlog_gtid_index_miss, &LOCK_status);
+    if (res < 0)
+      mysql_bin_log.queue_gtid_index_rebuild(name);
     goto err;
   }
   statistic_increment(binlog_gtid_index_hit, &LOCK_status);
@@ -2164,11 +2176,15 @@ is_until_reached(binlog_send_info *info, ulong *ev_offset,
   Helper function for mysql_binlog_send() to write an event down the slave
   connection.
 
+  If body_len is not 0, the packet only has the header of the event, and
+  the rest of it is sent from the binlog file at body_pos.
+
   Returns NULL on success, error message string on error.
 */
 static const char *
 send_event_to_slave(binlog_send_info *info, Log_event_type event_type,
-                    IO_CACHE *log, ulong ev_offset, rpl_gtid *error_gtid)
+                    IO_CACHE *log, ulong ev_offset, rpl_gtid *error_gtid,
+                    my_off_t body_pos= 0, size_t body_len= 0)
 {
   my_off_t pos;
   String* const packet= info->packet;
@@ -2498,12 +2514,25 @@ send_event_to_slave(binlog_send_info *info, Log_event_type event_type,
   if (repl_semisync_master.update_sync_header(info->thd,
                                               (uchar*) packet->c_ptr_safe(),
                                               info->log_file_name + info->dirlen,
-                                              pos, &need_sync))
+                                              pos, event_type, &need_sync))
   {
     info->error= ER_UNKNOWN_ERROR;
     return "run 'before_send_event' hook failed";
   }
 
+#ifdef HAVE_SENDFILE
+  if (body_len)
+  {
+    if (my_net_write_file(info->net, (uchar*) packet->ptr(), len, log->file,
+                          body_pos, body_len))
+    {
+      info->error= ER_UNKNOWN_ERROR;
+      return "Failed on my_net_write_file()";
+    }
+    statistic_increment(binlog_dump_sendfile_events, &LOCK_status);
+  }
+  else
+#endif
   if (my_net_write(info->net, (uchar*) packet->ptr(), len))
   {
     info->error= ER_UNKNOWN_ERROR;
@@ -3222,6 +3251,65 @@ send_event_gtid_list_and_until(binlog_send_info *info, ulong *ev_offset,
 }
 
 
+#ifdef HAVE_SENDFILE
+/*
+  Check if the rest of the dump thread can send large events with
+  sendfile(). The events are then sent as they are in the binlog file, so
+  this is not done if anything needs the whole event in memory.
+*/
+
+static bool can_sendfile_events(binlog_send_info *info)
+{
+  enum_vio_type type= vio_type(info->net->vio);
+  return opt_binlog_dump_sendfile_min_size && !opt_master_verify_checksum &&
+         !info->net->compress &&
+         (type == VIO_TYPE_TCPIP || type == VIO_TYPE_SOCKET);
+}
+
+
+/*
+  Check if the next event in the binlog is a large row event, which only
+  needs its header to be sent. If so, the header is added to the transmit
+  packet and the log is positioned after the event.
+
+  @return Length of the rest of the event, to be sent from the file, or 0
+          if the event must be read with read_log_event()
+*/
+
+static size_t read_event_header_for_sendfile(binlog_send_info *info,
+                                             IO_CACHE *log, my_off_t end_pos)
+{
+  const uchar *header= log->read_pos;
+  my_off_t pos= my_b_tell(log);
+  size_t event_len;
+  Log_event_type event_type;
+
+  /* The header must already be in the cache */
+  if ((size_t) (log->read_end - log->read_pos) < LOG_EVENT_MINIMAL_HEADER_LEN ||
+      info->fdev->crypto_data.scheme)
+    return 0;
+  event_len= uint4korr(header + EVENT_LEN_OFFSET);
+  event_type= (Log_event_type) header[EVENT_TYPE_OFFSET];
+  if (event_len < opt_binlog_dump_sendfile_min_size ||
+      event_len <= LOG_EVENT_MINIMAL_HEADER_LEN ||
+      pos + event_len > end_pos ||
+      event_len + info->packet->length() >= MAX_PACKET_LENGTH ||
+      event_len > MY_MAX(info->thd->variables.max_allowed_packet,
+                         opt_binlog_rows_event_max_size +
+                         MAX_LOG_EVENT_HEADER) ||
+      !(LOG_EVENT_IS_WRITE_ROW(event_type) ||
+        LOG_EVENT_IS_UPDATE_ROW(event_type) ||
+        LOG_EVENT_IS_DELETE_ROW(event_type)))
+    return 0;
+
+  if (info->packet->append((const char*) header, LOG_EVENT_MINIMAL_HEADER_LEN))
+    return 0;
+  my_b_seek(log, pos + event_len);
+  return event_len - LOG_EVENT_MINIMAL_HEADER_LEN;
+}
+#endif /* HAVE_SENDFILE */
+
+
 /**
  * This function sends events from one binlog file
  * but only up until end_pos
@@ -3234,9 +3322,13 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
 {
   int error;
   ulong ev_offset;
+  size_t body_len= 0;
 
   String *packet= info->packet;
   DBUG_ASSERT(!info->engine_binlog_reader);
+#ifdef HAVE_SENDFILE
+  bool use_sendfile= can_sendfile_events(info);
+#endif
   linfo->pos= my_b_tell(log);
   info->last_pos= my_b_tell(log);
 
@@ -3252,6 +3344,12 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
       return 1;
 
     info->last_pos= linfo->pos;
+#ifdef HAVE_SENDFILE
+    if (use_sendfile &&
+        (body_len= read_event_header_for_sendfile(info, log, end_pos)))
+      error= 0;
+    else
+#endif
     error= Log_event::read_log_event(log, packet, info->fdev,
                        opt_master_verify_checksum ? info->current_checksum_alg
                                                   : BINLOG_CHECKSUM_ALG_OFF);
@@ -3307,7 +3405,10 @@ static int send_events(binlog_send_info *info, IO_CACHE* log, LOG_INFO* linfo,
 
     if (event_type != START_ENCRYPTION_EVENT &&
         ((info->errmsg= send_event_to_slave(info, event_type, log,
-                                           ev_offset, &info->error_gtid))))
+                                           ev_offset, &info->error_gtid,
+                                           info->last_pos +
+                                           LOG_EVENT_MINIMAL_HEADER_LEN,
+                                           body_len))))
       return 1;
 
     if (send_event_gtid_list_and_until(info, &ev_offset, event_type,
@@ -3491,6 +3592,8 @@ static int send_one_binlog_file(binlog_send_info *info,
                                 LOG_INFO* linfo,
                                 my_off_t start_pos)
 {
+  Binlog_tail_reader tail_reader;
+  int res= 1;
   mysql_mutex_assert_not_owner(mysql_bin_log.get_log_lock());
 
   /* seek to the requested position, to start the requested dump */
@@ -3501,6 +3604,12 @@ static int send_one_binlog_file(binlog_send_info *info,
     linfo->pos= start_pos;
   }
 
+  /* Read the file from the memory while it is the active one */
+  if (!opt_binlog_engine_hton)
+    binlog_tail_cache.attach_reader(&tail_reader, log, info->log_file_name);
+  else
+    tail_reader.log= NULL;
+
   /* Counter used by can_purge_log() */
   sending_new_binlog_file++;
   while (!should_stop(info))
@@ -3509,7 +3618,7 @@ static int send_one_binlog_file(binlog_send_info *info,
     {
       info->dirlen= 0;
       if (send_engine_events(info, linfo))
-        return 1;
+        break;
     }
     else
     {
@@ -3521,18 +3630,20 @@ static int send_one_binlog_file(binlog_send_info *info,
       if (end_pos <= 1)
       {
         /** end of file or error */
-        return (int)end_pos;
+        res= (int)end_pos;
+        break;
       }
       info->dirlen= dirname_length(info->log_file_name);
       /**
        * send events from current position up to end_pos
        */
       if (send_events(info, log, linfo, end_pos))
-        return 1;
+        break;
     }
   }
 
-  return 1;
+  binlog_tail_cache.detach_reader(&tail_reader);
+  return res;
 }
 
 void mysql_binlog_send(THD* thd, char* log_ident, my_off_t pos,
@@ -28,6 +28,7 @@ extern char *master_host, *master_info_file;
 
 extern int max_binlog_dump_events;
 extern my_bool opt_sporadic_binlog_dump_fail;
+extern ulong opt_binlog_dump_sendfile_min_size;
 
 int start_slave(THD* thd, Master_info* mi, bool net_report);
 int stop_slave(THD* thd, Master_info* mi, bool net_report);
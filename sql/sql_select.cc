@@ -229,6 +229,7 @@ static enum_nested_loop_state
 end_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
 static enum_nested_loop_state
 end_unique_update(JOIN *join, JOIN_TAB *join_tab, bool end_of_records);
+static bool copy_blobs(Field **ptr);
 
 static int join_read_const_table(THD *thd, JOIN_TAB *tab, POSITION *pos);
 static int join_read_system(JOIN_TAB *tab);
@@ -22465,6 +22466,27 @@ bool Create_tmp_table::add_fields(THD *thd,
 }
 
 
+/**
+  Check if the keys of the temporary table would include a blob column.
+
+  Heap tables store blobs of internal temporary tables in separate
+  overflow chunks, but can't index them.
+*/
+
+bool Create_tmp_table::blobs_in_key() const
+{
+  if (m_blobs_count[distinct])
+    return true;
+  for (ORDER *cur_group= m_group; cur_group; cur_group= cur_group->next)
+  {
+    Field *field= (*cur_group->item)->get_tmp_table_field();
+    if (!field || (field->flags & BLOB_FLAG))
+      return true;
+  }
+  return false;
+}
+
+
 bool Create_tmp_table::choose_engine(THD *thd, TABLE *table,
                                      TMP_TABLE_PARAM *param)
 {
@@ -22475,7 +22497,9 @@ bool Create_tmp_table::choose_engine(THD *thd, TABLE *table,
     In the future we should try making storage engine selection more dynamic
   */
 
-  if (share->blob_fields || m_using_unique_constraint ||
+  if ((share->blob_fields &&
+       (!thd->variables.tmp_memory_table_blobs || blobs_in_key())) ||
+      m_using_unique_constraint ||
       (m_select_options & TMP_TABLE_FORCE_MYISAM) ||
       thd->variables.tmp_memory_table_size == 0)
   {
@@ -25915,9 +25939,19 @@ join_read_first(JOIN_TAB *tab)
     DBUG_ASSERT(order);
     DBUG_ASSERT(order->next == NULL);
     DBUG_ASSERT(order->item[0]->real_item()->type() == Item::FUNC_ITEM);
+    /*
+      Push the condition into the vector search if it can be checked for
+      any row of this table alone. It is still checked for the rows the
+      search returns.
+    */
+    Item *cond= tab->select_cond;
+    if (cond && ((cond->used_tables() & ~(table->map | OUTER_REF_TABLE_BIT |
+                                         tab->join->const_table_map)) ||
+                 cond->is_expensive()))
+      cond= NULL;
     tab->read_record.read_record_func= join_hlindex_read_next;
     error= tab->table->hlindex_read_first(tab->index, *order->item,
-                                          tab->join->select_limit);
+                                          tab->join->select_limit, cond);
   }
   else
   {
@@ -26456,6 +26490,90 @@ end_write(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 }
 
 
+/**
+  Write the groups collected in the GROUP BY hash table into the temporary
+  table and stop using the hash table for this execution.
+
+  @param[out] converted  set to true if the table was converted to an
+                         on-disk table while writing the groups
+*/
+
+static bool flush_group_by_hash(JOIN *join, JOIN_TAB *join_tab,
+                                bool *converted)
+{
+  TABLE *const table= join_tab->table;
+  TMP_TABLE_PARAM *const param= join_tab->tmp_table_param;
+  Group_by_hash *const group_hash= param->group_hash;
+  int error;
+  DBUG_ENTER("flush_group_by_hash");
+  DBUG_PRINT("info", ("groups: %lu", group_hash->elements()));
+
+  *converted= false;
+  for (uchar *record= group_hash->first_record(); record;
+       record= group_hash->next_record(record))
+  {
+    memcpy(table->record[0], record, table->s->reclength);
+    if (unlikely((error= table->file->ha_write_tmp_row(table->record[0]))))
+    {
+      if (create_internal_tmp_table_from_heap(join->thd, table,
+                                              param->start_recinfo,
+                                              &param->recinfo,
+                                              error, 0, NULL))
+        DBUG_RETURN(true);
+      *converted= true;
+    }
+  }
+  group_hash->deactivate();
+  DBUG_RETURN(false);
+}
+
+
+/**
+  Convert the temporary table to an on-disk table after updating a group
+  row failed because the HEAP table is full, and redo the update there.
+
+  The old version of the row is copied by the conversion, so the write of
+  the new version that ends it finds a duplicate. The old row is then
+  replaced, like end_unique_update() does with duplicates.
+
+  @note
+    The table is left initialized for random reads.
+*/
+
+static bool update_tmp_row_after_table_full(JOIN_TAB *join_tab, int error)
+{
+  TABLE *const table= join_tab->table;
+  TMP_TABLE_PARAM *const param= join_tab->tmp_table_param;
+  bool is_duplicate;
+  DBUG_ENTER("update_tmp_row_after_table_full");
+
+  /* Blob values restored from the old row point into the HEAP table */
+  if (table->s->blob_fields && copy_blobs(table->field))
+    DBUG_RETURN(true);
+  if (create_internal_tmp_table_from_heap(table->in_use, table,
+                                          param->start_recinfo,
+                                          &param->recinfo,
+                                          error, 1, &is_duplicate))
+    DBUG_RETURN(true);                          // Not a table_is_full error
+  DBUG_ASSERT(is_duplicate);
+  if (unlikely((int) table->file->get_dup_key(HA_ERR_FOUND_DUPP_KEY) < 0))
+  {
+    table->file->print_error(HA_ERR_FOUND_DUPP_KEY, MYF(0));
+    DBUG_RETURN(true);
+  }
+  if (unlikely((error= table->file->ha_rnd_init(0)) ||
+               (error= table->file->ha_rnd_pos(table->record[1],
+                                               table->file->dup_ref)) ||
+               (error= table->file->ha_update_tmp_row(table->record[1],
+                                                      table->record[0]))))
+  {
+    table->file->print_error(error, MYF(0));
+    DBUG_RETURN(true);
+  }
+  DBUG_RETURN(false);
+}
+
+
 /*
   @brief
     Perform GROUP BY operation over rows coming in arbitrary order: use
@@ -26485,12 +26603,19 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
 	   bool end_of_records)
 {
   TABLE *const table= join_tab->table;
+  Group_by_hash *const group_hash= join_tab->tmp_table_param->group_hash;
   ORDER   *group;
   int	  error;
+  bool    converted;
   DBUG_ENTER("end_update");
 
   if (end_of_records)
+  {
+    if (group_hash && group_hash->is_active() &&
+        flush_group_by_hash(join, join_tab, &converted))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
     DBUG_RETURN(NESTED_LOOP_OK);
+  }
 
   join->found_records++;
   copy_fields(join_tab->tmp_table_param);	// Groups are copied twice.
@@ -26512,6 +26637,45 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
     if (item->maybe_null())
       group->buff[-1]= (char) group->field->is_null();
   }
+  if (group_hash && group_hash->is_active())
+  {
+    uchar *const key= join_tab->tmp_table_param->group_buff;
+    const ulong hash= group_hash->hash_key(key);
+    uchar *record;
+    if ((record= group_hash->find(key, hash)))
+    {
+      memcpy(table->record[0], record, table->s->reclength);
+      update_tmptable_sum_func(join->sum_funcs, table);
+      memcpy(record, table->record[0], table->s->reclength);
+      goto end;
+    }
+    if (group_hash->reserve())
+    {
+      init_tmptable_sum_functions(join->sum_funcs);
+      if (unlikely(copy_funcs(join_tab->tmp_table_param->items_to_copy,
+                              join->thd)) ||
+          unlikely(group_hash->insert(key, hash, table->record[0])))
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      join_tab->send_records++;
+      goto end;
+    }
+    /*
+      The hash table is full. Move the groups to the temporary table and
+      continue with it.
+    */
+    if (flush_group_by_hash(join, join_tab, &converted))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
+    if (converted)
+    {
+      if (unlikely((error= table->file->ha_index_init(0, 0))))
+      {
+        table->file->print_error(error, MYF(0));
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      }
+      join_tab->aggr->set_write_func(end_unique_update);
+      DBUG_RETURN(end_unique_update(join, join_tab, end_of_records));
+    }
+  }
   if (!table->file->ha_index_read_map(table->record[1],
                                       join_tab->tmp_table_param->group_buff,
                                       HA_WHOLE_KEY,
@@ -26522,8 +26686,16 @@ end_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
     if (unlikely((error= table->file->ha_update_tmp_row(table->record[1],
                                                         table->record[0]))))
     {
-      table->file->print_error(error,MYF(0));	/* purecov: inspected */
-      DBUG_RETURN(NESTED_LOOP_ERROR);            /* purecov: inspected */
+      if (update_tmp_row_after_table_full(join_tab, error))
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      /* Change method to update rows */
+      if (unlikely((error= table->file->ha_rnd_end()) ||
+                   (error= table->file->ha_index_init(0, 0))))
+      {
+        table->file->print_error(error, MYF(0));
+        DBUG_RETURN(NESTED_LOOP_ERROR);
+      }
+      join_tab->aggr->set_write_func(end_unique_update);
     }
     goto end;
   }
@@ -26606,11 +26778,9 @@ end_unique_update(JOIN *join, JOIN_TAB *join_tab __attribute__((unused)),
     restore_record(table,record[1]);
     update_tmptable_sum_func(join->sum_funcs,table);
     if (unlikely((error= table->file->ha_update_tmp_row(table->record[1],
-                                                        table->record[0]))))
-    {
-      table->file->print_error(error,MYF(0));	/* purecov: inspected */
-      DBUG_RETURN(NESTED_LOOP_ERROR);            /* purecov: inspected */
-    }
+                                                        table->record[0]))) &&
+        update_tmp_row_after_table_full(join_tab, error))
+      DBUG_RETURN(NESTED_LOOP_ERROR);
     if (!rnd_inited &&
         ((error= table->file->ha_rnd_end()) ||
          (error= table->file->ha_index_init(0, 0))))
@@ -28513,8 +28683,8 @@ JOIN_TAB::remove_duplicates()
   table->file->info(HA_STATUS_VARIABLE);
   table->reginfo.lock_type=TL_WRITE;
 
-  if (table->s->db_type() == heap_hton ||
-      (!table->s->blob_fields &&
+  if (!table->s->blob_fields &&
+      (table->s->db_type() == heap_hton ||
        ((ALIGN_SIZE(keylength) + HASH_OVERHEAD) * table->file->stats.records <
 	thd->variables.sortbuff_size)))
     error= remove_dup_with_hash_index(join->thd, table, field_count,
@@ -33892,6 +34062,25 @@ AGGR_OP::prepare_tmp_table()
       return true;
     (void) table->file->extra(HA_EXTRA_WRITE_CACHE);
   }
+  /*
+    Aggregate in an in-memory hash table in front of a HEAP table when all
+    aggregate functions support it.
+  */
+  if (write_func == end_update && table->s->db_type() == heap_hton &&
+      !table->s->blob_fields && Group_by_hash::supported(join->sum_funcs))
+  {
+    TMP_TABLE_PARAM *param= join_tab->tmp_table_param;
+    THD *thd= join->thd;
+    size_t memory_limit= (size_t)
+      MY_MIN(thd->variables.tmp_memory_table_size,
+             thd->variables.max_heap_table_size);
+    if (param->group_hash)
+      param->group_hash->reset();
+    else if (!(param->group_hash= new (thd->mem_root)
+               Group_by_hash(table->key_info, param->group_length,
+                             table->s->reclength, memory_limit)))
+      return true;
+  }
   /* If it wasn't already, start index scan for grouping using table index. */
   if (!table->file->inited && table->group &&
       join_tab->tmp_table_param->sum_func_count && table->s->keys)
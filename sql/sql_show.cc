@@ -2512,15 +2512,23 @@ int show_create_table_ex(THD *thd, TABLE_LIST *table_list, const char *force_db,
     for (uint j=0 ; j < key_parts ; j++,key_part++)
     {
       Field *field= key_part->field;
-      if (field->invisible > INVISIBLE_USER)
+      if (field->invisible > INVISIBLE_USER && !field->is_key_expression())
         continue;
 
       if (j)
         packet->append(',');
 
-      if (key_part->field)
+      if (field->is_key_expression())
+      {
+        StringBuffer<MAX_FIELD_WIDTH> str(&my_charset_utf8mb4_general_ci);
+        field->vcol_info->print(&str);
+        packet->append(STRING_WITH_LEN("("));
+        packet->append(str);
+        packet->append(STRING_WITH_LEN(")"));
+      }
+      else if (key_part->field)
         append_identifier(thd, packet, &key_part->field->field_name);
-      if (key_part->field &&
+      if (key_part->field && !field->is_key_expression() &&
           key_part->length != table->field[key_part->fieldnr-1]->key_length() &&
           key_info->algorithm != HA_KEY_ALG_VECTOR &&
           key_info->algorithm != HA_KEY_ALG_RTREE &&
@@ -7480,6 +7488,7 @@ static int get_schema_stat_record(THD *thd, TABLE_LIST *tables, TABLE *table,
       for (uint j=0 ; j < key_info->user_defined_key_parts ; j++,key_part++)
       {
         if (key_part->field->invisible >= INVISIBLE_SYSTEM &&
+            !key_part->field->is_key_expression() &&
             !DBUG_IF("test_completely_invisible"))
         {
           /*
@@ -2956,7 +2956,8 @@ my_bool init_key_part_spec(THD *thd, Alter_info *alter_info,
   /*
     Either field is not present or field visibility is > INVISIBLE_USER
   */
-  if (!column || (column->invisible > INVISIBLE_USER && !kp.generated))
+  if (!column ||
+      (column->invisible > INVISIBLE_USER && !kp.generated && !kp.expr))
   {
     my_error(ER_KEY_COLUMN_DOES_NOT_EXIST, MYF(0), field_name.str);
     DBUG_RETURN(TRUE);
@@ -2964,7 +2965,7 @@ my_bool init_key_part_spec(THD *thd, Alter_info *alter_info,
 
   if (!DBUG_IF("test_invisible_index")
       && column->invisible > INVISIBLE_USER
-      && !(column->flags & VERS_SYSTEM_FIELD) && !key.invisible)
+      && !(column->flags & VERS_SYSTEM_FIELD) && !key.invisible && !kp.expr)
   {
     my_error(ER_KEY_COLUMN_DOES_NOT_EXIST, MYF(0), column->field_name.str);
     DBUG_RETURN(TRUE);
@@ -3190,6 +3191,151 @@ my_bool init_key_info(THD *thd, Alter_info *alter_info,
 }
 
 
+/*
+  Fixes the expression of a key part against the columns of the new table,
+  to find out the data type of its hidden column.
+
+  There is no TABLE yet, so the columns are put in a Virtual_tmp_table,
+  and the expression is parsed again from its text the same way as
+  unpack_vcol_info_from_frm() does it when the table is opened.
+
+  @return the definition of the column, or NULL on error
+*/
+
+static Create_field *
+key_expression_definition(THD *thd, HA_CREATE_INFO *create_info,
+                          Alter_info *alter_info, Virtual_column_info *vcol)
+{
+  Virtual_tmp_table *table;
+  Create_field *def= NULL;
+  DBUG_ENTER("key_expression_definition");
+
+  if (!(table= new (thd) Virtual_tmp_table(thd)))
+    DBUG_RETURN(NULL);
+  if (table->init(alter_info->create_list.elements))
+    goto end;
+  for (const Create_field &column : alter_info->create_list)
+  {
+    Column_definition tmp(column);
+    Field *field;
+    if (tmp.prepare_stage2(NULL, HA_CAN_GEOMETRY))
+      goto end;
+    Record_addr addr(f_maybe_null(tmp.pack_flag));
+    if (!(field= tmp.make_field(table->s, thd->mem_root, &addr,
+                                &column.field_name)))
+      goto end;
+    table->add(field);
+    field->invisible= column.invisible;
+  }
+  if (table->open())
+    goto end;
+  table->s->db= alter_info->db;
+  table->s->table_name= alter_info->table_name;
+
+  {
+    Sql_mode_save_for_frm_handling sql_mode_save(thd);
+    CHARSET_INFO *save_character_set_client=
+      thd->variables.character_set_client;
+    CHARSET_INFO *save_collation= thd->variables.collation_connection;
+    const THD_WHERE save_where= thd->where;
+    const char *save_where_str= thd->where_str;
+    StringBuffer<MAX_FIELD_WIDTH> expr_str(&my_charset_utf8mb4_general_ci);
+    Parser_state parser_state;
+    Create_field vcol_storage;
+    LEX *old_lex= thd->lex;
+    LEX lex;
+    Item *expr;
+
+    expr_str.append(STRING_WITH_LEN("PARSE_VCOL_EXPR "));
+    vcol->print(&expr_str);
+    if (parser_state.init(thd, expr_str.c_ptr_safe(), expr_str.length()))
+      goto end;
+    if (init_lex_with_single_table(thd, table, &lex))
+    {
+      end_lex_with_single_table(thd, table, old_lex);
+      goto end;
+    }
+    lex.parse_vcol_expr= true;
+    lex.last_field= &vcol_storage;
+    thd->update_charset(&my_charset_utf8mb4_general_ci,
+                        create_info->default_table_charset);
+    thd->where= THD_WHERE::USE_WHERE_STRING;
+    thd->where_str= vcol_type_name(VCOL_GENERATED_VIRTUAL);
+
+    if (!parse_sql(thd, &parser_state, NULL) &&
+        !vcol_storage.vcol_info->fix_expr(thd))
+    {
+      Field *tmp_field;
+      expr= vcol_storage.vcol_info->expr;
+      if ((tmp_field= expr->create_field_for_create_select(thd->mem_root,
+                                                           table)))
+        def= new (thd->mem_root) Create_field(thd, tmp_field, NULL);
+    }
+
+    end_lex_with_single_table(thd, table, old_lex);
+    thd->update_charset(save_character_set_client, save_collation);
+    thd->where= save_where;
+    thd->where_str= save_where_str;
+  }
+
+end:
+  delete table;
+  DBUG_RETURN(def);
+}
+
+
+/*
+  Adds a hidden virtual column for every expression in a key, like
+  KEY ((a + b)), and makes the key part use it. Then the optimizer puts
+  the column instead of the same expression in the conditions, see
+  opt_vcol_substitution.cc.
+*/
+
+static bool add_key_expression_fields(THD *thd, HA_CREATE_INFO *create_info,
+                                      Alter_info *alter_info)
+{
+  const Column_derived_attributes dattr(create_info->default_table_charset);
+
+  for (Key &key : alter_info->key_list)
+  {
+    for (Key_part_spec &kp : key.columns)
+    {
+      if (!kp.expr || kp.field_name.str)
+        continue;                               // a column, or done already
+      if (key.type == Key::FOREIGN_KEY)
+      {
+        my_error(ER_NOT_SUPPORTED_YET, MYF(0), "FOREIGN KEY on expression");
+        return true;
+      }
+
+      Lex_ident_column name= make_internal_field_name(thd, "DB_KEY_EXPR_",
+                                                 &alter_info->create_list);
+      kp.expr->set_vcol_type(VCOL_GENERATED_VIRTUAL);
+      if (check_expression(kp.expr, name, VCOL_GENERATED_VIRTUAL))
+        return true;
+
+      Create_field *cf= key_expression_definition(thd, create_info,
+                                                  alter_info, kp.expr);
+      if (!cf)
+        return true;
+      cf->field_name= name;
+      cf->change= Lex_ident_column();
+      cf->field= NULL;
+      cf->invisible= INVISIBLE_FULL;
+      cf->flags&= ~NOT_NULL_FLAG;
+      cf->vcol_info= kp.expr;
+      cf->length= cf->char_length;
+      if (cf->prepare_stage1(thd, thd->mem_root,
+                             COLUMN_DEFINITION_TABLE_FIELD, &dattr) ||
+          alter_info->create_list.push_back(cf, thd->mem_root))
+        return true;
+      kp.field_name= name;
+    }
+  }
+  return false;
+}
+
+
 /*
   Prepare for a table creation.
   Stage 1: prepare the field list.
@@ -3253,7 +3399,7 @@ static bool mysql_prepare_create_table_stage1(THD *thd,
       DBUG_RETURN(TRUE);
     }
   }
-  DBUG_RETURN(false);
+  DBUG_RETURN(add_key_expression_fields(thd, create_info, alter_info));
 }
 
 
@@ -3600,7 +3746,9 @@ mysql_prepare_create_table_finalize(THD *thd, HA_CREATE_INFO *create_info,
     }
     else if (!(key_name= key->name).str)
     {
-      Lex_ident_column field_name(key->columns.elem(0)->field_name);
+      Lex_ident_column field_name(key->columns.elem(0)->expr
+                                  ? "expr"_Lex_ident_column
+                                  : key->columns.elem(0)->field_name);
       it.rewind();
       while ((sql_field=it++) &&
              !field_name.streq(sql_field->field_name))
@@ -9221,6 +9369,15 @@ mysql_prepare_alter_table(THD *thd, TABLE *table,
       Field *kfield= key_part->field;
       if (!kfield)
 	continue;				// Wrong field (from UNIREG)
+      if (kfield->is_key_expression())
+      {
+        /* the hidden column is added again for the expression */
+        Key_part_spec *kps= new (root) Key_part_spec(kfield->vcol_info);
+        kps->asc= !(key_part->key_part_flag & HA_REVERSE_SORT);
+        key_parts.push_back(kps, root);
+        user_keyparts= true;
+        continue;
+      }
       const Lex_ident_column key_part_name(kfield->field_name);
       Create_field *cfield;
       uint key_part_length;
@@ -12849,6 +13006,11 @@ copy_data_between_tables(THD *thd, TABLE *from, TABLE *to,
 
   to->file->prepare_for_modify(true, false);
   DBUG_ASSERT(to->file->inited == handler::NONE);
+  if (int err= to->hlindexes_start_bulk_insert())
+  {
+    to->file->print_error(err, MYF(0));
+    goto err;
+  }
 
   /* Tell handler that we have values for all columns in the to table */
   to->use_all_columns();
@@ -13056,6 +13218,16 @@ copy_data_between_tables(THD *thd, TABLE *from, TABLE *to,
       to->file->print_error(my_errno,MYF(0));
     error= 1;
   }
+  if (error <= 0)
+  {
+    /* the rows are copied, build the vector index before online changes */
+    if (int err= to->hlindexes_end_bulk_insert(false))
+    {
+      if (!thd->is_error())
+        to->file->print_error(err, MYF(0));
+      error= 1;
+    }
+  }
 
   bulk_insert_started= 0;
   if (error <= 0 && !to->s->hlindexes())
@@ -18,6 +18,7 @@
 #include "sql_type.h"
 #include "sql_type_geom.h"
 #include "sql_type_vector.h"
+#include "sql_type_jsonb.h"
 #include "sql_const.h"
 #include "sql_class.h"
 #include "sql_time.h"
@@ -248,6 +249,8 @@ Type_handler::handler_by_name(THD *thd, const LEX_CSTRING &name)
   const Type_handler *ha= Type_collection_geometry_handler_by_name(name);
   if (!ha && type_handler_vector.name().eq(name))
     return &type_handler_vector;
+  if (!ha && type_handler_jsonb.name().eq(name))
+    return &type_handler_jsonb;
   return ha;
 }
 
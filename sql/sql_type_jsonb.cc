@@ -0,0 +1,181 @@
+/*
+   Copyright (c) 2026, MariaDB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+#include "mariadb.h"
+#include "sql_type_jsonb.h"
+#include "json_binary.h"
+#include "sql_class.h"
+
+Named_type_handler<Type_handler_jsonb> type_handler_jsonb("jsonb");
+
+
+bool Type_handler_jsonb::Column_definition_set_attributes(THD *thd,
+                                                 Column_definition *def,
+                                                 const Lex_field_type_st &attr,
+                                                 column_definition_type_t type)
+                                                                          const
+{
+  if (Type_handler_long_blob::Column_definition_set_attributes(thd, def,
+                                                               attr, type))
+    return true;
+  def->charset= &my_charset_utf8mb4_bin;
+  return false;
+}
+
+
+Field *Type_handler_jsonb::make_conversion_table_field(MEM_ROOT *root,
+                    TABLE *table, uint metadata, const Field *target) const
+{
+  return new (root) Field_jsonb(NULL, (uchar *) "", 1, Field::NONE,
+                                &empty_clex_str, table->s);
+}
+
+
+Field *Type_handler_jsonb::make_table_field(MEM_ROOT *root,
+         const LEX_CSTRING *name, const Record_addr &addr,
+         const Type_all_attributes &attr, TABLE_SHARE *share) const
+{
+  return new (root) Field_jsonb(addr.ptr(), addr.null_ptr(), addr.null_bit(),
+                                Field::NONE, name, share);
+}
+
+
+Field *Type_handler_jsonb::make_table_field_from_def(TABLE_SHARE *share,
+         MEM_ROOT *root, const LEX_CSTRING *name, const Record_addr &rec,
+         const Bit_addr &bit, const Column_definition_attributes *attr,
+         uint32 flags) const
+{
+  return new (root) Field_jsonb(rec.ptr(), rec.null_ptr(), rec.null_bit(),
+                                attr->unireg_check, name, share);
+}
+
+/*****************************************************************/
+
+int Field_jsonb::report_wrong_value(const ErrConv &val)
+{
+  get_thd()->push_warning_truncated_value_for_field(
+    Sql_condition::WARN_LEVEL_WARN, "jsonb", val.ptr(),
+    table->s->db.str, table->s->table_name.str, field_name.str);
+  reset();
+  return 1;
+}
+
+
+int Field_jsonb::store(const char *from, size_t length, CHARSET_INFO *cs)
+{
+  DBUG_ASSERT(marked_for_write_or_computed());
+  StringBuffer<STRING_BUFFER_USUAL_SIZE> image;
+  String conv;
+  const char *js= from;
+  size_t js_length= length;
+  uint32 dummy_offset;
+
+  if (String::needs_conversion(length, cs, field_charset(), &dummy_offset))
+  {
+    uint errors;
+    if (conv.copy(from, length, cs, field_charset(), &errors))
+      goto oom;
+    js= conv.ptr();
+    js_length= conv.length();
+  }
+
+  if (json_binary_from_text(&image, js, js_length, field_charset()))
+    return report_wrong_value(ErrConvString(from, length, cs));
+  return store_binary(image.ptr(), image.length());
+
+oom:
+  set_ptr((uint32) 0, NULL);
+  return -1;
+}
+
+
+int Field_jsonb::store_binary(const char *image, size_t length)
+{
+  if (table && table->blob_storage)    // GROUP_CONCAT with ORDER BY | DISTINCT
+  {
+    /* unlike the text, the image cannot be cut at group_concat_max_len */
+    char *tmp;
+    if (!(tmp= table->blob_storage->store(image, length)))
+      goto oom;
+    store_length(static_cast<uint32>(length));
+    bmove(ptr + packlength, (uchar*) &tmp, sizeof(char*));
+    return 0;
+  }
+
+  if (image >= value.ptr() && image <= value.end())
+  {
+    String tmp;
+    if (tmp.copy(image, length, &my_charset_bin))
+      goto oom;
+    value.swap(tmp);
+  }
+  else if (value.copy(image, length, &my_charset_bin))
+    goto oom;
+  set_ptr(static_cast<uint32>(length), (uchar*) value.ptr());
+  return 0;
+
+oom:
+  set_ptr((uint32) 0, NULL);
+  return -1;
+}
+
+
+String *Field_jsonb::val_str(String *val_buffer, String *val_ptr)
+{
+  DBUG_ASSERT(marked_for_read());
+  val_ptr->set_charset(field_charset());
+  val_ptr->length(0);
+  if (get_length() && json_binary_to_text(val_ptr, get_ptr(), 1))
+    val_ptr->length(0);
+  return val_ptr;
+}
+
+
+double Field_jsonb::val_real()
+{
+  DBUG_ASSERT(marked_for_read());
+  THD *thd= get_thd();
+  String buf;
+  val_str(&buf, &buf);
+  return Converter_strntod_with_warn(thd, Warn_filter(thd), "DOUBLE",
+                                     field_charset(),
+                                     buf.ptr(), buf.length()).result();
+}
+
+
+longlong Field_jsonb::val_int()
+{
+  DBUG_ASSERT(marked_for_read());
+  THD *thd= get_thd();
+  String buf;
+  val_str(&buf, &buf);
+  return Converter_strntoll_with_warn(thd, Warn_filter(thd), field_charset(),
+                                      buf.ptr(), buf.length()).result();
+}
+
+
+my_decimal *Field_jsonb::val_decimal(my_decimal *decimal_value)
+{
+  DBUG_ASSERT(marked_for_read());
+  THD *thd= get_thd();
+  String buf;
+  val_str(&buf, &buf);
+  Converter_str2my_decimal_with_warn(thd, Warn_filter(thd),
+                                     E_DEC_FATAL_ERROR & ~E_DEC_BAD_NUM,
+                                     field_charset(),
+                                     buf.ptr(), buf.length(), decimal_value);
+  return decimal_value;
+}
@@ -0,0 +1,118 @@
+#ifndef SQL_TYPE_JSONB_INCLUDED
+#define SQL_TYPE_JSONB_INCLUDED
+/*
+   Copyright (c) 2026, MariaDB
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02111-1301 USA */
+
+/*
+  JSONB is a LONGBLOB that keeps the image of json_binary.h. Everything
+  but the JSON functions sees the text of the document, the functions
+  that take a JSONB column read and replace values in the image.
+*/
+
+#include "sql_type.h"
+#include "sql_type_json.h"
+
+class Type_handler_jsonb: public Type_handler_long_blob
+{
+public:
+  virtual ~Type_handler_jsonb() {}
+  const Type_collection *type_collection() const override
+  {
+    return Type_handler_json_common::type_collection();
+  }
+  const Type_handler *type_handler_base() const override
+  {
+    return &type_handler_long_blob;
+  }
+  uint get_column_attributes() const override { return ATTR_NONE; }
+  bool type_can_have_key_part() const override { return false; }
+  Item *create_typecast_item(THD *thd, Item *item,
+                             const Type_cast_attributes &attr) const override
+  {
+    return NULL;
+  }
+  bool Item_append_extended_type_info(Send_field_extended_metadata *to,
+                                      const Item *item) const override
+  {
+    return Type_handler_json_common::set_format_name(to);
+  }
+  bool Column_definition_set_attributes(THD *thd,
+                                        Column_definition *def,
+                                        const Lex_field_type_st &attr,
+                                        column_definition_type_t type)
+                                                       const override;
+  Field *make_conversion_table_field(MEM_ROOT *root,
+                                     TABLE *table, uint metadata,
+                                     const Field *target) const override;
+  Field *make_table_field(MEM_ROOT *root, const LEX_CSTRING *name,
+           const Record_addr &addr, const Type_all_attributes &attr,
+           TABLE_SHARE *share) const override;
+  Field *make_table_field_from_def(TABLE_SHARE *share, MEM_ROOT *mem_root,
+           const LEX_CSTRING *name, const Record_addr &addr,
+           const Bit_addr &bit, const Column_definition_attributes *attr,
+           uint32 flags) const override;
+};
+
+extern Named_type_handler<Type_handler_jsonb> type_handler_jsonb;
+
+#include "field.h"
+
+class Field_jsonb: public Field_blob
+{
+  int report_wrong_value(const ErrConv &val);
+public:
+  Field_jsonb(uchar *ptr_arg, uchar *null_ptr_arg, uchar null_bit_arg,
+              enum utype unireg_check_arg, const LEX_CSTRING *field_name_arg,
+              TABLE_SHARE *share)
+    : Field_blob(ptr_arg, null_ptr_arg, null_bit_arg, unireg_check_arg,
+                 field_name_arg, share, 4, &my_charset_utf8mb4_bin)
+  {}
+  const Type_handler *type_handler() const override
+  { return &type_handler_jsonb; }
+  void sql_type(String &str) const override
+  { str.set_ascii(STRING_WITH_LEN("jsonb")); }
+  bool has_charset() const override { return false; }
+  /* like mysql_json, copy with val_str() and store() and not as a blob */
+  Compression_method *compression_method() const override
+  { return (Compression_method*) 1; }
+  bool is_equal(const Column_definition &new_field) const override
+  { return new_field.type_handler() == type_handler(); }
+  Copy_func *get_copy_func(const Field *from) const override
+  {
+    if (from->type_handler() != &type_handler_jsonb)
+      return do_conv_blob;
+    return Field_blob::get_copy_func(from);
+  }
+  bool memcpy_field_possible(const Field *from) const override
+  {
+    return from->type_handler() == &type_handler_jsonb &&
+           Field_blob::memcpy_field_possible(from);
+  }
+  int store(const char *from, size_t length, CHARSET_INFO *cs) override;
+  using Field_str::store;
+  /* stores an image made by json_binary_from_text() */
+  int store_binary(const char *image, size_t length);
+  String *val_str(String *, String *) override;
+  double val_real() override;
+  longlong val_int() override;
+  my_decimal *val_decimal(my_decimal *) override;
+  bool send(Protocol *protocol) override { return Field::send(protocol); }
+  uint size_of() const override { return sizeof *this; }
+  bool update_min(Field *, bool) override { return false; } // disable EITS
+  bool update_max(Field *, bool) override { return false; } // disable EITS
+};
+
+#endif // SQL_TYPE_JSONB_INCLUDED
@@ -7645,6 +7645,15 @@ key_part:
             if (unlikely($$ == NULL))
               MYSQL_YYABORT;
           }
+        | '(' expr ')'
+          {
+            Virtual_column_info *v= add_virtual_expression(thd, $2);
+            if (unlikely(!v))
+              MYSQL_YYABORT;
+            $$= new (thd->mem_root) Key_part_spec(v);
+            if (unlikely($$ == NULL))
+              MYSQL_YYABORT;
+          }
         ;
 
 key_part_simple:
@@ -64,6 +64,10 @@
 #include "sql_repl.h"
 #include "opt_range.h"
 #include "rpl_parallel.h"
+#include "rpl_writeset.h"
+#include "rpl_rows_prefetch.h"
+#include "rpl_event_decode.h"
+#include "rpl_binlog_tail.h"
 #include "semisync_master.h"
 #include "semisync_slave.h"
 #include <ssl_compat.h>
@@ -1634,6 +1638,33 @@ Sys_log_bin_compress_min_len(
   GLOBAL_VAR(opt_bin_log_compress_min_len),
   CMD_LINE(OPT_ARG), VALID_RANGE(10, 1024), DEFAULT(256), BLOCK_SIZE(1));
 
+static const char *log_bin_compress_algorithm_names[]= {"zlib", "zstd", 0};
+
+static bool check_log_bin_compress_algorithm(sys_var *self, THD *thd,
+                                             set_var *var)
+{
+#ifndef HAVE_ZSTD
+  if (var->save_result.ulonglong_value == BINLOG_COMPRESS_ZSTD)
+  {
+    my_error(ER_NOT_SUPPORTED_YET, MYF(0),
+             "log_bin_compress_algorithm=zstd in a server built without zstd");
+    return true;
+  }
+#endif
+  return false;
+}
+
+static Sys_var_on_access_global<Sys_var_enum,
+                            PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_COMPRESS>
+Sys_log_bin_compress_algorithm(
+  "log_bin_compress_algorithm",
+  "Compression algorithm of the binary log events compressed with "
+  "--log-bin-compress. zstd gives smaller events, but needs replicas and "
+  "mariadb-binlog that support it",
+  GLOBAL_VAR(opt_bin_log_compress_alg), CMD_LINE(REQUIRED_ARG),
+  log_bin_compress_algorithm_names, DEFAULT(BINLOG_COMPRESS_ZLIB),
+  NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(check_log_bin_compress_algorithm));
+
 static Sys_var_on_access_global<Sys_var_mybool,
                     PRIV_SET_SYSTEM_GLOBAL_VAR_LOG_BIN_TRUST_FUNCTION_CREATORS>
 Sys_trust_function_creators(
@@ -2543,6 +2574,27 @@ Sys_slave_parallel_max_queued(
        VALID_RANGE(0,2147483647), DEFAULT(131072), BLOCK_SIZE(1));
 
 
+static Sys_var_ulong Sys_slave_parallel_decode_threads(
+       "slave_parallel_decode_threads",
+       "Number of threads that verify the checksums of, decompress and "
+       "construct the relay log events read ahead of the SQL driver thread "
+       "of a parallel replica. The threads are started when first needed. "
+       "Only used when --slave-parallel-threads > 0. 0 decodes all events "
+       "in the SQL driver thread",
+       GLOBAL_VAR(opt_slave_parallel_decode_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0,256), DEFAULT(0), BLOCK_SIZE(1));
+
+
+static Sys_var_ulong Sys_slave_rows_prefetch_threads(
+       "slave_rows_prefetch_threads",
+       "Number of threads that read ahead the rows of large UPDATE and "
+       "DELETE row events on the replica, so that the rows are in the "
+       "InnoDB buffer pool when the event is applied. The threads are "
+       "started when first needed. 0 disables the read-ahead",
+       GLOBAL_VAR(opt_slave_rows_prefetch_threads), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0,256), DEFAULT(0), BLOCK_SIZE(1));
+
+
 bool
 Sys_var_slave_parallel_mode::global_update(THD *thd, set_var *var)
 {
@@ -3393,6 +3445,14 @@ static Sys_var_ulong Sys_query_prealloc_size(
        BLOCK_SIZE(1024), NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
        ON_UPDATE(fix_thd_mem_root));
 
+static Sys_var_ulonglong Sys_memroot_block_cache_size(
+       "memroot_block_cache_size",
+       "Max size of freed statement memory blocks a thread keeps in a cache "
+       "for reuse by later statements and connections, instead of returning "
+       "them to malloc. 0 disables the cache",
+       GLOBAL_VAR(my_root_block_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024*1024), DEFAULT(0), BLOCK_SIZE(1024));
+
 // this has to be NO_CMD_LINE as the command-line option has a different name
 static Sys_var_mybool Sys_skip_external_locking(
        "skip_external_locking", "Don't use system (external) locking",
@@ -3599,6 +3659,15 @@ static Sys_var_mybool Sys_query_cache_wlock_invalidate(
        SESSION_VAR(query_cache_wlock_invalidate), CMD_LINE(OPT_ARG),
        DEFAULT(FALSE));
 
+static Sys_var_uint Sys_query_template_cache_size(
+       "query_template_cache_size",
+       "The number of query templates to cache per session. Queries that "
+       "differ only in literal values of WHERE conditions are then executed "
+       "as one prepared statement, without being parsed again. "
+       "0 disables the cache",
+       SESSION_VAR(query_template_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024), DEFAULT(0), BLOCK_SIZE(1));
+
 static bool check_require_secure_transport(sys_var *self, THD *thd, set_var *var)
 {
 #ifndef _WIN32
@@ -3776,6 +3845,24 @@ Sys_master_verify_checksum(
        GLOBAL_VAR(opt_master_verify_checksum), CMD_LINE(OPT_ARG),
        DEFAULT(FALSE));
 
+static Sys_var_ulong Sys_binlog_dump_sendfile_min_size(
+       "binlog_dump_sendfile_min_size",
+       "Row events of at least this size are sent to slaves with sendfile(), "
+       "without copying them through the memory of the server, unless the "
+       "connection uses SSL or compression, the binlog is encrypted or "
+       "master_verify_checksum is set. 0 disables this. Has no effect on "
+       "platforms without sendfile()",
+       GLOBAL_VAR(opt_binlog_dump_sendfile_min_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024*1024), DEFAULT(0), BLOCK_SIZE(1));
+
+static Sys_var_ulong Sys_binlog_dump_cache_size(
+       "binlog_dump_cache_size",
+       "Size of the in-memory copy of the end of the active binlog file, from "
+       "which the binlog dump threads of slaves that are not far behind read "
+       "the events instead of reading the file. 0 disables this",
+       READ_ONLY GLOBAL_VAR(opt_binlog_dump_cache_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(0, 1024*1024*1024), DEFAULT(0), BLOCK_SIZE(IO_SIZE));
+
 
 static Sys_var_on_access_global<Sys_var_mybool,
                            PRIV_SET_SYSTEM_GLOBAL_VAR_BINLOG_LEGACY_EVENT_POS>
@@ -4746,6 +4833,14 @@ static Sys_var_ulonglong Sys_tmp_memory_table_size(
        VALID_RANGE(0, (ulonglong)~(intptr)0), DEFAULT(16*1024*1024),
        BLOCK_SIZE(16384));
 
+static Sys_var_mybool Sys_tmp_memory_table_blobs(
+       "tmp_memory_table_blobs",
+       "Keep internal temporary tables with BLOB or TEXT columns in memory, "
+       "unless a blob is part of a key. The blob data counts towards "
+       "tmp_memory_table_size",
+       SESSION_VAR(tmp_memory_table_blobs), CMD_LINE(OPT_ARG),
+       DEFAULT(FALSE));
+
 static Sys_var_ulonglong Sys_tmp_disk_table_size(
        "tmp_disk_table_size",
        "Max size for data for an internal temporary on-disk MyISAM or Aria table",
@@ -7332,6 +7427,38 @@ Sys_binlog_gtid_index_span_min(
        VALID_RANGE(1, 1024*1024L*1024L), DEFAULT(65536), BLOCK_SIZE(1));
 
 
+static const char *binlog_dependency_tracking_names[]=
+{ "COMMIT_ORDER", "WRITESET", NullS };
+
+static bool fix_binlog_dependency_tracking(sys_var *self, THD *thd,
+                                           enum_var_type type)
+{
+  /* Transactions binlogged meanwhile are not in the history */
+  rpl_writeset_history.reset();
+  return false;
+}
+
+static Sys_var_enum Sys_binlog_transaction_dependency_tracking(
+       "binlog_transaction_dependency_tracking",
+       "How the dependencies between transactions, used by the parallel "
+       "replica, are found. COMMIT_ORDER: transactions that group commit "
+       "together are independent. WRITESET: in addition, a transaction that "
+       "changes no row with the same primary or unique key value as an "
+       "earlier transaction is independent of it",
+       GLOBAL_VAR(opt_binlog_dependency_tracking), CMD_LINE(REQUIRED_ARG),
+       binlog_dependency_tracking_names,
+       DEFAULT(BINLOG_DEPENDENCY_TRACKING_COMMIT_ORDER),
+       NO_MUTEX_GUARD, NOT_IN_BINLOG, ON_CHECK(0),
+       ON_UPDATE(fix_binlog_dependency_tracking));
+
+static Sys_var_ulong Sys_binlog_transaction_dependency_history_size(
+       "binlog_transaction_dependency_history_size",
+       "Maximum number of row key hashes kept to find the dependencies between "
+       "transactions with binlog_transaction_dependency_tracking=WRITESET",
+       GLOBAL_VAR(opt_binlog_dependency_history_size), CMD_LINE(REQUIRED_ARG),
+       VALID_RANGE(1, 1000000), DEFAULT(25000), BLOCK_SIZE(1));
+
+
 static bool check_pseudo_slave_mode(sys_var *self, THD *thd, set_var *var)
 {
   longlong previous_val= thd->variables.pseudo_slave_mode;
@@ -3215,7 +3215,8 @@ int TABLE_SHARE::init_from_binary_frm_image(THD *thd, bool write,
           share->incompatible_version|= HA_CREATE_USED_CHARSET;
         key_part->type= field->key_type();
 
-        if (field->invisible > INVISIBLE_USER && !field->vers_sys_field())
+        if (field->invisible > INVISIBLE_USER && !field->vers_sys_field() &&
+            !field->is_key_expression())
           if (keyinfo->algorithm != HA_KEY_ALG_LONG_HASH)
             keyinfo->flags |= HA_INVISIBLE_KEY;
         if (field->null_ptr)
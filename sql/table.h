@@ -1433,6 +1433,7 @@ struct TABLE
     ORDER       *group;                   /* only for temporary tables */
     void        *context;                 /* only for hlindexes */
   };
+  void *bulk_context;                   /* only for hlindexes, bulk insert */
   String	alias;            	  /* alias or table name */
   uchar		*null_flags;
   MY_BITMAP     def_read_set, def_write_set, tmp_set;
@@ -1871,12 +1872,14 @@ struct TABLE
 
   int hlindex_open(uint nr);
   int hlindex_lock(uint nr);
-  int hlindex_read_first(uint nr, Item *item, ulonglong limit);
+  int hlindex_read_first(uint nr, Item *item, ulonglong limit, Item *cond);
   int hlindex_read_next();
   int hlindex_read_end();
 
   int open_hlindexes_for_write();
   int hlindexes_on_insert();
+  int hlindexes_start_bulk_insert();
+  int hlindexes_end_bulk_insert(bool abort);
   int hlindexes_on_update();
   int hlindexes_on_delete(const uchar *buf);
   int hlindexes_on_delete_all(bool truncate);
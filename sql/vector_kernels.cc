@@ -0,0 +1,282 @@
+/*
+   Copyright (c) 2026, MariaDB plc
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA
+*/
+
+#include "vector_kernels.h"
+#include <my_bit.h>
+#include <cmath>
+
+#if defined __x86_64__ && !defined __APPLE__ && \
+    (__GNUC__ >= 11 || (defined __clang_major__ && __clang_major__ >= 9))
+# include <cpuid.h>
+# include <immintrin.h>
+# define USE_AVX512
+# define AVX512 __attribute__((target("avx512f,avx512bw")))
+# define AVX512_VNNI __attribute__((target("avx512f,avx512bw,avx512vnni")))
+# define AVX512_VPOPCNTDQ \
+  __attribute__((target("avx512f,avx512bw,avx512vpopcntdq")))
+#endif
+
+/************* generic ****************************************************/
+
+static float dot_product_int8_generic(const int8_t *v1, const int8_t *v2,
+                                      size_t len)
+{
+  int32_t d= 0;
+  for (size_t i= 0; i < len; i++)
+    d+= int16_t(v1[i]) * int16_t(v2[i]);
+  return static_cast<float>(d);
+}
+
+static size_t hamming_distance_generic(const uchar *v1, const uchar *v2,
+                                       size_t len)
+{
+  size_t differ= 0;
+  for (size_t i= 0; i < len; i+= 8)
+    differ+= my_count_bits(uint8korr(v1 + i) ^ uint8korr(v2 + i));
+  return differ;
+}
+
+static double distance_euclidean_generic(const float *v1, const float *v2,
+                                         size_t len)
+{
+  double d= 0;
+  for (size_t i= 0; i < len; i++, v1++, v2++)
+  {
+    double dist= get_float(v1) - get_float(v2);
+    d+= dist * dist;
+  }
+  return sqrt(d);
+}
+
+static double distance_cosine_generic(const float *v1, const float *v2,
+                                      size_t len)
+{
+  double dotp=0, abs1=0, abs2=0;
+  for (size_t i= 0; i < len; i++, v1++, v2++)
+  {
+    float f1= get_float(v1), f2= get_float(v2);
+    abs1+= f1 * f1;
+    abs2+= f2 * f2;
+    dotp+= f1 * f2;
+  }
+  return 1 - dotp/sqrt(abs1*abs2);
+}
+
+static const Vec_kernels kernels_generic=
+{
+  "generic", dot_product_int8_generic, hamming_distance_generic,
+  distance_euclidean_generic, distance_cosine_generic
+};
+
+#ifdef USE_AVX512
+/************* AVX512 *****************************************************/
+/*
+  Coordinates are read with masked loads, so the vectors need no padding.
+  Products are computed and summed up like in the generic code: float
+  products for cosine, double squares of float differences for euclidean,
+  all added in doubles. Only the order of additions differs.
+*/
+
+static constexpr size_t AVX512_floats= 512/8/sizeof(float);
+
+AVX512
+static inline __m512d low_pd(__m512 v)
+{
+  return _mm512_cvtps_pd(_mm512_castps512_ps256(v));
+}
+
+AVX512
+static inline __m512d high_pd(__m512 v)
+{
+  return _mm512_cvtps_pd(_mm256_castpd_ps(
+                           _mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)));
+}
+
+AVX512
+static double distance_euclidean_avx512(const float *v1, const float *v2,
+                                        size_t len)
+{
+  __m512d d= _mm512_setzero_pd();
+  for (size_t i= 0; i < len; i+= AVX512_floats)
+  {
+    __mmask16 mask= len - i >= AVX512_floats ? 0xffff
+                    : static_cast<__mmask16>((1U << (len - i)) - 1);
+    __m512 diff= _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, v1 + i),
+                               _mm512_maskz_loadu_ps(mask, v2 + i));
+    __m512d lo= low_pd(diff), hi= high_pd(diff);
+    d= _mm512_fmadd_pd(lo, lo, d);
+    d= _mm512_fmadd_pd(hi, hi, d);
+  }
+  return sqrt(_mm512_reduce_add_pd(d));
+}
+
+AVX512
+static double distance_cosine_avx512(const float *v1, const float *v2,
+                                     size_t len)
+{
+  __m512d dotp= _mm512_setzero_pd(), abs1= dotp, abs2= dotp;
+  for (size_t i= 0; i < len; i+= AVX512_floats)
+  {
+    __mmask16 mask= len - i >= AVX512_floats ? 0xffff
+                    : static_cast<__mmask16>((1U << (len - i)) - 1);
+    __m512 f1= _mm512_maskz_loadu_ps(mask, v1 + i);
+    __m512 f2= _mm512_maskz_loadu_ps(mask, v2 + i);
+    __m512 sq1= _mm512_mul_ps(f1, f1), sq2= _mm512_mul_ps(f2, f2);
+    __m512 prod= _mm512_mul_ps(f1, f2);
+    abs1= _mm512_add_pd(_mm512_add_pd(abs1, low_pd(sq1)), high_pd(sq1));
+    abs2= _mm512_add_pd(_mm512_add_pd(abs2, low_pd(sq2)), high_pd(sq2));
+    dotp= _mm512_add_pd(_mm512_add_pd(dotp, low_pd(prod)), high_pd(prod));
+  }
+  return 1 - _mm512_reduce_add_pd(dotp)/sqrt(_mm512_reduce_add_pd(abs1) *
+                                             _mm512_reduce_add_pd(abs2));
+}
+
+AVX512
+static inline __mmask64 tail_mask64(size_t left)
+{
+  return left >= 64 ? ~0ULL : (1ULL << left) - 1;
+}
+
+/* sign-extends to int16 and multiplies with vpmaddwd */
+AVX512
+static float dot_product_int8_avx512(const int8_t *v1, const int8_t *v2,
+                                     size_t len)
+{
+  __m512i d= _mm512_setzero_si512();
+  for (size_t i= 0; i < len; i+= 64)
+  {
+    __mmask64 mask= tail_mask64(len - i);
+    __m512i a= _mm512_maskz_loadu_epi8(mask, v1 + i);
+    __m512i b= _mm512_maskz_loadu_epi8(mask, v2 + i);
+    d= _mm512_add_epi32(d, _mm512_madd_epi16(
+             _mm512_cvtepi8_epi16(_mm512_castsi512_si256(a)),
+             _mm512_cvtepi8_epi16(_mm512_castsi512_si256(b))));
+    d= _mm512_add_epi32(d, _mm512_madd_epi16(
+             _mm512_cvtepi8_epi16(_mm512_extracti64x4_epi64(a, 1)),
+             _mm512_cvtepi8_epi16(_mm512_extracti64x4_epi64(b, 1))));
+  }
+  return static_cast<float>(_mm512_reduce_add_epi32(d));
+}
+
+/*
+  vpdpbusd multiplies unsigned by signed bytes. a+128 is unsigned,
+  and (a+128)*b - 128*b = a*b
+*/
+AVX512_VNNI
+static float dot_product_int8_vnni(const int8_t *v1, const int8_t *v2,
+                                   size_t len)
+{
+  const __m512i bias= _mm512_set1_epi8(-128), ones= _mm512_set1_epi8(1);
+  __m512i d= _mm512_setzero_si512(), sum2= d;
+  for (size_t i= 0; i < len; i+= 64)
+  {
+    __mmask64 mask= tail_mask64(len - i);
+    __m512i a= _mm512_maskz_loadu_epi8(mask, v1 + i);
+    __m512i b= _mm512_maskz_loadu_epi8(mask, v2 + i);
+    d= _mm512_dpbusd_epi32(d, _mm512_xor_si512(a, bias), b);
+    sum2= _mm512_dpbusd_epi32(sum2, ones, b);
+  }
+  return static_cast<float>(_mm512_reduce_add_epi32(d) -
+                            128 * _mm512_reduce_add_epi32(sum2));
+}
+
+AVX512_VPOPCNTDQ
+static size_t hamming_distance_vpopcntdq(const uchar *v1, const uchar *v2,
+                                         size_t len)
+{
+  __m512i d= _mm512_setzero_si512();
+  for (size_t i= 0; i < len; i+= 64)
+  {
+    __mmask8 mask= len - i >= 64 ? 0xff
+                   : static_cast<__mmask8>((1U << ((len - i)/8)) - 1);
+    __m512i a= _mm512_maskz_loadu_epi64(mask, v1 + i);
+    __m512i b= _mm512_maskz_loadu_epi64(mask, v2 + i);
+    d= _mm512_add_epi64(d, _mm512_popcnt_epi64(_mm512_xor_si512(a, b)));
+  }
+  return static_cast<size_t>(_mm512_reduce_add_epi64(d));
+}
+
+static const Vec_kernels kernels_avx512=
+{
+  "AVX512", dot_product_int8_avx512, hamming_distance_generic,
+  distance_euclidean_avx512, distance_cosine_avx512
+};
+
+static const Vec_kernels kernels_avx512_vnni=
+{
+  "AVX512_VNNI", dot_product_int8_vnni, hamming_distance_generic,
+  distance_euclidean_avx512, distance_cosine_avx512
+};
+
+static const Vec_kernels kernels_avx512_vnni_vpopcntdq=
+{
+  "AVX512_VNNI_VPOPCNTDQ", dot_product_int8_vnni, hamming_distance_vpopcntdq,
+  distance_euclidean_avx512, distance_cosine_avx512
+};
+
+__attribute__((target("xsave")))
+static bool os_have_avx512()
+{
+  // The following flags must be set: SSE, AVX, OPMASK, ZMM_HI256, HI16_ZMM
+  return !(~_xgetbv(0 /*_XCR_XFEATURE_ENABLED_MASK*/) & 0xe6);
+}
+
+static constexpr uint32 cpuid_ecx_AVX_AND_XSAVE= 1U << 28 | 1U << 27;
+static constexpr uint32 cpuid7_ebx_AVX512F_AND_BW= 1U << 16 | 1U << 30;
+static constexpr uint32 cpuid7_ecx_VNNI= 1U << 11;
+static constexpr uint32 cpuid7_ecx_VPOPCNTDQ= 1U << 14;
+
+/* ecx of cpuid leaf 7, if AVX512F and AVX512BW are usable, or 0 */
+static uint32 have_avx512()
+{
+  uint32 eax= 0, ebx= 0, ecx= 0, edx= 0;
+  __cpuid(1, eax, ebx, ecx, edx);
+  if ((~ecx & cpuid_ecx_AVX_AND_XSAVE) || !os_have_avx512())
+    return 0;
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  if (~ebx & cpuid7_ebx_AVX512F_AND_BW)
+    return 0;
+  return ecx | 1; // not 0 even if no more features
+}
+#endif
+
+const Vec_kernels *vec_kernels_for(vec_kernels_isa isa)
+{
+  if (isa == VEC_KERNELS_GENERIC)
+    return &kernels_generic;
+#ifdef USE_AVX512
+  if (uint32 ecx= have_avx512())
+  {
+    if (isa == VEC_KERNELS_AVX512)
+      return &kernels_avx512;
+    if (isa == VEC_KERNELS_AVX512_VNNI && ecx & cpuid7_ecx_VNNI)
+      return ecx & cpuid7_ecx_VPOPCNTDQ ? &kernels_avx512_vnni_vpopcntdq
+                                        : &kernels_avx512_vnni;
+  }
+#endif
+  return nullptr;
+}
+
+static const Vec_kernels *choose_vec_kernels()
+{
+  for (uint isa= VEC_KERNELS_ISA_COUNT; --isa; )
+    if (const Vec_kernels *k= vec_kernels_for(static_cast<vec_kernels_isa>(isa)))
+      return k;
+  return &kernels_generic;
+}
+
+const Vec_kernels *const vec_kernels= choose_vec_kernels();
@@ -0,0 +1,52 @@
+/*
+   Copyright (c) 2026, MariaDB plc
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA
+*/
+
+#ifndef VECTOR_KERNELS_INCLUDED
+#define VECTOR_KERNELS_INCLUDED
+
+/*
+  Distance kernels for vectors, chosen at startup for the CPU, like crc32c
+  in mysys.
+
+  The int16 dot product of MHNSW is not here, it is multiversioned
+  together with the memory layout of FVector in vector_mhnsw.cc.
+*/
+
+#include <my_global.h>
+
+struct Vec_kernels
+{
+  const char *name;
+  /* dot product of two vectors of len int8 coordinates */
+  float (*dot_product_int8)(const int8_t *v1, const int8_t *v2, size_t len);
+  /* number of different bits of two arrays of len bytes, len % 8 == 0 */
+  size_t (*hamming_distance)(const uchar *v1, const uchar *v2, size_t len);
+  /* exact distances of two float vectors, for VEC_DISTANCE_*() */
+  double (*distance_euclidean)(const float *v1, const float *v2, size_t len);
+  double (*distance_cosine)(const float *v1, const float *v2, size_t len);
+};
+
+enum vec_kernels_isa { VEC_KERNELS_GENERIC, VEC_KERNELS_AVX512,
+                       VEC_KERNELS_AVX512_VNNI, VEC_KERNELS_ISA_COUNT };
+
+/* kernels for the instruction set, or NULL if the CPU does not support it */
+const Vec_kernels *vec_kernels_for(vec_kernels_isa isa);
+
+/* the fastest kernels the CPU supports */
+extern const Vec_kernels *const vec_kernels;
+
+#endif /* VECTOR_KERNELS_INCLUDED */
@@ -19,10 +19,12 @@
 #include "key.h"                                // key_copy()
 #include "create_options.h"
 #include "table_cache.h"
+#include "opt_range.h"                          // make_select()
 #include "vector_mhnsw.h"
 #include <scope.h>
 #include <my_atomic_wrapper.h>
 #include "bloom_filters.h"
+#include "vector_kernels.h"
 
 // distance can be a little bit < 0 because of fast math
 static constexpr float NEAREST = -1.0f;
@@ -99,6 +101,19 @@ static MYSQL_THDVAR_UINT(ef_search, PLUGIN_VAR_RQCMDARG,
        "vector index for ORDER BY ... LIMIT N queries. The search will never "
        "search for less rows than that, even if LIMIT is smaller",
        nullptr, nullptr, 20, 1, max_ef, 1);
+static MYSQL_THDVAR_UINT(brute_force_rows, PLUGIN_VAR_RQCMDARG,
+       "For ORDER BY ... LIMIT N queries with a WHERE condition. If a "
+       "range on another index matches at most that many rows, or the "
+       "table has at most that many rows, the rows that satisfy the "
+       "condition are all compared to the query vector instead of "
+       "searching the vector index. 0 means always search the index",
+       nullptr, nullptr, 1000, 0, UINT_MAX32, 1);
+static MYSQL_THDVAR_UINT(build_threads, PLUGIN_VAR_RQCMDARG,
+       "Number of threads to build a vector index with, when ALTER TABLE "
+       "or LOAD DATA inserts into an empty index. With more than one "
+       "thread the index is built faster, but it depends on how the "
+       "threads interleave",
+       nullptr, nullptr, 1, 1, 256, 1);
 static MYSQL_THDVAR_UINT(default_m, PLUGIN_VAR_RQCMDARG,
        "Larger values mean slower SELECTs and INSERTs, larger index size "
        "and higher memory consumption but more accurate results",
@@ -111,10 +126,24 @@ static MYSQL_THDVAR_ENUM(default_distance, PLUGIN_VAR_RQCMDARG,
        "Distance function to build the vector index for",
        nullptr, nullptr, EUCLIDEAN, &distances);
 
+/*
+  how coordinates are stored in the index. int8 and binary take 2x and 16x
+  less memory than int16, but only approximate the vector, so the result
+  of the search is sorted again by the exact distance
+*/
+enum quantization_type : uint { INT16, INT8, BINARY };
+static const char *quantization_names[]= { "int16", "int8", "binary", nullptr };
+static TYPELIB quantizations= CREATE_TYPELIB_FOR(quantization_names);
+static MYSQL_THDVAR_ENUM(default_quantization, PLUGIN_VAR_RQCMDARG,
+       "How to store vectors in the vector index. int8 and binary use "
+       "less memory, but the index search is less accurate",
+       nullptr, nullptr, INT16, &quantizations);
+
 struct ha_index_option_struct
 {
   ulonglong M; // option struct does not support uint
   metric_type metric;
+  quantization_type quantization;
 };
 
 enum Graph_table_fields {
@@ -129,6 +158,10 @@ class FVectorNode;
 
 /*
   One vector, an array of coordinates in ctx->vec_len dimensions
+
+  Coordinates are int16, int8 (dims[] is then an array of int8_t),
+  or only the sign of the coordinate, one bit each, zero-padded to
+  a multiple of 64 bits.
 */
 #pragma pack(push, 1)
 struct FVector
@@ -141,17 +174,26 @@ struct FVector
 
   uchar *data() const { return (uchar*)(&scale); }
 
-  static size_t data_size(size_t n)
-  { return data_header + n*2; }
+  static size_t code_size(size_t n, quantization_type q)
+  { return q == INT16 ? n*2 : q == INT8 ? n : MY_ALIGN(n, 64)/8; }
+
+  static size_t data_size(size_t n, quantization_type q)
+  { return data_header + code_size(n, q); }
 
-  static size_t data_to_value_size(size_t data_size)
-  { return (data_size - data_header)*2; }
+  static size_t alloc_size(size_t n, quantization_type q)
+  { return alloc_size((code_size(n, q) + 1)/2); }
 
   static const FVector *create(const MHNSW_Share *ctx, void *mem, const void *src);
 
-  void postprocess(bool use_subdist, size_t vec_len)
+  void postprocess(bool use_subdist, size_t vec_len, quantization_type q)
   {
     int16_t *d= dims;
+    if (q != INT16)
+    {
+      subabs2= 0;
+      abs2= scale * scale * dot_product(this, vec_len, q) / 2;
+      return;
+    }
     fix_tail(vec_len);
     if (use_subdist)
     {
@@ -353,10 +395,31 @@ struct FVector
   void fix_tail(size_t) { }
 #endif
 
-  float distance_to(const FVector *other, size_t vec_len) const
+  /************* int8 and binary, see vector_kernels.cc ******************/
+  float dot_product(const FVector *other, size_t vec_len,
+                    quantization_type q) const
+  {
+    switch (q) {
+    case INT8:
+      return vec_kernels->dot_product_int8((const int8_t*)dims,
+                                           (const int8_t*)other->dims, vec_len);
+    case BINARY:
+      /* coordinates are +1 or -1, so it's len minus twice the Hamming distance */
+      return static_cast<float>(vec_len) - 2 * static_cast<float>(
+        vec_kernels->hamming_distance((const uchar*)dims,
+                                      (const uchar*)other->dims,
+                                      code_size(vec_len, BINARY)));
+    case INT16:
+      break;
+    }
+    return dot_product(dims, other->dims, vec_len);
+  }
+
+  float distance_to(const FVector *other, size_t vec_len,
+                    quantization_type q) const
   {
     return abs2 + other->abs2 - scale * other->scale *
-           dot_product(dims, other->dims, vec_len);
+           dot_product(other, vec_len, q);
   }
 
   float distance_greater_than(const FVector *other, size_t vec_len, float than,
@@ -490,7 +553,7 @@ class MHNSW_Share : public Sql_alloc
   void *alloc_node_internal()
   {
     return alloc_root(&root, sizeof(FVectorNode) + gref_len + tref_len
-                      + FVector::alloc_size(vec_len));
+                      + FVector::alloc_size(vec_len, quantization));
   }
 
 protected:
@@ -509,12 +572,14 @@ class MHNSW_Share : public Sql_alloc
   const uint gref_len;
   const uint M;
   metric_type metric;
+  quantization_type quantization;
   bool use_subdist;
 
   MHNSW_Share(TABLE *t)
     : tref_len(t->file->ref_length), gref_len(t->hlindex->file->ref_length),
       M(static_cast<uint>(t->s->key_info[t->s->keys].option_struct->M)),
-      metric(t->s->key_info[t->s->keys].option_struct->metric)
+      metric(t->s->key_info[t->s->keys].option_struct->metric),
+      quantization(t->s->key_info[t->s->keys].option_struct->quantization)
   {
     mysql_rwlock_init(PSI_INSTRUMENT_ME, &commit_lock);
     mysql_mutex_init(PSI_INSTRUMENT_ME, &cache_lock, MY_MUTEX_INIT_FAST);
@@ -555,7 +620,7 @@ class MHNSW_Share : public Sql_alloc
   {
     byte_len= len;
     vec_len= len / sizeof(float);
-    use_subdist= vec_len >= subdist_part * 2;
+    use_subdist= vec_len >= subdist_part * 2 && quantization == INT16;
   }
 
   static int acquire(MHNSW_Share **ctx, TABLE *table, bool for_update);
@@ -666,6 +731,14 @@ class MHNSW_Share : public Sql_alloc
     stats.subdist.add(addend.subdist);
     mysql_mutex_unlock(&cache_lock);
   }
+
+  bool cache_is_full()
+  {
+    mysql_mutex_lock(&cache_lock);
+    bool res= root_size(&root) > mhnsw_max_cache_size;
+    mysql_mutex_unlock(&cache_lock);
+    return res;
+  }
 };
 
 /*
@@ -881,7 +954,7 @@ int MHNSW_Share::acquire(MHNSW_Share **ctx, TABLE *table, bool for_update)
     return err;
 
   graph->file->position(graph->record[0]);
-  (*ctx)->set_lengths(FVector::data_to_value_size(graph->field[FIELD_VEC]->value_length()));
+  (*ctx)->set_lengths(table->key_info[table->s->keys].key_part->field->field_length);
 
   if (int err= graph->file->info(HA_STATUS_VARIABLE))
     return err;
@@ -898,16 +971,47 @@ int MHNSW_Share::acquire(MHNSW_Share **ctx, TABLE *table, bool for_update)
 const FVector *FVector::create(const MHNSW_Share *ctx, void *mem, const void *src)
 {
   float scale=0, *v= (float *)src;
-  for (size_t i= 0; i < ctx->vec_len; i++)
-    scale= std::max(scale, std::abs(get_float(v + i)));
-
   FVector *vec= align_ptr(mem);
-  vec->scale= scale ? scale/32767 : 1;
-  if (std::round(scale/vec->scale) > 32767)
-    vec->scale= std::nextafter(vec->scale, FLT_MAX);
-  for (size_t i= 0; i < ctx->vec_len; i++)
-    vec->dims[i] = static_cast<int16_t>(std::round(get_float(v + i) / vec->scale));
-  vec->postprocess(ctx->use_subdist, ctx->vec_len);
+
+  if (ctx->quantization == BINARY)
+  {
+    /*
+      the vector becomes scale*(±1, ±1, ...), with the scale that keeps
+      its length, so that abs2 stays exact
+    */
+    uchar *bits= (uchar*)vec->dims;
+    bzero(bits, code_size(ctx->vec_len, BINARY));
+    for (size_t i= 0; i < ctx->vec_len; i++)
+    {
+      float x= get_float(v + i);
+      scale+= x * x;
+      if (x > 0)
+        bits[i / 8]|= 1 << (i % 8);
+    }
+    vec->scale= scale ? std::sqrt(scale/ctx->vec_len) : 1;
+  }
+  else
+  {
+    const float max_code= ctx->quantization == INT8 ? 127 : 32767;
+    for (size_t i= 0; i < ctx->vec_len; i++)
+      scale= std::max(scale, std::abs(get_float(v + i)));
+
+    vec->scale= scale ? scale/max_code : 1;
+    if (std::round(scale/vec->scale) > max_code)
+      vec->scale= std::nextafter(vec->scale, FLT_MAX);
+    if (ctx->quantization == INT8)
+    {
+      int8_t *dims= (int8_t*)vec->dims;
+      for (size_t i= 0; i < ctx->vec_len; i++)
+        dims[i]= static_cast<int8_t>(std::round(get_float(v + i) / vec->scale));
+    }
+    else
+    {
+      for (size_t i= 0; i < ctx->vec_len; i++)
+        vec->dims[i] = static_cast<int16_t>(std::round(get_float(v + i) / vec->scale));
+    }
+  }
+  vec->postprocess(ctx->use_subdist, ctx->vec_len, ctx->quantization);
   if (ctx->metric == COSINE)
   {
     if (vec->abs2 > 0.0f)
@@ -946,7 +1050,7 @@ FVectorNode::FVectorNode(MHNSW_Share *ctx_, const void *tref_, uint8_t layer,
 
 float FVectorNode::distance_to(const FVector *other) const
 {
-  return vec->distance_to(other, ctx->vec_len);
+  return vec->distance_to(other, ctx->vec_len, ctx->quantization);
 }
 
 float FVectorNode::distance_greater_than(const FVector *other, float than,
@@ -1007,11 +1111,11 @@ int FVectorNode::load_from_record(TABLE *graph)
   if (unlikely(!v))
     return my_errno= HA_ERR_CRASHED;
 
-  if (v->length() != FVector::data_size(ctx->vec_len))
+  if (v->length() != FVector::data_size(ctx->vec_len, ctx->quantization))
     return my_errno= HA_ERR_CRASHED;
   FVector *vec_ptr= FVector::align_ptr(tref() + tref_len());
   memcpy(vec_ptr->data(), v->ptr(), v->length());
-  vec_ptr->postprocess(ctx->use_subdist, ctx->vec_len);
+  vec_ptr->postprocess(ctx->use_subdist, ctx->vec_len, ctx->quantization);
 
   longlong layer= graph->field[FIELD_LAYER]->val_int();
   if (layer > 100) // 10e30 nodes at M=2, more at larger M's
@@ -1059,17 +1163,47 @@ const uchar *FVectorNode::get_key(const void *elem, size_t *key_len, my_bool)
 }
 
 
+/*
+  WHERE condition of a SELECT, checked during the search in layer 0.
+
+  Only nodes that satisfy it are returned, but the graph is still
+  traversed through nodes that don't, otherwise with a selective
+  condition most of the graph would be unreachable.
+*/
+struct Search_filter : public Sql_alloc
+{
+  TABLE *table;
+  Item *cond;
+  Search_filter(TABLE *t, Item *c) : table(t), cond(c) {}
+  int check(const FVectorNode *node, bool *res)
+  {
+    *res= false;
+    if (table->in_use->check_killed())
+      return HA_ERR_ABORTED_BY_USER;
+    int err= table->file->ha_rnd_pos(table->record[0], node->tref());
+    if (err == HA_ERR_KEY_NOT_FOUND || err == HA_ERR_RECORD_DELETED)
+      return 0;
+    if (!err)
+      *res= cond->val_bool();
+    return err;
+  }
+};
+
 /* common set of params for many search/select functions */
 struct MHNSW_param
 {
   MHNSW_Share *ctx;
   TABLE *graph;
+  MEM_ROOT *root;               // for Visited and other temporary objects
+  Search_filter *filter= nullptr;
   int layer;
   Stats acc;
   dgt_mode mode;
   double max_est_size;
+  bool bulk= false;             // building the graph in memory, see MHNSW_Bulk
+  bool concurrent= false;       // other threads change the graph too
   MHNSW_param(MHNSW_Share *ctx, TABLE *graph, int layer)
-    : ctx(ctx), graph(graph), layer(layer)
+    : ctx(ctx), graph(graph), root(graph->in_use->mem_root), layer(layer)
   {
     Stats stats;
     ctx->read_stats(&stats);
@@ -1157,7 +1291,7 @@ static int select_neighbors(MHNSW_param *p, FVectorNode *target,
   if (pq.init(max_ef, false, Visited::cmp))
     return my_errno= HA_ERR_OUT_OF_MEM;
 
-  MEM_ROOT * const root= p->graph->in_use->mem_root;
+  MEM_ROOT * const root= p->root;
   auto discarded= (Visited**)my_safe_alloca(sizeof(Visited**)*max_neighbor_connections);
   size_t discarded_num= 0;
   Neighborhood &neighbors= target->neighbors[p->layer];
@@ -1213,7 +1347,8 @@ int FVectorNode::save(TABLE *graph)
     graph->field[FIELD_TREF]->set_notnull();
     graph->field[FIELD_TREF]->store_binary(tref(), tref_len());
   }
-  graph->field[FIELD_VEC]->store_binary(vec->data(), FVector::data_size(ctx->vec_len));
+  graph->field[FIELD_VEC]->store_binary(vec->data(),
+                          FVector::data_size(ctx->vec_len, ctx->quantization));
 
   size_t total_size= 0;
   for (size_t i=0; i <= max_layer; i++)
@@ -1254,19 +1389,35 @@ int FVectorNode::save(TABLE *graph)
 static int update_second_degree_neighbors(MHNSW_param *p, FVectorNode *node)
 {
   const uint max_neighbors= p->ctx->max_neighbors(p->layer);
+  Neighborhood &neighbors= node->neighbors[p->layer];
+  FVectorNode **links= neighbors.links;
+  size_t num= neighbors.num;
+  if (p->concurrent)
+  {
+    // once the node is a neighbor of others, they can change its neighbors
+    links= (FVectorNode**)alloc_root(p->root, sizeof(*links)*max_neighbors);
+    uint ticket= p->ctx->lock_node(node);
+    num= neighbors.num;
+    memcpy(links, neighbors.links, sizeof(*links)*num);
+    p->ctx->unlock_node(ticket);
+  }
   // it seems that one could update nodes in the gref order
   // to avoid InnoDB deadlocks, but it produces no noticeable effect
-  for (size_t i=0; i < node->neighbors[p->layer].num; i++)
+  for (size_t i=0; i < num; i++)
   {
-    FVectorNode *neigh= node->neighbors[p->layer].links[i];
+    FVectorNode *neigh= links[i];
     Neighborhood &neighneighbors= neigh->neighbors[p->layer];
+    uint ticket= p->concurrent ? p->ctx->lock_node(neigh) : 0;
+    int err= 0;
     if (neighneighbors.num < max_neighbors)
       neigh->push_neighbor(p->layer, node);
     else
-      if (int err= select_neighbors(p, neigh, neighneighbors, node,
-                                    max_neighbors))
-        return err;
-    if (int err= neigh->save(p->graph))
+      err= select_neighbors(p, neigh, neighneighbors, node, max_neighbors);
+    if (p->concurrent)
+      p->ctx->unlock_node(ticket);
+    if (err)
+      return err;
+    if (!p->bulk && (err= neigh->save(p->graph)))
       return err;
   }
   return 0;
@@ -1290,9 +1441,9 @@ static int search_layer(MHNSW_param *p, const FVector *target, float threshold,
 {
   DBUG_ASSERT(inout->num > 0);
 
-  MEM_ROOT * const root= p->graph->in_use->mem_root;
+  MEM_ROOT * const root= p->root;
   Queue<Visited> candidates, best;
-  bool skip_deleted;
+  bool skip_deleted, passed;
   uint ef= result_size;
 
   if (construction)
@@ -1317,6 +1468,13 @@ static int search_layer(MHNSW_param *p, const FVector *target, float threshold,
   candidates.init(max_ef, false, Visited::cmp);
   best.init(ef, true, Visited::cmp);
 
+  Search_filter *filter= skip_deleted ? p->filter : nullptr;
+
+  // with p->concurrent, neighbors are copied under the node lock
+  const size_t max_links= MY_ALIGN(p->ctx->max_neighbors(p->layer), 8);
+  FVectorNode **copy= p->concurrent
+        ? (FVectorNode**)alloc_root(root, sizeof(*copy)*max_links) : nullptr;
+
   DBUG_ASSERT(inout->num <= result_size);
   for (size_t i=0; i < inout->num; i++)
   {
@@ -1326,6 +1484,13 @@ static int search_layer(MHNSW_param *p, const FVector *target, float threshold,
     candidates.push(v);
     if ((skip_deleted && v->node->deleted) || threshold > NEAREST)
       continue;
+    if (filter)
+    {
+      if (int err= filter->check(v->node, &passed))
+        return err;
+      if (!passed)
+        continue;
+    }
     best.push(v);
   }
 
@@ -1340,7 +1505,17 @@ static int search_layer(MHNSW_param *p, const FVector *target, float threshold,
     visited.flush();
 
     Neighborhood &neighbors= cur.node->neighbors[p->layer];
-    FVectorNode **links= neighbors.links, **end= links + neighbors.num;
+    FVectorNode **links= neighbors.links, **end;
+    if (copy)
+    {
+      uint ticket= p->ctx->lock_node(cur.node);
+      memcpy(copy, links, sizeof(*copy)*max_links);
+      end= copy + neighbors.num;
+      p->ctx->unlock_node(ticket);
+      links= copy;
+    }
+    else
+      end= links + neighbors.num;
     for (; links < end; links+= 8)
     {
       uint8_t res= visited.seen(links);
@@ -1362,6 +1537,13 @@ static int search_layer(MHNSW_param *p, const FVector *target, float threshold,
           candidates.safe_push(v);
           if (skip_deleted && v->node->deleted)
             continue;
+          if (filter)
+          {
+            if (int err= filter->check(v->node, &passed))
+              return err;
+            if (!passed)
+              continue;
+          }
           best.push(v);
           furthest_best= lenient_furthest(best, p->acc.diameter, leniency);
         }
@@ -1379,6 +1561,13 @@ static int search_layer(MHNSW_param *p, const FVector *target, float threshold,
               continue;
             if (v->distance_to_target < best.top()->distance_to_target)
             {
+              if (filter)
+              {
+                if (int err= filter->check(v->node, &passed))
+                  return err;
+                if (!passed)
+                  continue;
+              }
               best.replace_top(v);
               furthest_best= lenient_furthest(best, p->acc.diameter, leniency);
             }
@@ -1404,6 +1593,281 @@ static int search_layer(MHNSW_param *p, const FVector *target, float threshold,
 }
 
 
+/*
+  finds neighbors of a new node on all its layers, starting from the
+  given entry point of the graph. The node is not saved
+*/
+static int find_neighbors(MHNSW_param *p, FVectorNode *target,
+                          FVectorNode *start)
+{
+  const size_t max_found= p->ctx->max_neighbors(0);
+  Neighborhood candidates;
+  candidates.init((FVectorNode**)alloc_root(p->root,
+                            sizeof(FVectorNode*)*(max_found + 7)), max_found);
+  candidates.links[candidates.num++]= start;
+
+  for (p->layer= start->max_layer; p->layer > target->max_layer; p->layer--)
+  {
+    if (int err= search_layer(p, target->vec, NEAREST, 1, &candidates, false))
+      return err;
+  }
+
+  for (; p->layer >= 0; p->layer--)
+  {
+    uint max_neighbors= p->ctx->max_neighbors(p->layer);
+    if (int err= search_layer(p, target->vec, NEAREST, max_neighbors,
+                              &candidates, true))
+      return err;
+
+    if (int err= select_neighbors(p, target, candidates, 0, max_neighbors))
+      return err;
+  }
+  return 0;
+}
+
+
+static uint8_t random_layer(THD *thd, const MHNSW_Share *ctx, uint8_t max_layer)
+{
+  const double NORMALIZATION_FACTOR= 1 / std::log(ctx->M);
+  double log= -std::log(my_rnd(&thd->rand)) * NORMALIZATION_FACTOR;
+  return std::min<uint8_t>(static_cast<uint8_t>(std::floor(log)), max_layer + 1);
+}
+
+
+/*
+  Insert into an empty index, by ALTER TABLE or LOAD DATA.
+
+  mhnsw_insert() only collects the nodes, with a layer chosen for every
+  node like for a normal insert. At the end the graph is built in memory
+  by mhnsw_build_threads threads, each inserting the next node into the
+  graph. While a thread reads or changes neighbors of a node, it holds
+  its node lock.
+
+  Then the nodes are written in the order of insertion, each once, except
+  nodes that have neighbors written after them. Their neighbors get grefs
+  only when written, so these nodes are updated at the end.
+
+  With one thread the graph is the same as if the rows were inserted one
+  by one, with more threads it depends on how the threads interleave.
+
+  The whole graph must fit into the cache. When the cache is full, the
+  graph is built from the rows collected so far, and the next rows are
+  inserted one by one.
+*/
+class MHNSW_Bulk
+{
+  MHNSW_Share *ctx;
+  TABLE *graph;
+  Dynamic_array<FVectorNode*> nodes{PSI_INSTRUMENT_MEM};
+  size_t reserved= 0;
+  uint8_t max_layer= 0;
+  FVectorNode *start= nullptr;          // of the graph being built
+  mysql_mutex_t start_lock;
+  std::atomic<size_t> next_node{1};     // the first one is the start
+  std::atomic<int> error{0};
+  bool concurrent= false;
+
+  int write_nodes();
+public:
+  MHNSW_Bulk(MHNSW_Share *ctx, TABLE *graph) : ctx(ctx), graph(graph)
+  {
+    mysql_mutex_init(PSI_INSTRUMENT_ME, &start_lock, MY_MUTEX_INIT_FAST);
+  }
+  ~MHNSW_Bulk() { mysql_mutex_destroy(&start_lock); }
+  MHNSW_Share *share() const { return ctx; }
+  int add(TABLE *table, const String *vec);
+  int build(THD *thd);
+  void link_nodes();
+};
+
+
+int MHNSW_Bulk::add(TABLE *table, const String *vec)
+{
+  uint8_t layer= 0;
+  if (!nodes.elements())
+    ctx->set_lengths(vec->length());
+  else if (ctx->byte_len != vec->length())
+    return my_errno= HA_ERR_CRASHED;
+  else
+    layer= random_layer(table->in_use, ctx, max_layer);
+
+  if (nodes.elements() == reserved && nodes.reserve(reserved= reserved*2 + 1024))
+    return my_errno= HA_ERR_OUT_OF_MEM;
+
+  FVectorNode *node= new (ctx->alloc_node())
+                 FVectorNode(ctx, table->file->ref, layer, vec->ptr());
+  nodes.append(node);
+  max_layer= std::max(max_layer, layer);
+  return 0;
+}
+
+
+pthread_handler_t mhnsw_bulk_thread(void *arg)
+{
+  my_thread_init();
+  static_cast<MHNSW_Bulk*>(arg)->link_nodes();
+  my_thread_end();
+  return 0;
+}
+
+
+/* inserts nodes into the graph in memory, until there are none left */
+void MHNSW_Bulk::link_nodes()
+{
+  MEM_ROOT root;
+  init_alloc_root(PSI_INSTRUMENT_MEM, &root, 65536, 0, MYF(0));
+
+  for (size_t i= next_node++; !error && i < nodes.elements(); i= next_node++)
+  {
+    mysql_mutex_lock(&start_lock);
+    FVectorNode *entry= start;
+    mysql_mutex_unlock(&start_lock);
+
+    FVectorNode *target= nodes.at(i);
+    MHNSW_param p(ctx, graph, entry->max_layer);
+    p.root= &root;
+    p.bulk= true;
+    p.concurrent= concurrent;
+    p.acc.graph_size= 1; // we're adding one node to the graph
+
+    int err= find_neighbors(&p, target, entry);
+    if (!err)
+    {
+      ctx->add_to_stats(p.acc);
+
+      if (target->max_layer > entry->max_layer)
+      {
+        mysql_mutex_lock(&start_lock);
+        if (target->max_layer > start->max_layer)
+          start= target;
+        mysql_mutex_unlock(&start_lock);
+      }
+
+      for (p.layer= target->max_layer; !err && p.layer >= 0; p.layer--)
+        err= update_second_degree_neighbors(&p, target);
+    }
+    if (err)
+      error= err;
+    free_root(&root, MYF(MY_MARK_BLOCKS_FREE));
+  }
+  free_root(&root, MYF(0));
+}
+
+
+int MHNSW_Bulk::build(THD *thd)
+{
+  if (!nodes.elements())
+    return 0;
+
+  start= nodes.at(0);
+  uint threads= static_cast<uint>(std::min<size_t>(THDVAR(thd, build_threads),
+                                                   nodes.elements()));
+  concurrent= threads > 1;
+
+  /*
+    The rows are already in the table, if it is not transactional,
+    so the build is not interrupted by KILL
+  */
+  pthread_t *ids= thd->alloc<pthread_t>(threads);
+  uint started= 1;
+  for (; ids && started < threads; started++)
+    if (mysql_thread_create(0, ids + started, nullptr, mhnsw_bulk_thread, this))
+      break; // continue with the threads we have
+  link_nodes();
+  for (uint i= 1; i < started; i++)
+    pthread_join(ids[i], nullptr);
+
+  if (error)
+    return error;
+  return write_nodes();
+}
+
+
+int MHNSW_Bulk::write_nodes()
+{
+  MY_BITMAP incomplete;
+  const size_t count= nodes.elements();
+  if (my_bitmap_init(&incomplete, nullptr, static_cast<uint>(count)))
+    return my_errno= HA_ERR_OUT_OF_MEM;
+  SCOPE_EXIT([&incomplete](){ my_bitmap_free(&incomplete); });
+
+  if (int err= graph->file->ha_rnd_init(0))
+    return err;
+  SCOPE_EXIT([this](){ graph->file->ha_rnd_end(); });
+
+  for (size_t i= 0; i < count; i++)
+  {
+    FVectorNode *node= nodes.at(i);
+    for (size_t layer= 0; layer <= node->max_layer; layer++)
+    {
+      Neighborhood &neighbors= node->neighbors[layer];
+      for (size_t j= 0; j < neighbors.num; j++)
+        if (!neighbors.links[j]->stored)
+          bitmap_set_bit(&incomplete, static_cast<uint>(i));
+    }
+    if (int err= node->save(graph))
+      return err;
+  }
+
+  for (size_t i= 0; i < count; i++)
+    if (bitmap_is_set(&incomplete, static_cast<uint>(i)))
+      if (int err= nodes.at(i)->save(graph))
+        return err;
+
+  ctx->start= start;
+  return 0;
+}
+
+
+int mhnsw_start_bulk_insert(TABLE *table, KEY *keyinfo)
+{
+  TABLE *graph= table->hlindex;
+  MHNSW_Share *ctx;
+
+  DBUG_ASSERT(graph);
+  DBUG_ASSERT(keyinfo->algorithm == HA_KEY_ALG_VECTOR);
+  DBUG_ASSERT(!graph->bulk_context);
+
+  int err= MHNSW_Share::acquire(&ctx, table, true);
+  if (err != HA_ERR_END_OF_FILE) // only an empty graph is built in bulk
+  {
+    ctx->release(table);
+    return err;
+  }
+
+  if (!(graph->bulk_context= new MHNSW_Bulk(ctx, graph)))
+  {
+    ctx->release(table);
+    return my_errno= HA_ERR_OUT_OF_MEM;
+  }
+  return 0;
+}
+
+
+/*
+  @param abort  discard the collected rows instead of inserting them,
+                when they are not in the table either
+*/
+int mhnsw_end_bulk_insert(TABLE *table, bool abort)
+{
+  TABLE *graph= table->hlindex;
+  auto bulk= static_cast<MHNSW_Bulk*>(graph->bulk_context);
+  if (!bulk)
+    return 0;
+
+  graph->bulk_context= nullptr;
+  int err= 0;
+  if (!abort)
+  {
+    status_var_increment(table->in_use->status_var.vector_index_bulk_builds);
+    err= bulk->build(table->in_use);
+  }
+  bulk->share()->release(table);
+  delete bulk;
+  return err;
+}
+
+
 int mhnsw_insert(TABLE *table, KEY *keyinfo)
 {
   THD *thd= table->in_use;
@@ -1425,6 +1889,15 @@ int mhnsw_insert(TABLE *table, KEY *keyinfo)
 
   table->file->position(table->record[0]);
 
+  if (auto bulk= static_cast<MHNSW_Bulk*>(graph->bulk_context))
+  {
+    int err= bulk->add(table, res);
+    dbug_tmp_restore_column_map(&table->read_set, old_map);
+    if (!err && bulk->share()->cache_is_full())
+      err= mhnsw_end_bulk_insert(table, false);
+    return err;
+  }
+
   int err= MHNSW_Share::acquire(&ctx, table, true);
   SCOPE_EXIT([ctx, table](){ ctx->release(table); });
   if (err)
@@ -1448,15 +1921,9 @@ int mhnsw_insert(TABLE *table, KEY *keyinfo)
   root_make_savepoint(thd->mem_root, &memroot_sv);
   SCOPE_EXIT([memroot_sv](){ root_free_to_savepoint(&memroot_sv); });
 
-  const size_t max_found= ctx->max_neighbors(0);
-  Neighborhood candidates;
-  candidates.init(thd->alloc<FVectorNode*>(max_found + 7), max_found);
-  candidates.links[candidates.num++]= ctx->start;
-
-  const double NORMALIZATION_FACTOR= 1 / std::log(ctx->M);
-  double log= -std::log(my_rnd(&thd->rand)) * NORMALIZATION_FACTOR;
-  const uint8_t max_layer= candidates.links[0]->max_layer;
-  uint8_t target_layer= std::min<uint8_t>(static_cast<uint8_t>(std::floor(log)), max_layer + 1);
+  FVectorNode *start= ctx->start;
+  const uint8_t max_layer= start->max_layer;
+  uint8_t target_layer= random_layer(thd, ctx, max_layer);
 
   FVectorNode *target= new (ctx->alloc_node())
                  FVectorNode(ctx, table->file->ref, target_layer, res->ptr());
@@ -1468,22 +1935,8 @@ int mhnsw_insert(TABLE *table, KEY *keyinfo)
   MHNSW_param p(ctx, graph, max_layer);
   p.acc.graph_size= 1; // we're adding one node to the graph
 
-  for (; p.layer > target_layer; p.layer--)
-  {
-    if (int err= search_layer(&p, target->vec, NEAREST, 1, &candidates, false))
-      return err;
-  }
-
-  for (; p.layer >= 0; p.layer--)
-  {
-    uint max_neighbors= ctx->max_neighbors(p.layer);
-    if (int err= search_layer(&p, target->vec, NEAREST, max_neighbors,
-                              &candidates, true))
-      return err;
-
-    if (int err= select_neighbors(&p, target, candidates, 0, max_neighbors))
-      return err;
-  }
+  if (int err= find_neighbors(&p, target, start))
+    return err;
 
   if (int err= target->save(graph))
     return err;
@@ -1509,15 +1962,169 @@ struct Search_context: public Sql_alloc
   Neighborhood found;
   MHNSW_Share *ctx;
   const FVector *target;
+  Item *dist;
+  Search_filter *filter;
   ulonglong ctx_version;
   size_t pos= 0;
   float threshold= NEAREST/2;
-  Search_context(Neighborhood *n, MHNSW_Share *s, const FVector *v)
-    : found(*n), ctx(s->dup(false)), target(v), ctx_version(ctx->version) {}
+  Search_context(Neighborhood *n, MHNSW_Share *s, const FVector *v, Item *d,
+                 Search_filter *f)
+    : found(*n), ctx(s->dup(false)), target(v), dist(d), filter(f),
+      ctx_version(ctx->version) {}
 };
 
 
-int mhnsw_read_first(TABLE *table, KEY *keyinfo, Item *dist, ulonglong limit)
+/*
+  with a very selective filter it's cheaper to compare the target to every
+  row that satisfies it, than to traverse the graph looking for these rows.
+  That is, if the rows can be read through a range on another index that
+  matches few rows, or if the whole table is small enough to be scanned.
+
+  returns the range in *range, or NULL if the table is to be scanned
+*/
+static bool use_brute_force(Search_filter *filter, SQL_SELECT **range)
+{
+  TABLE *table= filter->table;
+  THD *thd= table->in_use;
+  ha_rows max_rows= THDVAR(thd, brute_force_rows);
+  int err;
+
+  *range= NULL;
+  if (!max_rows)
+    return false;
+  if (table->stat_records() <= max_rows)
+    return true;
+
+  /* the optimizer estimates tell if a range analysis is worth it */
+  if (std::min<double>(static_cast<double>(table->opt_range_condition_rows),
+                       table->stat_records() * table->cond_selectivity)
+      > max_rows)
+    return false;
+
+  key_map keys;
+  keys.set_all();
+  SQL_SELECT *select= make_select(table, 0, 0, filter->cond, NULL, false,
+                                  &err);
+  if (!select)
+    return false;
+  switch (select->test_quick_select(thd, keys, 0, HA_POS_ERROR, true, false,
+                                    false, false, Item_func::BITMAP_NONE)) {
+  case SQL_SELECT::IMPOSSIBLE_RANGE:
+    *range= select;
+    return true;
+  case SQL_SELECT::OK:
+    if (select->quick && select->quick->records <= max_rows)
+    {
+      *range= select;
+      return true;
+    }
+    break;
+  case SQL_SELECT::ERROR:
+    break;
+  }
+  delete select;
+  return false;
+}
+
+
+/*
+  compare the target to every row that satisfies the filter, reading them
+  through the range, or with a table scan if range is NULL
+
+  the table must be initialized for a scan if range is NULL, and must not
+  be initialized otherwise. The graph must not be initialized
+*/
+static int brute_force_search(MHNSW_Share *ctx, TABLE *graph,
+                              Search_filter *filter, SQL_SELECT *range,
+                              const FVector *target, uint result_size,
+                              Neighborhood *result)
+{
+  TABLE *table= filter->table;
+  THD *thd= table->in_use;
+  handler *h= table->file;
+  QUICK_SELECT_I *quick= range ? range->quick : NULL;
+  Queue<Visited> best;
+  int err;
+
+  best.init(result_size, true, Visited::cmp);
+  uchar *key= (uchar*)alloca(graph->key_info[IDX_TREF].key_length);
+
+  if (range && !quick)                          // impossible range
+  {
+    result->num= 0;
+    return 0;
+  }
+  if (quick && (err= quick->reset()))
+    return err;
+
+  while (!(err= quick ? quick->get_next()
+                      : h->ha_rnd_next(table->record[0])))
+  {
+    if (thd->check_killed())
+      return HA_ERR_ABORTED_BY_USER;
+    if (!filter->cond->val_bool())
+      continue;
+
+    h->position(table->record[0]);
+    graph->field[FIELD_TREF]->set_notnull();
+    graph->field[FIELD_TREF]->store_binary(h->ref, h->ref_length);
+    key_copy(key, graph->record[0], &graph->key_info[IDX_TREF],
+             graph->key_info[IDX_TREF].key_length);
+    if ((err= graph->file->ha_index_read_idx_map(graph->record[0], IDX_TREF,
+                                    key, HA_WHOLE_KEY, HA_READ_KEY_EXACT)))
+      return err;
+
+    graph->file->position(graph->record[0]);
+    FVectorNode *node= ctx->get_node(graph->file->ref);
+    if ((err= node->load_from_record(graph)))
+      return err;
+
+    float distance= node->distance_to(target);
+    if (!best.is_full())
+      best.push(new (thd->mem_root) Visited(node, distance));
+    else if (distance < best.top()->distance_to_target)
+      best.replace_top(new (thd->mem_root) Visited(node, distance));
+  }
+  if (err != HA_ERR_END_OF_FILE)
+    return err;
+
+  result->num= best.elements();
+  for (FVectorNode **links= result->links + result->num; best.elements();)
+    *--links= best.pop()->node;
+
+  return 0;
+}
+
+
+/*
+  int8 and binary vectors in the graph only approximate the vectors in the
+  table. Sort the found nodes by the exact distance, computed from the rows.
+*/
+static int rerank(TABLE *table, Item *dist, Neighborhood *found)
+{
+  struct Exact { float distance; FVectorNode *node; };
+  Exact *exact= table->in_use->alloc<Exact>(found->num);
+  if (!exact)
+    return my_errno= HA_ERR_OUT_OF_MEM;
+
+  for (size_t i= 0; i < found->num; i++)
+  {
+    FVectorNode *node= found->links[i];
+    if (int err= table->file->ha_rnd_pos(table->record[0], node->tref()))
+      return err;
+    exact[i]= { static_cast<float>(dist->val_real()), node };
+  }
+  std::stable_sort(exact, exact + found->num,
+                   [](const Exact &a, const Exact &b)
+                   { return a.distance < b.distance; });
+  for (size_t i= 0; i < found->num; i++)
+    found->links[i]= exact[i].node;
+  return 0;
+}
+
+
+int mhnsw_read_first(TABLE *table, KEY *keyinfo, Item *dist, ulonglong limit,
+                     Item *cond)
 {
   THD *thd= table->in_use;
   TABLE *graph= table->hlindex;
@@ -1528,15 +2135,34 @@ int mhnsw_read_first(TABLE *table, KEY *keyinfo, Item *dist, ulonglong limit)
 
   String buf, *res= fun->get_const_arg()->val_str(&buf);
   MHNSW_Share *ctx;
+  Search_filter *filter= cond ? new (thd->mem_root) Search_filter(table, cond)
+                              : nullptr;
 
-  if (int err= table->file->ha_rnd_init(0))
-    return err;
+  /*
+    with a range the table is initialized for the rnd_pos() calls only
+    after the brute force search, which reads the rows through the range
+  */
+  SQL_SELECT *range= NULL;
+  SCOPE_EXIT([&range](){ delete range; });
+  bool brute_force= filter && use_brute_force(filter, &range);
+
+  if (!range)
+    if (int err= table->file->ha_rnd_init(brute_force))
+      return err;
 
   int err= MHNSW_Share::acquire(&ctx, table, false);
   SCOPE_EXIT([ctx, table](){ ctx->release(table); });
   if (err)
     return err;
 
+  /*
+    with approximate vectors the nearest nodes in the graph are less likely
+    the nearest rows, so look for more and rerank() them. All of them are
+    returned, the nearest first
+  */
+  if (ctx->quantization != INT16)
+    limit= std::max<ulonglong>(limit, THDVAR(thd, ef_search));
+
   Neighborhood candidates;
   candidates.init(thd->alloc<FVectorNode*>(limit + 7), limit);
 
@@ -1558,13 +2184,37 @@ int mhnsw_read_first(TABLE *table, KEY *keyinfo, Item *dist, ulonglong limit)
       ((float*)buf.ptr())[i]= i == 0;
   }
 
-  auto target= FVector::create(ctx, thd->alloc(FVector::alloc_size(ctx->vec_len)),
-                               res->ptr());
+  auto target= FVector::create(ctx,
+             thd->alloc(FVector::alloc_size(ctx->vec_len, ctx->quantization)),
+             res->ptr());
+
+  if (brute_force)
+  {
+    if (int err= brute_force_search(ctx, graph, filter, range, target,
+                                    static_cast<uint>(limit), &candidates))
+      return err;
+    if (range)
+    {
+      delete range;                             // ends the index scan
+      range= NULL;
+      if (int err= table->file->ha_rnd_init(0))
+        return err;
+    }
+    if (ctx->quantization != INT16)
+      if (int err= rerank(table, dist, &candidates))
+        return err;
+    if (int err= graph->file->ha_rnd_init(0))
+      return err;
+    graph->context= new (thd->mem_root) Search_context(&candidates, ctx,
+                                                       target, dist, filter);
+    return mhnsw_read_next(table);
+  }
 
   if (int err= graph->file->ha_rnd_init(0))
     return err;
 
   MHNSW_param p(ctx, graph, candidates.links[0]->max_layer);
+  p.filter= filter;
 
   for (; p.layer > 0; p.layer--)
   {
@@ -1583,7 +2233,17 @@ int mhnsw_read_first(TABLE *table, KEY *keyinfo, Item *dist, ulonglong limit)
   }
   ctx->add_to_stats(p.acc);
 
-  auto result= new (thd->mem_root) Search_context(&candidates, ctx, target);
+  if (ctx->quantization != INT16)
+  {
+    if (int err= rerank(table, dist, &candidates))
+    {
+      graph->file->ha_rnd_end();
+      return err;
+    }
+  }
+
+  auto result= new (thd->mem_root) Search_context(&candidates, ctx, target,
+                                                  dist, filter);
   graph->context= result;
 
   return mhnsw_read_next(table);
@@ -1630,11 +2290,19 @@ int mhnsw_read_next(TABLE *table)
     std::swap(trx, ctx);        // free shared ctx in this scope, keep trx
   }
 
-  float new_threshold= result->found.links[result->found.num-1]->distance_to(result->target);
+  // the furthest in the graph is not the last one, if they were reranked
+  float new_threshold= NEAREST;
+  for (size_t i= 0; i < result->found.num; i++)
+    new_threshold= std::max(new_threshold,
+                   result->found.links[i]->distance_to(result->target));
   MHNSW_param p(ctx, graph, 0);
+  p.filter= result->filter;
   if (int err= search_layer(&p, result->target, result->threshold,
                             static_cast<uint>(result->pos), &result->found, false))
     return err;
+  if (ctx->quantization != INT16)
+    if (int err= rerank(table, result->dist, &result->found))
+      return err;
   result->pos= 0;
   result->threshold= new_threshold + FLT_EPSILON;
   return mhnsw_read_next(table);
@@ -1665,6 +2333,10 @@ int mhnsw_invalidate(TABLE *table, const uchar *rec, KEY *keyinfo)
   handler *h= table->file;
   MHNSW_Share *ctx;
 
+  // the row can be among the collected ones, e.g. on REPLACE
+  if (int err= mhnsw_end_bulk_insert(table, false))
+    return err;
+
   int err= MHNSW_Share::acquire(&ctx, table, true);
   SCOPE_EXIT([ctx, table](){ ctx->release(table); });
   if (err)
@@ -1710,6 +2382,8 @@ int mhnsw_delete_all(TABLE *table, KEY *keyinfo, bool truncate)
   DBUG_ASSERT(keyinfo->algorithm == HA_KEY_ALG_VECTOR);
   DBUG_ASSERT(keyinfo->usable_key_parts == 1);
 
+  mhnsw_end_bulk_insert(table, true);
+
   if (int err= truncate ? graph->file->truncate()
                         : graph->file->delete_all_rows())
    return err;
@@ -1761,6 +2435,7 @@ ha_create_table_option mhnsw_index_options[]=
 {
   HA_IOPTION_SYSVAR("m", M, default_m),
   HA_IOPTION_SYSVAR("distance", metric, default_distance),
+  HA_IOPTION_SYSVAR("quantization", quantization, default_quantization),
   HA_IOPTION_END
 };
 
@@ -1790,7 +2465,10 @@ static struct st_mysql_sys_var *mhnsw_sys_vars[]=
   MYSQL_SYSVAR(max_cache_size),
   MYSQL_SYSVAR(default_m),
   MYSQL_SYSVAR(default_distance),
+  MYSQL_SYSVAR(default_quantization),
   MYSQL_SYSVAR(ef_search),
+  MYSQL_SYSVAR(brute_force_rows),
+  MYSQL_SYSVAR(build_threads),
   NULL
 };
 
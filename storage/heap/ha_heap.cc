@@ -643,9 +643,11 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   TABLE_SHARE *share= table_arg->s;
   uint key, parts, mem_per_row= 0, keys= share->keys;
   uint auto_key= 0, auto_key_type= 0;
+  uint blobs= internal_table ? share->blob_fields : 0;
   ha_rows max_rows;
   HP_KEYDEF *keydef;
   HA_KEYSEG *seg;
+  HP_BLOB_DESC *blob_descs;
   bool found_real_auto_increment= 0;
 
   bzero(hp_create_info, sizeof(*hp_create_info));
@@ -663,8 +665,32 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
                        MYF(MY_WME | MY_THREAD_SPECIFIC),
                        &keydef, keys * sizeof(HP_KEYDEF),
                        &seg, parts * sizeof(HA_KEYSEG),
+                       &blob_descs, blobs * sizeof(HP_BLOB_DESC),
                        NULL))
     return my_errno;
+  /*
+    Blobs are only allowed in internal temporary tables, where the blob
+    data is kept in separate chunks (see hp_blob.c). They can't be part
+    of a key.
+  */
+  for (uint i= 0; i < blobs; i++)
+  {
+    Field *field= table_arg->field[share->blob_field[i]];
+    DBUG_ASSERT(field->flags & BLOB_FLAG);
+    DBUG_ASSERT(!field->part_of_key.bits_set());
+    blob_descs[i].offset= (uint) (field->ptr - table_arg->record[0]);
+    blob_descs[i].packlength= ((Field_blob*) field)->pack_length_no_ptr();
+    if (field->null_ptr)
+    {
+      blob_descs[i].null_bit= field->null_bit;
+      blob_descs[i].null_pos= (uint) (field->null_ptr - table_arg->record[0]);
+    }
+    else
+    {
+      blob_descs[i].null_bit= 0;
+      blob_descs[i].null_pos= 0;
+    }
+  }
   for (key= 0; key < keys; key++)
   {
     KEY *pos= table_arg->key_info+key;
@@ -756,6 +782,14 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->auto_key= auto_key;
   hp_create_info->auto_key_type= auto_key_type;
   hp_create_info->max_table_size= MY_MAX(current_thd->variables.max_heap_table_size, sizeof(HP_PTRS));
+  /*
+    For internal tables max_rows is limited by tmp_memory_table_size, but
+    the blob data is not part of the row length. Limit the total size instead.
+  */
+  if (blobs)
+    set_if_smaller(hp_create_info->max_table_size,
+                   MY_MAX(current_thd->variables.tmp_memory_table_size,
+                          sizeof(HP_PTRS)));
   hp_create_info->with_auto_increment= found_real_auto_increment;
   hp_create_info->internal_table= internal_table;
 
@@ -775,6 +809,8 @@ static int heap_prepare_hp_create_info(TABLE *table_arg, bool internal_table,
   hp_create_info->keys= share->keys;
   hp_create_info->reclength= share->reclength;
   hp_create_info->keydef= keydef;
+  hp_create_info->blob_descs= blob_descs;
+  hp_create_info->blobs= blobs;
   return 0;
 }
 
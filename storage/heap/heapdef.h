@@ -52,6 +52,17 @@ typedef struct st_hp_hash_info
   ulong hash_of_key;
 } HASH_INFO;
 
+/*
+  Overflow chunk holding the data of one blob value. All chunks of a table
+  are linked together so that they can be freed at once by hp_clear().
+*/
+
+typedef struct st_hp_blob_chunk
+{
+  struct st_hp_blob_chunk *prev, *next;
+  size_t alloc_length;                  /* Including this header */
+} HP_BLOB_CHUNK;
+
 typedef struct {
   HA_KEYSEG *keyseg;
   uint key_length;
@@ -103,6 +114,11 @@ extern uint hp_rb_pack_key(HP_KEYDEF *keydef, uchar *key, const uchar *old,
 extern ha_rows hp_rows_in_memory(size_t reclength, size_t index_size,
                           size_t memory_limit);
 extern size_t hp_memory_needed_per_row(size_t reclength);
+extern int hp_copy_blobs(HP_INFO *info, const uchar *record);
+extern void hp_store_blobs(HP_INFO *info, uchar *pos);
+extern void hp_free_blob_copies(HP_INFO *info);
+extern void hp_free_blobs(HP_SHARE *share, uchar *pos);
+extern void hp_free_all_blobs(HP_SHARE *share);
 
 extern mysql_mutex_t THR_LOCK_heap;
 
@@ -110,6 +126,7 @@ extern PSI_memory_key hp_key_memory_HP_SHARE;
 extern PSI_memory_key hp_key_memory_HP_INFO;
 extern PSI_memory_key hp_key_memory_HP_PTRS;
 extern PSI_memory_key hp_key_memory_HP_KEYDEF;
+extern PSI_memory_key hp_key_memory_HP_BLOB;
 
 #ifdef HAVE_PSI_INTERFACE
 void init_heap_psi_keys();
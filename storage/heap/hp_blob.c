@@ -0,0 +1,218 @@
+/* Copyright (c) 2026, MariaDB Corporation.
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA 02110-1335  USA */
+
+/*
+  Storage of blob columns for internal temporary heap tables.
+
+  The record stored in the heap block only contains the blob length and a
+  pointer, like the record in TABLE::record[0]. The data itself is copied
+  into a separately allocated overflow chunk, which is linked into
+  HP_SHARE::blob_chunks. As the pointer in the stored record points
+  directly to the chunk data, reading a row is still a plain memcpy().
+
+  Writing is done in two steps: hp_copy_blobs() copies the blob data of the
+  new record into chunks remembered in HP_INFO::blob_ptrs, and
+  hp_store_blobs() puts these pointers into the stored record once the
+  keys have been updated. If the key update fails, the copies are freed
+  with hp_free_blob_copies().
+*/
+
+#include "heapdef.h"
+
+#define hp_chunk_data(chunk) ((uchar*) ((chunk) + 1))
+#define hp_data_chunk(data)  (((HP_BLOB_CHUNK*) (data)) - 1)
+
+
+static inline my_bool hp_blob_is_null(const HP_BLOB_DESC *desc,
+                                      const uchar *record)
+{
+  return desc->null_bit && (record[desc->null_pos] & desc->null_bit);
+}
+
+
+static size_t hp_blob_length(const HP_BLOB_DESC *desc, const uchar *record)
+{
+  const uchar *pos= record + desc->offset;
+  switch (desc->packlength) {
+  case 1: return (size_t) *pos;
+  case 2: return (size_t) uint2korr(pos);
+  case 3: return (size_t) uint3korr(pos);
+  case 4: return (size_t) uint4korr(pos);
+  }
+  DBUG_ASSERT(0);
+  return 0;
+}
+
+
+static inline uchar *hp_blob_ptr(const HP_BLOB_DESC *desc,
+                                 const uchar *record)
+{
+  uchar *ptr;
+  memcpy(&ptr, record + desc->offset + desc->packlength, sizeof(ptr));
+  return ptr;
+}
+
+
+static inline void hp_set_blob_ptr(const HP_BLOB_DESC *desc, uchar *record,
+                                   uchar *ptr)
+{
+  memcpy(record + desc->offset + desc->packlength, &ptr, sizeof(ptr));
+}
+
+
+static void hp_free_chunk(HP_SHARE *share, uchar *data)
+{
+  HP_BLOB_CHUNK *chunk= hp_data_chunk(data);
+  if (chunk->prev)
+    chunk->prev->next= chunk->next;
+  else
+    share->blob_chunks= chunk->next;
+  if (chunk->next)
+    chunk->next->prev= chunk->prev;
+  share->data_length-= chunk->alloc_length;
+  my_free(chunk);
+}
+
+
+/*
+  Copy the blob data of a record into new overflow chunks
+
+  SYNOPSIS
+    hp_copy_blobs()
+    info        Heap table
+    record      Record that will be written
+
+  RETURN
+    0  ok, chunk data pointers are in info->blob_ptrs
+    #  error (HA_ERR_RECORD_FILE_FULL or ENOMEM), nothing is allocated
+*/
+
+int hp_copy_blobs(HP_INFO *info, const uchar *record)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+  DBUG_ENTER("hp_copy_blobs");
+
+  for (i= 0; i < share->blobs; i++)
+  {
+    const HP_BLOB_DESC *desc= share->blob_descs + i;
+    HP_BLOB_CHUNK *chunk;
+    size_t length, alloc_length;
+
+    info->blob_ptrs[i]= 0;
+    if (hp_blob_is_null(desc, record) ||
+        !(length= hp_blob_length(desc, record)))
+      continue;
+
+    alloc_length= sizeof(HP_BLOB_CHUNK) + length;
+    if (share->data_length + share->index_length + alloc_length >
+        share->max_table_size)
+    {
+      my_errno= HA_ERR_RECORD_FILE_FULL;
+      goto err;
+    }
+    if (!(chunk= (HP_BLOB_CHUNK*) my_malloc(hp_key_memory_HP_BLOB,
+                                            alloc_length,
+                                            MYF(share->internal ?
+                                                MY_THREAD_SPECIFIC : 0))))
+    {
+      my_errno= ENOMEM;
+      goto err;
+    }
+    chunk->alloc_length= alloc_length;
+    chunk->prev= 0;
+    if ((chunk->next= share->blob_chunks))
+      chunk->next->prev= chunk;
+    share->blob_chunks= chunk;
+    share->data_length+= alloc_length;
+
+    memcpy(hp_chunk_data(chunk), hp_blob_ptr(desc, record), length);
+    info->blob_ptrs[i]= hp_chunk_data(chunk);
+  }
+  DBUG_RETURN(0);
+
+err:
+  while (i-- > 0)
+  {
+    if (info->blob_ptrs[i])
+      hp_free_chunk(share, info->blob_ptrs[i]);
+  }
+  DBUG_RETURN(my_errno);
+}
+
+
+/*
+  Store the pointers from hp_copy_blobs() into the record in the heap block
+*/
+
+void hp_store_blobs(HP_INFO *info, uchar *pos)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+  for (i= 0; i < share->blobs; i++)
+    hp_set_blob_ptr(share->blob_descs + i, pos, info->blob_ptrs[i]);
+}
+
+
+/*
+  Free the chunks from hp_copy_blobs() that were not stored in any record
+*/
+
+void hp_free_blob_copies(HP_INFO *info)
+{
+  HP_SHARE *share= info->s;
+  uint i;
+  for (i= 0; i < share->blobs; i++)
+  {
+    if (info->blob_ptrs[i])
+      hp_free_chunk(share, info->blob_ptrs[i]);
+  }
+}
+
+
+/*
+  Free the blob data of a record stored in the heap block
+*/
+
+void hp_free_blobs(HP_SHARE *share, uchar *pos)
+{
+  uint i;
+  for (i= 0; i < share->blobs; i++)
+  {
+    const HP_BLOB_DESC *desc= share->blob_descs + i;
+    uchar *data= hp_blob_ptr(desc, pos);
+    if (data)
+    {
+      hp_free_chunk(share, data);
+      hp_set_blob_ptr(desc, pos, 0);
+    }
+  }
+}
+
+
+/*
+  Free all blob chunks of a table. Used when the table is emptied
+*/
+
+void hp_free_all_blobs(HP_SHARE *share)
+{
+  HP_BLOB_CHUNK *chunk, *next;
+  for (chunk= share->blob_chunks; chunk; chunk= next)
+  {
+    next= chunk->next;
+    my_free(chunk);
+  }
+  share->blob_chunks= 0;
+}
@@ -32,6 +32,12 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
 
   if (info->opt_flag & READ_CHECK_USED && hp_rectest(info,old))
     DBUG_RETURN(my_errno);				/* Record changed */
+  /*
+    The new blob values may point into the blob data of the old record, so
+    copy them before the old data is freed.
+  */
+  if (share->blobs && hp_copy_blobs(info, heap_new))
+    DBUG_RETURN(my_errno);
   if (--(share->records) < share->blength >> 1) share->blength>>= 1;
   share->changed=1;
 
@@ -52,7 +58,11 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
     }
   }
 
+  if (share->blobs)
+    hp_free_blobs(share, pos);
   memcpy(pos,heap_new,(size_t) share->reclength);
+  if (share->blobs)
+    hp_store_blobs(info, pos);
   if (++(share->records) == share->blength) share->blength+= share->blength;
 
 #if !defined(DBUG_OFF) && defined(EXTRA_HEAP_DEBUG)
@@ -65,6 +75,8 @@ int heap_update(HP_INFO *info, const uchar *old, const uchar *heap_new)
   DBUG_RETURN(0);
 
  err:
+  if (share->blobs)
+    hp_free_blob_copies(info);
   if (my_errno == HA_ERR_FOUND_DUPP_KEY)
   {
     info->errkey = (int) (keydef - share->keydef);
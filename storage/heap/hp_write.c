@@ -44,6 +44,8 @@ int heap_write(HP_INFO *info, const uchar *record)
 #endif
   if (!(pos=next_free_record_pos(share)))
     DBUG_RETURN(my_errno);
+  if (share->blobs && hp_copy_blobs(info, record))
+    goto err_blobs;
   share->changed=1;
 
   for (keydef = share->keydef, end = keydef + share->keys; keydef < end;
@@ -54,6 +56,8 @@ int heap_write(HP_INFO *info, const uchar *record)
   }
 
   memcpy(pos,record,(size_t) share->reclength);
+  if (share->blobs)
+    hp_store_blobs(info, pos);
   pos[share->visible]= 1;                     /* Mark record as not deleted */
   if (++share->records == share->blength)
     share->blength+= share->blength;
@@ -86,7 +90,10 @@ int heap_write(HP_INFO *info, const uchar *record)
       break;
     keydef--;
   } 
+  if (share->blobs)
+    hp_free_blob_copies(info);
 
+err_blobs:
   share->deleted++;
   *((uchar**) pos)=share->del_link;
   share->del_link=pos;
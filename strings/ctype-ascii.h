@@ -3,6 +3,14 @@
 
 #include "myisampack.h"
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define MY_ASCII_SSE2
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#define MY_ASCII_NEON
+#endif
+
 /*
   Magic expression. It uses the fact that for any byte value X in
   the range 0..31 (0x00..0x1F) the expression (X+31)*5 returns
@@ -186,4 +194,57 @@ my_strcoll_mb7_bin_8bytes(const uchar *a, const uchar *b)
   return an == bn ? 0 : an < bn ? -1 : +1;
 }
 
+
+/*
+  Scans long runs of 7bit ASCII bytes, 32 bytes at a time if the CPU
+  has AVX2. Returns the number of leading 7bit bytes in [s, e).
+*/
+extern size_t (*my_ascii_prefix_length_long)(const uchar *s, const uchar *e);
+
+/* Strings that did not end in this many bytes go to the function above */
+#define MY_ASCII_LONG_RUN 64
+
+
+/*
+  Returns the number of leading 7bit ASCII bytes in [s, e).
+  Used to copy or skip ASCII text without decoding it a character at
+  a time.
+*/
+static inline size_t my_ascii_prefix_length(const uchar *s, const uchar *e)
+{
+  const uchar *p= s;
+#if defined(MY_ASCII_SSE2) || defined(MY_ASCII_NEON)
+  for ( ; p + 16 <= e; p+= 16)
+  {
+#ifdef MY_ASCII_SSE2
+    uint mask= (uint) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) p));
+    if (mask)
+    {
+#ifdef __GNUC__
+      return (size_t) (p - s) + (size_t) __builtin_ctz(mask);
+#else
+      break;
+#endif
+    }
+#else
+    if (vmaxvq_u8(vld1q_u8(p)) >= 0x80)
+      break;
+#endif
+    if (p + 16 + MY_ASCII_LONG_RUN <= e)
+      return (size_t) (p + 16 - s) + my_ascii_prefix_length_long(p + 16, e);
+  }
+#else
+  for ( ; p + 8 <= e; p+= 8)
+  {
+    if (uint8korr(p) & 0x8080808080808080ULL)
+      break;
+    if (p + 8 + MY_ASCII_LONG_RUN <= e)
+      return (size_t) (p + 8 - s) + my_ascii_prefix_length_long(p + 8, e);
+  }
+#endif
+  for ( ; p < e && *p < 0x80; p++)
+  { }
+  return (size_t) (p - s);
+}
+
 #endif /* CTYPE_ASCII_INCLUDED */
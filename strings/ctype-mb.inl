@@ -184,6 +184,23 @@ MY_FUNCTION_NAME(well_formed_char_length)(CHARSET_INFO *cs __attribute__((unused
   int chlen;
   for ( ; nchars ; nchars--, b+= chlen)
   {
+#ifdef WELL_FORMED_CHAR_LENGTH_ASCII_RUNS
+    if (b < e && (uchar) *b < 0x80)
+    {
+      chlen= 1;
+      if (b + 1 < e && (uchar) b[1] < 0x80)
+      {
+        /* Skip a run of single byte ASCII characters at once */
+        size_t length= my_ascii_prefix_length((const uchar *) b,
+                                              (const uchar *) b +
+                                              MY_MIN((size_t) (e - b),
+                                                     nchars));
+        b+= length - 1;
+        nchars-= length - 1;
+      }
+      continue;
+    }
+#endif
     if ((chlen= CHARLEN(cs, (uchar*) b, (uchar*) e)) <= 0)
     {
       status->m_well_formed_error_pos= b < e ? b : NULL;
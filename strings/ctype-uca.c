@@ -31288,6 +31288,13 @@ my_uca_scanner_next_expansion_weight(my_uca_scanner *scanner)
 }
 
 
+static inline my_bool
+my_uca_scanner_has_expansion_weight(const my_uca_scanner *scanner)
+{
+  return scanner->wbeg[0] != 0;
+}
+
+
 static inline uint16
 my_uca_scanner_set_weight(my_uca_scanner *scanner, const uint16 *weight)
 {
@@ -32017,6 +32024,24 @@ my_uca_scanner_init_any(my_uca_scanner *scanner,
 }
 
 
+/*
+  Continue scanning from a new position, after the characters
+  before it were processed without the scanner, e.g. using the level booster.
+  Remember the byte before the new position as the previous character,
+  like scanner_next() does after a byte pair, so previous context
+  pairs are still recognized.
+*/
+static inline void
+my_uca_scanner_continue(my_uca_scanner *scanner, const uchar *str)
+{
+  DBUG_ASSERT(str > scanner->sbeg && str <= scanner->send);
+  scanner->sbeg= str;
+  scanner->wbeg= nochar + 1; /* Not the first character, no expansion */
+  scanner->page= 0;
+  scanner->code= (int) str[-1];
+}
+
+
 /*
   Test if both scanners have reached the end of their strings,
   so there is no data left to compare.
@@ -34631,8 +34656,10 @@ static void my_uca_handler_map(struct charset_info_st *cs,
     my_uca_collation_handler_nopad_multilevel_generic
     my_uca_collation_handler_multilevel_generic
 
-  TODO: Use faster character-set specific versions of MY_COLLATION_HANDLER
-  instead of generic.
+  utf8mb3 and utf8mb4 collations switch to their faster character set
+  specific versions in my_uca_coll_init_utf8mb3() and
+  my_uca_coll_init_utf8mb4().
+  TODO: Do the same for the other character sets.
 */
 #define MY_FUNCTION_NAME(x)   my_uca_ ## x ## _generic
 #define MY_MB_WC(scanner, param, wc, beg, end) (my_ci_mb_wc(param->cs, wc, beg, end))
@@ -35752,6 +35779,8 @@ my_uca_coll_init_utf8mb3(struct charset_info_st *cs, MY_CHARSET_LOADER *loader)
 {
   if (my_coll_init_uca(cs, loader))
     return TRUE;
+  /* Multi-level collations with tailoring: use the utf8mb3 specific handler */
+  my_uca_handler_map(cs, &my_uca_package_generic, &my_uca_package_utf8mb3);
   if (my_uca_collation_can_optimize_no_contractions(cs))
     my_uca_handler_map(cs, &my_uca_package_utf8mb3,
                        &my_uca_package_no_contractions_utf8mb3);
@@ -36699,6 +36728,8 @@ my_uca_coll_init_utf8mb4(struct charset_info_st *cs, MY_CHARSET_LOADER *loader)
 {
   if (my_coll_init_uca(cs, loader))
     return TRUE;
+  /* Multi-level collations with tailoring: use the utf8mb4 specific handler */
+  my_uca_handler_map(cs, &my_uca_package_generic, &my_uca_package_utf8mb4);
   if (my_uca_collation_can_optimize_no_contractions(cs))
     my_uca_handler_map(cs, &my_uca_package_utf8mb4,
                        &my_uca_package_no_contractions_utf8mb4);
@@ -719,6 +719,114 @@ MY_FUNCTION_NAME(hash_sort_nopad)(my_hasher_st *hasher, CHARSET_INFO *cs,
 
 
 
+#if MY_UCA_ASCII_OPTIMIZE
+/*
+  Put weights of the characters that do not need the scanner:
+  - byte pairs making one or two weights, taken from the level booster,
+    where contractions and context dependent pairs are already resolved
+  - other ASCII characters with one weight, taken directly from
+    the weight table, unless they need context handling.
+
+  RETURN
+    FALSE - *src points to a character which needs the scanner
+    TRUE  - the source string has ended or the result got truncated,
+            *warnings is set
+*/
+
+static inline my_bool
+MY_FUNCTION_NAME(strnxfrm_onelevel_simple)(const MY_UCA_WEIGHT_LEVEL *level,
+                                           uchar **dstp, uchar *de,
+                                           uint *nweights,
+                                           const uchar **srcp,
+                                           const uchar *se,
+                                           uint *warnings)
+{
+  const MY_UCA_LEVEL_BOOSTER *booster= level->booster;
+  const uint16 *weights0= level->weights[0];
+  uint lengths0= level->lengths[0];
+  const uchar *de2= de - 1; /* Last position where 2 bytes fit */
+  const uchar *de4= de - 3; /* Last position where 4 bytes fit */
+  uchar *dst= *dstp;
+  const uchar *src= *srcp;
+  uint nw= *nweights;       /* A local copy, "dst" cannot alias it */
+  my_bool rc= TRUE;
+
+  for ( ; ; src++)
+  {
+    const uint16 *weight;
+    int s_res;
+    /* Byte pairs, while both weights are sure to fit */
+    for ( ; se - src > 1 && nw > 1 && dst < de4; src+= 2)
+    {
+      const MY_UCA_WEIGHT2 *w2;
+      w2= my_uca_level_booster_simple_weight2_addr_const(booster,
+                                                         src[0], src[1]);
+      if (!w2->weight[0])
+        break;              /* Ignorable, long or context dependent */
+      dst[0]= w2->weight[0] >> 8;
+      dst[1]= w2->weight[0] & 0xFF;
+      dst+= 2;
+      nw--;
+      if (w2->weight[1])
+      {
+        dst[0]= w2->weight[1] >> 8;
+        dst[1]= w2->weight[1] & 0xFF;
+        dst+= 2;
+        nw--;
+      }
+    }
+
+    if (src >= se)
+    {
+      *warnings= 0;
+      break;
+    }
+    if (*src > 0x7F)
+    {
+      rc= FALSE;            /* Non-ASCII */
+      break;
+    }
+#if MY_UCA_COMPILE_CONTRACTIONS
+    if (my_uca_needs_context_handling(level, *src))
+    {
+      rc= FALSE;            /* A contraction or previous context part */
+      break;
+    }
+#endif
+    weight= weights0 + (((uint) *src) * lengths0);
+    if (!(s_res= *weight))
+      continue;             /* Ignorable */
+    if (weight[1])          /* Expansion (e.g. in a user defined collation */
+    {
+      rc= FALSE;
+      break;
+    }
+
+    /* Here we have a character with extactly one 2-byte UCA weight */
+    if (nw && dst < de2)    /* Most typical case is when both bytes fit */
+    {
+      *dst++= s_res >> 8;
+      *dst++= s_res & 0xFF;
+      nw--;
+      continue;
+    }
+    if (nw && dst < de)     /* There is space only for one byte */
+    {
+      *dst++= s_res >> 8;
+      nw--;
+      src++;
+    }
+    *warnings= MY_STRNXFRM_TRUNCATED_WEIGHT_REAL_CHAR;
+    break;
+  }
+  *dstp= dst;
+  *srcp= src;
+  *nweights= nw;
+  return rc;
+}
+#endif
+
+
 /*
   For the given string creates its "binary image", suitable
   to be used in binary comparison, i.e. in memcmp(). 
@@ -766,55 +874,32 @@ MY_FUNCTION_NAME(strnxfrm_onelevel_internal)(CHARSET_INFO *cs,
 
   DBUG_ASSERT(src || !srclen);
 
-#if MY_UCA_ASCII_OPTIMIZE && !MY_UCA_COMPILE_CONTRACTIONS
- /*
-    Fast path for the ASCII range with no contractions.
-  */
-  {
-    const uint16 *weights0= level->weights[0];
-    uint lengths0= level->lengths[0];
-    for ( ; ; src++, srclen--)
-    {
-      const uint16 *weight;
-      if (!srclen)
-        return my_strnxfrm_ret_construct(dst - dst0, src - src0, 0);
-      if (*src > 0x7F)
-        break;              /* Non-ASCII */
-
-      weight= weights0 + (((uint) *src) * lengths0);
-      if (!(s_res= *weight))
-        continue;           /* Ignorable */
-      if (weight[1])        /* Expansion (e.g. in a user defined collation */
-        break;
-
-      if (!*nweights)
-        return my_strnxfrm_ret_construct(dst - dst0, src - src0,
-                                      MY_STRNXFRM_TRUNCATED_WEIGHT_REAL_CHAR);
-      /* Here we have a character with extactly one 2-byte UCA weight */
-      if (dst < de2)        /* Most typical case is when both bytes fit */
-      {
-        *dst++= s_res >> 8;
-        *dst++= s_res & 0xFF;
-        (*nweights)--;
-        continue;
-      }
-      if (dst >= de)        /* No space left in "dst" */
-        return my_strnxfrm_ret_construct(dst - dst0, src - src0,
-                                       MY_STRNXFRM_TRUNCATED_WEIGHT_REAL_CHAR);
-      *dst++= s_res >> 8;   /* There is space only for one byte */
-      (*nweights)--;
-      return my_strnxfrm_ret_construct(dst - dst0, src + 1 - src0,
-                                       MY_STRNXFRM_TRUNCATED_WEIGHT_REAL_CHAR);
-    }
-  }
-#endif
-
   my_uca_scanner_param_init(&param, cs, level);
   my_uca_scanner_init_any(&scanner, src, srclen);
 
-  for (; (s_res= MY_FUNCTION_NAME(scanner_next)(&scanner, &param)) > 0 ;
-       (*nweights)--)
+  for ( ; ; (*nweights)--)
   {
+#if MY_UCA_ASCII_OPTIMIZE
+    /*
+      Fast path for ASCII and 2-byte characters, also when the collation
+      has contractions. Go back to it after every character which needed
+      the scanner, as soon as all weights of that character are put.
+    */
+    if (!my_uca_scanner_has_expansion_weight(&scanner))
+    {
+      const uchar *sbeg= scanner.sbeg;
+      uint warnings;
+      if (MY_FUNCTION_NAME(strnxfrm_onelevel_simple)(level, &dst, de,
+                                                     nweights, &sbeg,
+                                                     scanner.send,
+                                                     &warnings))
+        return my_strnxfrm_ret_construct(dst - dst0, sbeg - src0, warnings);
+      if (sbeg > scanner.sbeg)
+        my_uca_scanner_continue(&scanner, sbeg);
+    }
+#endif
+    if ((s_res= MY_FUNCTION_NAME(scanner_next)(&scanner, &param)) <= 0)
+      break;
     if (!*nweights)
       return my_strnxfrm_ret_construct(dst - dst0, scanner.sbeg - src0,
                                  MY_STRNXFRM_TRUNCATED_WEIGHT_REAL_CHAR);
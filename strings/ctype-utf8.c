@@ -22,6 +22,7 @@
 #include "strings_def.h"
 #include <m_ctype.h>
 #include "ctype-mb.h"
+#include "ctype-ascii.h"
 
 #ifndef EILSEQ
 #define EILSEQ ENOENT
@@ -671,10 +672,12 @@ int my_charlen_utf8mb3(CHARSET_INFO *cs __attribute__((unused)),
 #define MY_FUNCTION_NAME(x)       my_ ## x ## _utf8mb3
 #define CHARLEN(cs,str,end)       my_charlen_utf8mb3(cs,str,end)
 #define DEFINE_WELL_FORMED_CHAR_LENGTH_USING_CHARLEN
+#define WELL_FORMED_CHAR_LENGTH_ASCII_RUNS
 #include "ctype-mb.inl"
 #undef MY_FUNCTION_NAME
 #undef CHARLEN
 #undef DEFINE_WELL_FORMED_CHAR_LENGTH_USING_CHARLEN
+#undef WELL_FORMED_CHAR_LENGTH_ASCII_RUNS
 /* my_well_formed_char_length_utf8mb3 */
 
 
@@ -3046,10 +3049,12 @@ my_ci_eq_collation_utf8mb4_bin(CHARSET_INFO *a, CHARSET_INFO *b)
 #define MY_FUNCTION_NAME(x)       my_ ## x ## _utf8mb4
 #define CHARLEN(cs,str,end)       my_charlen_utf8mb4(cs,str,end)
 #define DEFINE_WELL_FORMED_CHAR_LENGTH_USING_CHARLEN
+#define WELL_FORMED_CHAR_LENGTH_ASCII_RUNS
 #include "ctype-mb.inl"
 #undef MY_FUNCTION_NAME
 #undef CHARLEN
 #undef DEFINE_WELL_FORMED_CHAR_LENGTH_USING_CHARLEN
+#undef WELL_FORMED_CHAR_LENGTH_ASCII_RUNS
 /* my_well_formed_char_length_utf8mb4 */
 
 
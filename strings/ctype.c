@@ -17,6 +17,7 @@
 #include "strings_def.h"
 #include <m_ctype.h>
 #include <my_xml.h>
+#include "ctype-ascii.h"
 
 /*
 
@@ -1135,6 +1136,66 @@ my_wc_to_printable_generic(CHARSET_INFO *cs, my_wc_t wc,
 }
 
 
+/*
+  Convert one character, or replace a bad byte sequence to '?'.
+  See my_convert_using_func().
+
+  @return FALSE if the string ended or the result did not fit into 'to'
+*/
+
+static inline my_bool
+my_convert_char(uchar **to, uchar *to_end,
+                CHARSET_INFO *to_cs, my_charset_conv_wc_mb wc_mb,
+                const uchar **from, const uchar *from_end,
+                CHARSET_INFO *from_cs, my_charset_conv_mb_wc mb_wc,
+                uint *error_count)
+{
+  int         cnvres;
+  my_wc_t     wc;
+
+  if ((cnvres= (*mb_wc)(from_cs, &wc, *from, from_end)) > 0)
+    *from+= cnvres;
+  else if (cnvres == MY_CS_ILSEQ)
+  {
+    (*error_count)++;
+    (*from)++;
+    wc= '?';
+  }
+  else if (cnvres > MY_CS_TOOSMALL)
+  {
+    /*
+      A correct multibyte sequence detected
+      But it doesn't have Unicode mapping.
+    */
+    (*error_count)++;
+    *from+= (-cnvres);
+    wc= '?';
+  }
+  else
+  {
+    if (*from >= from_end)
+      return FALSE;  /* End of line */
+    /* Incomplete byte sequence */
+    (*error_count)++;
+    (*from)++;
+    wc= '?';
+  }
+
+outp:
+  if ((cnvres= (*wc_mb)(to_cs, wc, *to, to_end)) > 0)
+    *to+= cnvres;
+  else if (cnvres == MY_CS_ILUNI && wc != '?')
+  {
+    (*error_count)++;
+    wc= '?';
+    goto outp;
+  }
+  else
+    return FALSE;
+  return TRUE;
+}
+
+
 /*
   Convert a string between two character sets.
   'to' must be large enough to store (form_length * to_cs->mbmaxlen) bytes.
@@ -1157,55 +1218,182 @@ my_convert_using_func(char *to, size_t to_length,
                       CHARSET_INFO *from_cs, my_charset_conv_mb_wc mb_wc,
                       uint *errors)
 {
-  int         cnvres;
-  my_wc_t     wc;
-  const uchar *from_end= (const uchar*) from + from_length;
-  char *to_start= to;
-  uchar *to_end= (uchar*) to + to_length;
+  const uchar *src= (const uchar*) from;
+  const uchar *from_end= src + from_length;
+  uchar *dst= (uchar*) to;
+  uchar *to_end= dst + to_length;
   uint error_count= 0;
 
-  while (1)
+  while (my_convert_char(&dst, to_end, to_cs, wc_mb,
+                         &src, from_end, from_cs, mb_wc, &error_count))
+  { }
+  *errors= error_count;
+  return (uint32) (dst - (uchar*) to);
+}
+
+
+/* my_ascii_prefix_length_long() with SSE2, NEON or 8 bytes at a time */
+
+static inline size_t
+my_ascii_prefix_length_generic(const uchar *s, const uchar *e)
+{
+  const uchar *p= s;
+#if defined(MY_ASCII_SSE2)
+  for ( ; p + 64 <= e; p+= 64)
   {
-    if ((cnvres= (*mb_wc)(from_cs, &wc, (uchar*) from, from_end)) > 0)
-      from+= cnvres;
-    else if (cnvres == MY_CS_ILSEQ)
-    {
-      error_count++;
-      from++;
-      wc= '?';
-    }
-    else if (cnvres > MY_CS_TOOSMALL)
-    {
-      /*
-        A correct multibyte sequence detected
-        But it doesn't have Unicode mapping.
-      */
-      error_count++;
-      from+= (-cnvres);
-      wc= '?';
-    }
-    else
-    {
-      if ((uchar *) from >= from_end)
-        break;  /* End of line */
-      /* Incomplete byte sequence */
-      error_count++;
-      from++;
-      wc= '?';
-    }
+    __m128i a= _mm_or_si128(_mm_loadu_si128((const __m128i *) p),
+                            _mm_loadu_si128((const __m128i *) (p + 16)));
+    __m128i b= _mm_or_si128(_mm_loadu_si128((const __m128i *) (p + 32)),
+                            _mm_loadu_si128((const __m128i *) (p + 48)));
+    if (_mm_movemask_epi8(_mm_or_si128(a, b)))
+      break;
+  }
+  for ( ; p + 16 <= e; p+= 16)
+    if (_mm_movemask_epi8(_mm_loadu_si128((const __m128i *) p)))
+      break;
+#elif defined(MY_ASCII_NEON)
+  for ( ; p + 64 <= e; p+= 64)
+  {
+    uint8x16_t a= vorrq_u8(vld1q_u8(p), vld1q_u8(p + 16));
+    uint8x16_t b= vorrq_u8(vld1q_u8(p + 32), vld1q_u8(p + 48));
+    if (vmaxvq_u8(vorrq_u8(a, b)) >= 0x80)
+      break;
+  }
+  for ( ; p + 16 <= e; p+= 16)
+    if (vmaxvq_u8(vld1q_u8(p)) >= 0x80)
+      break;
+#else
+  for ( ; p + 8 <= e; p+= 8)
+    if (uint8korr(p) & 0x8080808080808080ULL)
+      break;
+#endif
+  for ( ; p < e && *p < 0x80; p++)
+  { }
+  return (size_t) (p - s);
+}
 
-outp:
-    if ((cnvres= (*wc_mb)(to_cs, wc, (uchar*) to, to_end)) > 0)
-      to+= cnvres;
-    else if (cnvres == MY_CS_ILUNI && wc != '?')
-    {
-      error_count++;
-      wc= '?';
-      goto outp;
-    }
-    else
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#include <immintrin.h>
+#include <cpuid.h>
+#define HAVE_ASCII_AVX2
+
+__attribute__((target("avx2")))
+static size_t my_ascii_prefix_length_avx2(const uchar *s, const uchar *e)
+{
+  const uchar *p= s;
+  for ( ; p + 64 <= e; p+= 64)
+  {
+    __m256i a= _mm256_loadu_si256((const __m256i *) p);
+    __m256i b= _mm256_loadu_si256((const __m256i *) (p + 32));
+    if (_mm256_movemask_epi8(_mm256_or_si256(a, b)))
       break;
   }
+  for ( ; p + 32 <= e; p+= 32)
+    if (_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *) p)))
+      break;
+  return (size_t) (p - s) + my_ascii_prefix_length_generic(p, e);
+}
+
+
+__attribute__((target("xsave")))
+static my_bool my_os_have_avx()
+{
+  /* The OS saves the SSE and AVX registers */
+  return (_xgetbv(0) & 6) == 6;
+}
+
+
+static my_bool my_have_avx2()
+{
+  uint eax, ebx, ecx, edx;
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) ||
+      (~ecx & (1U << 27 | 1U << 28)) /* OSXSAVE and AVX */ ||
+      !my_os_have_avx() || __get_cpuid_max(0, NULL) < 7)
+    return FALSE;
+  __cpuid_count(7, 0, eax, ebx, ecx, edx);
+  return (ebx >> 5) & 1;
+}
+#endif
+
+
+/* Chooses the implementation on the first call */
+static size_t my_ascii_prefix_length_choose(const uchar *s, const uchar *e)
+{
+#ifdef HAVE_ASCII_AVX2
+  if (my_have_avx2())
+    my_ascii_prefix_length_long= my_ascii_prefix_length_avx2;
+  else
+#endif
+    my_ascii_prefix_length_long= my_ascii_prefix_length_generic;
+  return my_ascii_prefix_length_long(s, e);
+}
+
+size_t (*my_ascii_prefix_length_long)(const uchar *s, const uchar *e)=
+  my_ascii_prefix_length_choose;
+
+
+/*
+  Convert a string from a single byte character set
+  (e.g. latin1) to utf8mb3 or utf8mb4, using the cs->tab_to_uni table.
+*/
+
+static uint32
+my_convert_8bit_to_utf8(uchar *to, size_t to_length,
+                        const uchar *from, size_t from_length,
+                        CHARSET_INFO *from_cs, uint *errors)
+{
+  const uint16 *tab_to_uni= from_cs->tab_to_uni;
+  const uchar *from_end= from + from_length;
+  uchar *to_start= to, *to_end= to + to_length;
+  uint error_count= 0;
+
+  for ( ; ; )
+  {
+    my_wc_t wc;
+    size_t length= my_ascii_prefix_length(from, from +
+                                          MY_MIN((size_t) (from_end - from),
+                                                 (size_t) (to_end - to)));
+    memcpy(to, from, length);
+    from+= length;
+    to+= length;
+    if (from >= from_end)
+      break;
+
+    /* Convert the non-ASCII characters up to the next ASCII one */
+    do
+    {
+      if (!(wc= tab_to_uni[*from]) && *from)
+      {
+        error_count++;
+        wc= '?';
+      }
+      if (wc < 0x80)
+      {
+        if (to >= to_end)
+          goto end;
+        *to++= (uchar) wc;
+      }
+      else if (wc < 0x800)
+      {
+        if (to + 2 > to_end)
+          goto end;
+        to[0]= (uchar) (0xC0 | (wc >> 6));
+        to[1]= (uchar) (0x80 | (wc & 0x3F));
+        to+= 2;
+      }
+      else
+      {
+        if (to + 3 > to_end)
+          goto end;
+        to[0]= (uchar) (0xE0 | (wc >> 12));
+        to[1]= (uchar) (0x80 | ((wc >> 6) & 0x3F));
+        to[2]= (uchar) (0x80 | (wc & 0x3F));
+        to+= 3;
+      }
+    } while (++from < from_end && *from >= 0x80);
+  }
+end:
   *errors= error_count;
   return (uint32) (to - to_start);
 }
@@ -1232,65 +1420,58 @@ my_convert(char *to, uint32 to_length, CHARSET_INFO *to_cs,
            const char *from, uint32 from_length,
            CHARSET_INFO *from_cs, uint *errors)
 {
-  uint32 length, length2;
+  const uchar *src= (const uchar*) from;
+  const uchar *from_end= src + from_length;
+  uchar *dst= (uchar*) to;
+  uchar *to_end= dst + to_length;
+  my_charset_conv_mb_wc mb_wc= from_cs->cset->mb_wc;
+  my_charset_conv_wc_mb wc_mb= to_cs->cset->wc_mb;
+  uint error_count= 0;
+
   /*
     If any of the character sets is not ASCII compatible,
     immediately switch to slow mb_wc->wc_mb method.
   */
   if ((to_cs->state | from_cs->state) & MY_CS_NONASCII)
     return my_convert_using_func(to, to_length,
-                                 to_cs, to_cs->cset->wc_mb,
+                                 to_cs, wc_mb,
                                  from, from_length,
-                                 from_cs, from_cs->cset->mb_wc,
+                                 from_cs, mb_wc,
                                  errors);
 
-  length= length2= MY_MIN(to_length, from_length);
-
-#if SIZEOF_SIZE_T <= 8
-  for (size_t f; length >= sizeof f;
-       length-= sizeof f, from+= sizeof f, to+= sizeof f)
-  {
-    memcpy(&f, from, sizeof f);
-    if (f & (size_t) 0x8080808080808080ULL)
-      goto nonascii;
-    memcpy(to, from, sizeof f);
-  }
-# if SIZEOF_SIZE_T > 4
-  if (length >= 4)
-  {
-    uint32 f;
-    memcpy(&f, from, 4);
-    if (f & 0x80808080U)
-      goto nonascii;
-    memcpy(to, from, 4);
-    length-= 4, to+= 4, from+= 4;
-  }
-# endif
- nonascii:
-#endif
+  /* Every byte of the table driven character sets is one character */
+  if (from_cs->tab_to_uni &&
+      (mb_wc == my_mb_wc_8bit || mb_wc == my_charset_latin1.cset->mb_wc) &&
+      (wc_mb == my_charset_utf8mb4_bin.cset->wc_mb ||
+       wc_mb == my_charset_utf8mb3_bin.cset->wc_mb))
+    return my_convert_8bit_to_utf8(dst, to_length, src, from_length,
+                                   from_cs, errors);
 
-  for (; ; *to++= *from++, length--)
+  /*
+    Copy runs of ASCII characters as they are,
+    convert the other characters one by one.
+  */
+  for ( ; ; )
   {
-    if (!length)
-    {
-      *errors= 0;
-      return length2;
-    }
-    if (*((unsigned char*) from) > 0x7F) /* A non-ASCII character */
+    size_t length= my_ascii_prefix_length(src, src +
+                                          MY_MIN((size_t) (from_end - src),
+                                                 (size_t) (to_end - dst)));
+    memcpy(dst, src, length);
+    src+= length;
+    dst+= length;
+    if (src >= from_end)
+      break;
+    /* Convert the non-ASCII characters up to the next ASCII one */
+    do
     {
-      uint32 copied_length= length2 - length;
-      to_length-= copied_length;
-      from_length-= copied_length;
-      return copied_length + my_convert_using_func(to, to_length, to_cs,
-                                                   to_cs->cset->wc_mb,
-                                                   from, from_length, from_cs,
-                                                   from_cs->cset->mb_wc,
-                                                   errors);
-    }
+      if (!my_convert_char(&dst, to_end, to_cs, wc_mb,
+                           &src, from_end, from_cs, mb_wc, &error_count))
+        goto end;
+    } while (src < from_end && *src >= 0x80);
   }
-
-  DBUG_ASSERT(FALSE); // Should never get to here
-  return 0;           // Make compiler happy
+end:
+  *errors= error_count;
+  return (uint32) (dst - (uchar*) to);
 }
 
 
@@ -1575,6 +1575,170 @@ int bin2decimal(const uchar *from, decimal_t *to, decimal_digits_t precision,
   return(E_DEC_BAD_NUM);
 }
 
+
+static const ulonglong powers10_ll[DECIMAL_SCALED_LONGLONG_PRECISION+1]=
+{
+  1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+  10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+  100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+  100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+  100000000000000000ULL, 1000000000000000000ULL
+};
+
+
+static inline dec1 bin2dec1(const uchar *from, int bytes)
+{
+  switch (bytes)
+  {
+    case 1: return mi_sint1korr(from);
+    case 2: return mi_sint2korr(from);
+    case 3: return mi_sint3korr(from);
+    default: return mi_sint4korr(from);
+  }
+}
+
+/*
+  Convert a number in the binary format of decimal2bin() to an integer
+  scaled by 10^scale, i.e. with the decimal point removed
+
+  SYNOPSIS
+    bin2scaled_longlong()
+      from    - value to convert
+      to      - result
+      precision/scale - see decimal_bin_size()
+
+  NOTE
+    Only numbers of precision up to DECIMAL_SCALED_LONGLONG_PRECISION
+    are converted, the caller uses bin2decimal() for the others.
+
+  RETURN VALUE
+    E_DEC_OK/E_DEC_OVERFLOW
+*/
+
+int bin2scaled_longlong(const uchar *from, longlong *to,
+                        decimal_digits_t precision, decimal_digits_t scale)
+{
+  int intg=precision-scale,
+      intg0=intg/DIG_PER_DEC1, frac0=scale/DIG_PER_DEC1,
+      intg0x=intg-intg0*DIG_PER_DEC1, frac0x=scale-frac0*DIG_PER_DEC1;
+  dec1 y, mask=(*from & 0x80) ? 0 : -1;
+  ulonglong x= 0;
+  const uchar *stop;
+  uchar d_copy[12];
+
+  if (precision > DECIMAL_SCALED_LONGLONG_PRECISION)
+    return E_DEC_OVERFLOW;
+  DBUG_ASSERT(decimal_bin_size(precision, scale) <= sizeof(d_copy));
+  memcpy(d_copy, from, decimal_bin_size(precision, scale));
+  d_copy[0]^= 0x80;
+  from= d_copy;
+
+  if (intg0x)
+  {
+    x= (uint32) (bin2dec1(from, dig2bytes[intg0x]) ^ mask);
+    if (x >= (ulonglong) powers10[intg0x])
+      return E_DEC_OVERFLOW;
+    from+= dig2bytes[intg0x];
+  }
+  for (stop=from+(intg0+frac0)*sizeof(dec1); from < stop; from+=sizeof(dec1))
+  {
+    y= mi_sint4korr(from) ^ mask;
+    if (((uint32) y) > DIG_MAX)
+      return E_DEC_OVERFLOW;
+    x= x*DIG_BASE + y;
+  }
+  if (frac0x)
+  {
+    y= bin2dec1(from, dig2bytes[frac0x]) ^ mask;
+    if (((uint32) y) >= (uint32) powers10[frac0x])
+      return E_DEC_OVERFLOW;
+    x= x*powers10[frac0x] + y;
+  }
+  *to= mask ? -(longlong) x : (longlong) x;
+  return E_DEC_OK;
+}
+
+
+/*
+  Convert an integer scaled by 10^scale to decimal
+
+  RETURN VALUE
+    E_DEC_OK/E_DEC_TRUNCATED/E_DEC_OVERFLOW
+*/
+
+int scaled_longlong2decimal(longlong from, decimal_digits_t scale,
+                            decimal_t *to)
+{
+  int intg1, frac1=ROUND_UP(scale), error;
+  ulonglong x= from < 0 ? -(ulonglong) from : (ulonglong) from;
+  ulonglong intpart= x / powers10_ll[scale], y;
+  ulonglong fracpart= (x - intpart * powers10_ll[scale]) *
+                      powers10[frac1*DIG_PER_DEC1 - scale];
+  dec1 *buf;
+
+  DBUG_ASSERT(scale <= DECIMAL_SCALED_LONGLONG_PRECISION);
+  sanity(to);
+
+  for (intg1=0, y=intpart; y; intg1++, y/=DIG_BASE) {}
+  FIX_INTG_FRAC_ERROR(to->len, intg1, frac1, error);
+  if (unlikely(error))
+  {
+    /* Too small buffer, let the general code truncate the number */
+    if ((error= longlong2decimal(from, to)) == E_DEC_OK)
+      error= decimal_shift(to, -(int) scale);
+    return error;
+  }
+
+  to->sign= from < 0;
+  for (y= intpart, to->intg= 0; y; to->intg++, y/= 10) {}
+  to->frac= scale;
+
+  for (buf=to->buf+intg1; intpart; intpart/=DIG_BASE)
+    *--buf= (dec1) (intpart % DIG_BASE);
+  for (buf=to->buf+intg1+frac1; frac1; frac1--, fracpart/=DIG_BASE)
+    *--buf= (dec1) (fracpart % DIG_BASE);
+
+  if (to->intg == 0 && to->frac == 0)
+    decimal_make_zero(to);
+  return E_DEC_OK;
+}
+
+
+/*
+  Convert an integer scaled by 10^scale to double
+
+  RETURN VALUE
+    E_DEC_OK/E_DEC_OVERFLOW, the latter if the result would not be
+    the correctly rounded decimal2double() value
+*/
+
+int scaled_longlong2double(longlong from, decimal_digits_t scale, double *to)
+{
+  /*
+    Both operands of the division are exact, so is its rounding,
+    as long as the integer fits into the mantissa of double
+  */
+  if (from > (1LL << DBL_MANT_DIG) || from < -(1LL << DBL_MANT_DIG))
+    return E_DEC_OVERFLOW;
+  *to= (double) from / (double) powers10_ll[scale];
+  return E_DEC_OK;
+}
+
+
+/*
+  Round an integer scaled by 10^scale to an integer, half away from zero
+  like decimal_round(..., HALF_UP)
+*/
+
+longlong scaled_longlong2longlong(longlong from, decimal_digits_t scale)
+{
+  longlong p= (longlong) powers10_ll[scale];
+  longlong q= from / p, r= from % p;
+  if ((ulonglong) (r < 0 ? -r : r) * 2 >= (ulonglong) p)
+    q+= r < 0 ? -1 : 1;
+  return q;
+}
+
 /*
   Returns the size of array to hold a decimal with given precision and scale
 
@@ -179,6 +179,46 @@ test_search(MEM_ROOT_DYNAMIC_ARRAY* array_counters, json_engine_t *je, json_path
 }
 
 
+/*
+  Test the string constants longer than the blocks the plain characters
+  are skipped with, with a special character at every position.
+*/
+static void
+test_long_strings(json_engine_t *je)
+{
+  static const char *special[]= {"\\\"", "\\u00e9", "\xc3\xa9", "\x01", "\""};
+  static const int special_len[]= {2, 6, 2, 1, 1};
+  static const int valid[]= {1, 1, 1, 0, 0};
+  uchar js[80];
+  int i, pos, n_wrong= 0;
+
+  for (i= 0; i < 5; i++)
+  {
+    for (pos= 0; pos <= 40; pos++)
+    {
+      int len, value_len= 0;
+      memset(js, 'a', sizeof(js));
+      js[0]= '[';
+      js[1]= '"';
+      memcpy(js + 2 + pos, special[i], special_len[i]);
+      len= 2 + 40 + special_len[i];
+      js[len++]= '"';
+      js[len++]= ']';
+
+      if (json_scan_start(je, ci, js, js + len) ||
+          json_scan_next(je) || json_scan_next(je) || json_read_value(je))
+        value_len= -1;
+      else
+        value_len= je->value_len;
+      if (json_valid((const char *) js, len, ci, je) != valid[i] ||
+          (valid[i] && value_len != 40 + special_len[i]))
+        n_wrong++;
+    }
+  }
+  ok(n_wrong == 0, "long strings");
+}
+
+
 int main()
 {
   MEM_ROOT current_mem_root;
@@ -201,12 +241,13 @@ int main()
 
   ci= &my_charset_utf8mb3_general_ci;
 
-  plan(6);
+  plan(7);
   diag("Testing json_lib functions.");
 
   test_json_parsing(&je);
   test_path_parsing(&p);
   test_search(&array_counters, &je, &p);
+  test_long_strings(&je);
 
   free_root(&current_mem_root, MYF(0));
 
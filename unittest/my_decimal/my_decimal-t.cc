@@ -90,13 +90,107 @@ test_decimal2string()
   return 0;
 
 }
+
+static ulonglong rnd_state= 1;
+
+static uint rnd(uint n)
+{
+  rnd_state= rnd_state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (uint) (rnd_state >> 33) % n;
+}
+
+
+/*
+  Compare reading DECIMAL(M,D) values as integers scaled by 10^D with
+  bin2decimal() and the conversions of the result
+*/
+static int check_scaled_longlong(const char *strnum, uint precision,
+                                 uint scale)
+{
+  my_decimal d1, d2, rounded;
+  uchar bin[DECIMAL_MAX_FIELD_SIZE];
+  char str1[DECIMAL_MAX_STR_LENGTH + 1], str2[DECIMAL_MAX_STR_LENGTH + 1];
+  int len1= sizeof(str1), len2= sizeof(str2);
+  char *end= (char*) strnum + strlen(strnum);
+  longlong nr, ll1, ll2;
+  double dbl1, dbl2;
+
+  string2decimal(strnum, &d1, &end);
+  decimal2bin(&d1, bin, precision, scale);
+  bin2decimal(bin, &d1, precision, scale);
+  if (bin2scaled_longlong(bin, &nr, precision, scale) ||
+      scaled_longlong2decimal(nr, scale, &d2))
+  {
+    diag("%s DECIMAL(%u,%u): not converted", strnum, precision, scale);
+    return 1;
+  }
+  decimal2string(&d1, str1, &len1, 0, 0, 0);
+  decimal2string(&d2, str2, &len2, 0, 0, 0);
+  decimal2double(&d1, &dbl1);
+  decimal_round(&d1, &rounded, 0, HALF_UP);
+  decimal2longlong(&rounded, &ll1, TRUNCATE);
+  ll2= scaled_longlong2longlong(nr, scale);
+  if (my_decimal_cmp(&d1, &d2) || d1.frac != d2.frac ||
+      strcmp(str1, str2) || ll1 != ll2 ||
+      (!scaled_longlong2double(nr, scale, &dbl2) && dbl1 != dbl2))
+  {
+    diag("%s DECIMAL(%u,%u): got %s %lld, expected %s %lld", strnum,
+         precision, scale, str2, ll2, str1, ll1);
+    return 1;
+  }
+  return 0;
+}
+
+
+static int
+test_scaled_longlong()
+{
+  static const char *numbers[]= { "0", "-0.5", "0.5", "-1.5", "2.5",
+                                  "999999999999999999", "-0.000000001",
+                                  "123456789.123456789", "-100000000" };
+  char strnum[DECIMAL_MAX_STR_LENGTH + 1];
+  uchar bin[DECIMAL_MAX_FIELD_SIZE];
+  my_decimal d;
+  longlong nr;
+  char *end;
+  uint i, round, failed= 0;
+
+  for (i= 0; i < array_elements(numbers); i++)
+    failed+= check_scaled_longlong(numbers[i], 18, 9);
+  for (round= 0; round < 10000; round++)
+  {
+    uint precision= rnd(DECIMAL_SCALED_LONGLONG_PRECISION) + 1;
+    uint scale= rnd(precision + 1), pos= 0;
+    if (rnd(2))
+      strnum[pos++]= '-';
+    for (i= 0; i < precision; i++)
+    {
+      if (i == precision - scale)
+        strnum[pos++]= '.';
+      strnum[pos++]= (char) ('0' + (rnd(4) ? rnd(10) : 9));
+    }
+    strnum[pos]= 0;
+    failed+= check_scaled_longlong(strnum, precision, scale);
+  }
+  ok(failed == 0, "bin2scaled_longlong");
+
+  end= (char*) numbers[5] + strlen(numbers[5]);
+  string2decimal(numbers[5], &d, &end);
+  decimal2bin(&d, bin, 19, 0);
+  ok(bin2scaled_longlong(bin, &nr, 19, 0) == E_DEC_OVERFLOW,
+     "bin2scaled_longlong precision 19");
+  return 0;
+}
+
+
 int main()
 {
-  plan(15);
+  plan(17);
   diag("Testing my_decimal constructor and assignment operators");
 
   test_copy_and_compare();
   test_decimal2string();
+  test_scaled_longlong();
 
   return exit_status();
 }
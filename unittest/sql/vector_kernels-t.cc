@@ -0,0 +1,137 @@
+/*
+   Copyright (c) 2026, MariaDB plc
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1335 USA */
+
+/*
+  Compares the vector distance kernels of every instruction set the CPU
+  supports with a plain implementation.
+
+  It is also a microbenchmark: vector_kernels-t N calls every kernel
+  N times for every dimension and prints the time per call.
+*/
+#include <my_global.h>
+#include <my_sys.h>
+#include <my_bit.h>
+#include <tap.h>
+#include <cmath>
+#include <vector>
+#include "vector_kernels.h"
+
+static const size_t dims[]= { 1, 7, 16, 17, 63, 64, 100, 256, 768, 1536,
+                              3072 };
+
+struct Data
+{
+  std::vector<float> f1, f2;
+  std::vector<int8_t> i1, i2;
+  std::vector<uchar> b1, b2;
+  size_t len, bytes;
+
+  Data(size_t n) : f1(n), f2(n), i1(n), i2(n), b1(MY_ALIGN(n, 64)/8),
+                   b2(MY_ALIGN(n, 64)/8), len(n), bytes(MY_ALIGN(n, 64)/8)
+  {
+    for (size_t i= 0; i < n; i++)
+    {
+      f1[i]= static_cast<float>(std::sin(i * 0.7 + 0.5) * 3);
+      f2[i]= static_cast<float>(std::cos(i * 1.3) * 2);
+      i1[i]= static_cast<int8_t>(static_cast<int>(i * 37 % 255) - 127);
+      i2[i]= static_cast<int8_t>(static_cast<int>(i * 91 % 255) - 127);
+      if (f1[i] > 0)
+        b1[i / 8]|= 1 << (i % 8);
+      if (f2[i] > 0)
+        b2[i / 8]|= 1 << (i % 8);
+    }
+  }
+};
+
+static void test_kernels(const Vec_kernels *k, const Data &d)
+{
+  long dot= 0;
+  size_t differ= 0;
+  double euc= 0, dotp= 0, abs1= 0, abs2= 0;
+  for (size_t i= 0; i < d.len; i++)
+  {
+    dot+= d.i1[i] * d.i2[i];
+    euc+= (double(d.f1[i]) - d.f2[i]) * (double(d.f1[i]) - d.f2[i]);
+    dotp+= d.f1[i] * d.f2[i];
+    abs1+= d.f1[i] * d.f1[i];
+    abs2+= d.f2[i] * d.f2[i];
+  }
+  for (size_t i= 0; i < d.bytes; i++)
+    differ+= my_count_bits(d.b1[i] ^ d.b2[i]);
+
+  ok(k->dot_product_int8(d.i1.data(), d.i2.data(), d.len) == dot,
+     "%s dot_product_int8 %zu", k->name, d.len);
+  ok(k->hamming_distance(d.b1.data(), d.b2.data(), d.bytes) == differ,
+     "%s hamming_distance %zu", k->name, d.len);
+  ok(std::abs(k->distance_euclidean(d.f1.data(), d.f2.data(), d.len)
+              - std::sqrt(euc)) < 1e-5 * std::sqrt(euc),
+     "%s distance_euclidean %zu", k->name, d.len);
+  ok(std::abs(k->distance_cosine(d.f1.data(), d.f2.data(), d.len)
+              - (1 - dotp/std::sqrt(abs1*abs2))) < 1e-5,
+     "%s distance_cosine %zu", k->name, d.len);
+}
+
+template <typename F>
+static void bench(const char *name, const Vec_kernels *k, size_t len,
+                  ulong iterations, F f)
+{
+  volatile double res= 0;
+  ulonglong start= my_interval_timer();
+  for (ulong i= 0; i < iterations; i++)
+    res+= f();
+  ulonglong ns= my_interval_timer() - start;
+  diag("%-22s %-20s %5zu dims %8.1f ns", k->name, name, len,
+       double(ns) / iterations);
+}
+
+static void bench_kernels(const Vec_kernels *k, const Data &d, ulong n)
+{
+  bench("dot_product_int8", k, d.len, n, [&]()
+        { return k->dot_product_int8(d.i1.data(), d.i2.data(), d.len); });
+  bench("hamming_distance", k, d.len, n, [&]()
+        { return k->hamming_distance(d.b1.data(), d.b2.data(), d.bytes); });
+  bench("distance_euclidean", k, d.len, n, [&]()
+        { return k->distance_euclidean(d.f1.data(), d.f2.data(), d.len); });
+  bench("distance_cosine", k, d.len, n, [&]()
+        { return k->distance_cosine(d.f1.data(), d.f2.data(), d.len); });
+}
+
+int main(int argc, char **argv)
+{
+  MY_INIT(argv[0]);
+  ulong iterations= argc > 1 ? strtoul(argv[1], nullptr, 10) : 0;
+
+  std::vector<const Vec_kernels*> kernels;
+  for (uint isa= 0; isa < VEC_KERNELS_ISA_COUNT; isa++)
+    if (auto k= vec_kernels_for(static_cast<vec_kernels_isa>(isa)))
+      kernels.push_back(k);
+
+  plan(static_cast<int>(kernels.size() * array_elements(dims) * 4));
+  diag("chosen: %s", vec_kernels->name);
+
+  for (size_t len : dims)
+  {
+    Data d(len);
+    for (auto k : kernels)
+      test_kernels(k, d);
+    if (iterations)
+      for (auto k : kernels)
+        bench_kernels(k, d, iterations);
+  }
+
+  my_end(0);
+  return exit_status();
+}
@@ -0,0 +1,298 @@
+/* Copyright (c) 2026, MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1335  USA */
+
+/*
+  Compares my_convert() and my_well_formed_length(), which copy and skip
+  ASCII runs in blocks, with the one character at a time
+  my_convert_using_func() and my_ci_charlen().
+
+  It is also a microbenchmark: convert-t N converts and checks every
+  text N times and prints the time per call.
+*/
+
+#include <tap.h>
+#include <my_global.h>
+#include <my_sys.h>
+
+#define TEXT_LENGTH 4096
+
+static uchar text[TEXT_LENGTH];
+static char res1[TEXT_LENGTH * 4], res2[TEXT_LENGTH * 4];
+static ulonglong rnd_state= 1;
+
+static uint rnd(uint n)
+{
+  rnd_state= rnd_state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (uint) (rnd_state >> 33) % n;
+}
+
+
+/* Appends a character, or sometimes a bad byte sequence, in utf8mb4 */
+static size_t put_utf8(uchar *s, uint bad_percent)
+{
+  uint wc;
+  if (rnd(100) < bad_percent)
+  {
+    switch (rnd(3)) {
+    case 0: s[0]= (uchar) (0x80 + rnd(0x40)); return 1; /* lone trail byte */
+    case 1: s[0]= 0xE0 | rnd(16); s[1]= 'a'; return 2;  /* broken sequence */
+    default: s[0]= (uchar) (0xF5 + rnd(11)); return 1;  /* never valid */
+    }
+  }
+  switch (rnd(3)) {
+  case 0: wc= 0x80 + rnd(0x780); break;
+  case 1: wc= 0x800 + rnd(0xF800); break;
+  default: wc= 0x10000 + rnd(0x100000); break;
+  }
+  if (wc >= 0xD800 && wc < 0xE000)
+    wc= 0xE000;
+  if (wc < 0x800)
+  {
+    s[0]= (uchar) (0xC0 | (wc >> 6));
+    s[1]= (uchar) (0x80 | (wc & 0x3F));
+    return 2;
+  }
+  if (wc < 0x10000)
+  {
+    s[0]= (uchar) (0xE0 | (wc >> 12));
+    s[1]= (uchar) (0x80 | ((wc >> 6) & 0x3F));
+    s[2]= (uchar) (0x80 | (wc & 0x3F));
+    return 3;
+  }
+  s[0]= (uchar) (0xF0 | (wc >> 18));
+  s[1]= (uchar) (0x80 | ((wc >> 12) & 0x3F));
+  s[2]= (uchar) (0x80 | ((wc >> 6) & 0x3F));
+  s[3]= (uchar) (0x80 | (wc & 0x3F));
+  return 4;
+}
+
+
+/*
+  Makes a text of ASCII runs of random length up to max_run and
+  other characters between them.
+*/
+static size_t make_text(my_bool utf8, uint max_run, uint bad_percent)
+{
+  size_t length= 0;
+  while (length + 4 < TEXT_LENGTH)
+  {
+    uint run= rnd(max_run + 1);
+    for (run= MY_MIN(run, (uint) (TEXT_LENGTH - 4 - length)); run; run--)
+      text[length++]= (uchar) rnd(0x80);
+    if (utf8)
+      length+= put_utf8(text + length, bad_percent);
+    else
+      text[length++]= (uchar) (0x80 + rnd(0x80));
+  }
+  return length;
+}
+
+
+static int check_convert(CHARSET_INFO *to_cs, CHARSET_INFO *from_cs,
+                         size_t length, size_t to_length)
+{
+  uint errors1, errors2;
+  uint32 length1= my_convert(res1, (uint32) to_length, to_cs,
+                             (char*) text, (uint32) length, from_cs,
+                             &errors1);
+  uint32 length2= my_convert_using_func(res2, to_length,
+                                        to_cs, to_cs->cset->wc_mb,
+                                        (char*) text, length,
+                                        from_cs, from_cs->cset->mb_wc,
+                                        &errors2);
+  if (length1 != length2 || errors1 != errors2 ||
+      memcmp(res1, res2, length1))
+  {
+    diag("%s -> %s length %d to_length %d: got %u bytes %u errors, "
+         "expected %u bytes %u errors", from_cs->coll_name.str,
+         to_cs->coll_name.str, (int) length, (int) to_length,
+         length1, errors1, length2, errors2);
+    return 1;
+  }
+  return 0;
+}
+
+
+static size_t well_formed_length_by_char(CHARSET_INFO *cs, size_t length,
+                                         size_t nchars, int *error)
+{
+  const uchar *s= text, *e= text + length;
+  int chlen;
+  for (*error= 0; nchars && s < e; nchars--, s+= chlen)
+  {
+    if ((chlen= my_ci_charlen(cs, s, e)) <= 0)
+    {
+      *error= 1;
+      break;
+    }
+  }
+  return (size_t) (s - text);
+}
+
+
+static int check_well_formed(CHARSET_INFO *cs, size_t length, size_t nchars)
+{
+  int error1, error2;
+  size_t length1= my_well_formed_length(cs, (char*) text,
+                                        (char*) text + length,
+                                        nchars, &error1);
+  size_t length2= well_formed_length_by_char(cs, length, nchars, &error2);
+  if (length1 != length2 || error1 != error2)
+  {
+    diag("%s length %d nchars %d: got %d error %d, expected %d error %d",
+         cs->coll_name.str, (int) length, (int) nchars,
+         (int) length1, error1, (int) length2, error2);
+    return 1;
+  }
+  return 0;
+}
+
+
+static const uint max_runs[]= { 0, 1, 7, 15, 16, 31, 63, 100, 1000 };
+
+static int test_convert(CHARSET_INFO *to_cs, CHARSET_INFO *from_cs,
+                        my_bool utf8)
+{
+  int failed= 0;
+  size_t i, round;
+  for (i= 0; i < array_elements(max_runs); i++)
+  {
+    for (round= 0; round < 20; round++)
+    {
+      size_t length= make_text(utf8, max_runs[i], 5);
+      size_t cut= rnd((uint) length + 1);
+      failed+= check_convert(to_cs, from_cs, length, sizeof res1);
+      failed+= check_convert(to_cs, from_cs, cut, sizeof res1);
+      failed+= check_convert(to_cs, from_cs, length, cut);
+    }
+  }
+  return failed;
+}
+
+
+static int test_well_formed(CHARSET_INFO *cs)
+{
+  int failed= 0;
+  size_t i, round;
+  for (i= 0; i < array_elements(max_runs); i++)
+  {
+    for (round= 0; round < 20; round++)
+    {
+      size_t length= make_text(TRUE, max_runs[i], round % 2 ? 1 : 0);
+      failed+= check_well_formed(cs, length, length);
+      failed+= check_well_formed(cs, rnd((uint) length + 1), length);
+      failed+= check_well_formed(cs, length, rnd((uint) length + 1));
+    }
+  }
+  return failed;
+}
+
+
+static void bench_convert(const char *name, CHARSET_INFO *to_cs,
+                          CHARSET_INFO *from_cs, size_t length, ulong n)
+{
+  uint errors;
+  ulong i;
+  ulonglong start, ns1, ns2;
+
+  start= my_interval_timer();
+  for (i= 0; i < n; i++)
+    my_convert(res1, sizeof res1, to_cs, (char*) text, (uint32) length,
+               from_cs, &errors);
+  ns1= my_interval_timer() - start;
+  start= my_interval_timer();
+  for (i= 0; i < n; i++)
+    my_convert_using_func(res2, sizeof res2, to_cs, to_cs->cset->wc_mb,
+                          (char*) text, length, from_cs,
+                          from_cs->cset->mb_wc, &errors);
+  ns2= my_interval_timer() - start;
+  diag("%-26s %-20s -> %-20s %8.1f ns, by character %8.1f ns", name,
+       from_cs->coll_name.str, to_cs->coll_name.str,
+       (double) ns1 / n, (double) ns2 / n);
+}
+
+
+static void bench_well_formed(const char *name, CHARSET_INFO *cs,
+                              size_t length, ulong n)
+{
+  int error;
+  ulong i;
+  ulonglong start, ns1, ns2;
+
+  start= my_interval_timer();
+  for (i= 0; i < n; i++)
+    my_well_formed_length(cs, (char*) text, (char*) text + length, length,
+                          &error);
+  ns1= my_interval_timer() - start;
+  start= my_interval_timer();
+  for (i= 0; i < n; i++)
+    well_formed_length_by_char(cs, length, length, &error);
+  ns2= my_interval_timer() - start;
+  diag("%-26s %-20s well formed %8.1f ns, by character %8.1f ns", name,
+       cs->coll_name.str, (double) ns1 / n, (double) ns2 / n);
+}
+
+
+static void bench(CHARSET_INFO *latin1, CHARSET_INFO *utf8mb4, ulong n)
+{
+  static const struct { const char *name; uint max_run; } texts[]=
+  {
+    { "ASCII", TEXT_LENGTH },
+    { "mostly ASCII", 100 },
+    { "mostly non-ASCII", 1 }
+  };
+  size_t i, length;
+  for (i= 0; i < array_elements(texts); i++)
+  {
+    length= make_text(FALSE, texts[i].max_run, 0);
+    bench_convert(texts[i].name, utf8mb4, latin1, length, n);
+    length= make_text(TRUE, texts[i].max_run, 0);
+    bench_convert(texts[i].name, latin1, utf8mb4, length, n);
+    bench_well_formed(texts[i].name, utf8mb4, length, n);
+  }
+}
+
+
+int main(int argc, char **argv)
+{
+  CHARSET_INFO *latin1= &my_charset_latin1;
+  CHARSET_INFO *utf8mb3= &my_charset_utf8mb3_general_ci;
+  CHARSET_INFO *utf8mb4= &my_charset_utf8mb4_bin;
+  CHARSET_INFO *cp1251;
+  ulong iterations= argc > 1 ? strtoul(argv[1], NULL, 10) : 0;
+
+  MY_INIT(argv[0]);
+  cp1251= get_charset_by_name("cp1251_general_ci", MYF(0));
+
+  plan(9);
+
+  ok(test_convert(utf8mb4, latin1, FALSE) == 0, "latin1 -> utf8mb4");
+  ok(test_convert(utf8mb3, latin1, FALSE) == 0, "latin1 -> utf8mb3");
+  ok(test_convert(latin1, utf8mb4, TRUE) == 0, "utf8mb4 -> latin1");
+  ok(test_convert(utf8mb3, utf8mb4, TRUE) == 0, "utf8mb4 -> utf8mb3");
+  ok(test_convert(utf8mb4, utf8mb3, TRUE) == 0, "utf8mb3 -> utf8mb4");
+  ok(cp1251 && test_convert(utf8mb4, cp1251, FALSE) == 0,
+     "cp1251 -> utf8mb4");
+  ok(cp1251 && test_convert(cp1251, latin1, FALSE) == 0,
+     "latin1 -> cp1251");
+  ok(test_well_formed(utf8mb4) == 0, "utf8mb4 well formed length");
+  ok(test_well_formed(utf8mb3) == 0, "utf8mb3 well formed length");
+
+  if (iterations)
+    bench(latin1, utf8mb4, iterations);
+
+  my_end(0);
+  return exit_status();
+}
@@ -0,0 +1,221 @@
+/* Copyright (c) 2026, MariaDB Corporation
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; version 2 of the License.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1335  USA */
+
+/*
+  Compares strnxfrm() of UCA collations for utf8mb3 and utf8mb4, which
+  take the weights of ASCII and 2-byte characters from lookup tables,
+  with strnxfrm() of the same collations for utf32, which always use
+  the weight scanner.
+
+  It is also a microbenchmark: strnxfrm-t N makes sort keys
+  of every text N times and prints the time per call.
+*/
+
+#include <tap.h>
+#include <my_global.h>
+#include <my_sys.h>
+
+#define TEXT_LENGTH 1024
+
+static uchar text[TEXT_LENGTH], text32[TEXT_LENGTH * 4];
+static uchar res1[TEXT_LENGTH * 16], res2[TEXT_LENGTH * 16];
+static ulonglong rnd_state= 1;
+
+static uint rnd(uint n)
+{
+  rnd_state= rnd_state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (uint) (rnd_state >> 33) % n;
+}
+
+
+/*
+  Characters that make contractions or expansions in some collations,
+  ignorable characters and kana with the prolonged sound mark,
+  which has a previous context weight in some collations.
+*/
+static const char *special[]=
+{
+  "ch", "Ch", "CH", "ll", "Ll", "aa", "Aa", "l\xC2\xB7", "\x01", "\x7F",
+  "\xC3\x9F", "\xC3\xA6", "\xC3\x85", "\xCC\x81", "\xC4\xB3",
+  "\xE3\x82\xAB\xE3\x83\xBC", "\xE2\x80\x8B", "\xE4\xB8\x80"
+};
+
+
+/* Appends a character or a special sequence in utf8 */
+static size_t put_char(uchar *s, uint ascii_percent)
+{
+  uint wc;
+  if (rnd(100) < ascii_percent)
+  {
+    s[0]= rnd(4) ? (uchar) "acdhlsz ACHL-."[rnd(14)] :
+                   (uchar) (0x20 + rnd(0x5F));
+    return 1;
+  }
+  if (rnd(3) == 0)
+  {
+    const char *sp= special[rnd(array_elements(special))];
+    size_t length= strlen(sp);
+    memcpy(s, sp, length);
+    return length;
+  }
+  if (rnd(4))
+  {
+    wc= 0xA0 + rnd(0x1E0);
+    s[0]= (uchar) (0xC0 | (wc >> 6));
+    s[1]= (uchar) (0x80 | (wc & 0x3F));
+    return 2;
+  }
+  wc= 0x800 + rnd(0xD000);
+  s[0]= (uchar) (0xE0 | (wc >> 12));
+  s[1]= (uchar) (0x80 | ((wc >> 6) & 0x3F));
+  s[2]= (uchar) (0x80 | (wc & 0x3F));
+  return 3;
+}
+
+
+static size_t make_text(uint ascii_percent)
+{
+  size_t length= 0;
+  while (length + 6 < TEXT_LENGTH)
+    length+= put_char(text + length, ascii_percent);
+  return length;
+}
+
+
+static int check_strnxfrm(CHARSET_INFO *cs, CHARSET_INFO *cs32,
+                          size_t length, size_t dstlen, uint nweights,
+                          uint flags)
+{
+  uint errors;
+  uint32 length32= my_convert((char*) text32, sizeof text32, cs32,
+                              (char*) text, (uint32) length, cs, &errors);
+  my_strnxfrm_ret_t rc1= cs->coll->strnxfrm(cs, res1, dstlen, nweights,
+                                            text, length, flags);
+  my_strnxfrm_ret_t rc2= cs32->coll->strnxfrm(cs32, res2, dstlen, nweights,
+                                              text32, length32, flags);
+  if (rc1.m_result_length != rc2.m_result_length ||
+      rc1.m_warnings != rc2.m_warnings ||
+      memcmp(res1, res2, rc1.m_result_length))
+  {
+    diag("%s length %d dstlen %d nweights %u flags %u: "
+         "got %d bytes warnings %u, expected %d bytes warnings %u",
+         cs->coll_name.str, (int) length, (int) dstlen, nweights, flags,
+         (int) rc1.m_result_length, rc1.m_warnings,
+         (int) rc2.m_result_length, rc2.m_warnings);
+    return 1;
+  }
+  return 0;
+}
+
+
+static const uint ascii_percents[]= { 100, 99, 90, 50, 10 };
+
+static int test_strnxfrm(const char *name, const char *name32)
+{
+  int failed= 0;
+  size_t i, round;
+  CHARSET_INFO *cs= get_charset_by_name(name, MYF(0));
+  CHARSET_INFO *cs32= get_charset_by_name(name32, MYF(0));
+  if (!cs || !cs32)
+  {
+    diag("Could not find %s or %s", name, name32);
+    return 1;
+  }
+  for (i= 0; i < array_elements(ascii_percents); i++)
+  {
+    for (round= 0; round < 20; round++)
+    {
+      size_t length= make_text(ascii_percents[i]);
+      size_t cut= rnd((uint) length + 1);
+      size_t dstlen= rnd(sizeof res1 / 4);
+      uint nweights= rnd((uint) length + 1);
+      while (cut < length && (text[cut] & 0xC0) == 0x80)
+        cut--;                              /* Cut at a character start */
+      failed+= check_strnxfrm(cs, cs32, length, sizeof res1,
+                              (uint) length, MY_STRXFRM_PAD_WITH_SPACE);
+      failed+= check_strnxfrm(cs, cs32, cut, sizeof res1, (uint) length, 0);
+      failed+= check_strnxfrm(cs, cs32, length, dstlen, (uint) length,
+                              MY_STRXFRM_PAD_WITH_SPACE);
+      failed+= check_strnxfrm(cs, cs32, length, dstlen | 1, (uint) length, 0);
+      failed+= check_strnxfrm(cs, cs32, length, sizeof res1, nweights, 0);
+    }
+  }
+  return failed;
+}
+
+
+static void bench(const char *name, ulong n)
+{
+  static const struct { const char *name; uint ascii_percent; } texts[]=
+  {
+    { "ASCII", 100 },
+    { "mostly ASCII", 90 },
+    { "mostly non-ASCII", 10 }
+  };
+  CHARSET_INFO *cs= get_charset_by_name(name, MYF(0));
+  size_t i, length;
+  ulong j;
+  ulonglong start;
+  if (!cs)
+    return;
+  for (i= 0; i < array_elements(texts); i++)
+  {
+    length= make_text(texts[i].ascii_percent);
+    start= my_interval_timer();
+    for (j= 0; j < n; j++)
+      cs->coll->strnxfrm(cs, res1, sizeof res1, (uint) length, text, length,
+                         MY_STRXFRM_PAD_WITH_SPACE);
+    diag("%-18s %-28s %10.1f ns", texts[i].name, name,
+         (double) (my_interval_timer() - start) / n);
+  }
+}
+
+
+static const char *collations[][2]=
+{
+  { "utf8mb4_uca1400_ai_ci",         "utf32_uca1400_ai_ci" },
+  { "utf8mb4_uca1400_as_cs",         "utf32_uca1400_as_cs" },
+  { "utf8mb4_uca1400_czech_ai_ci",   "utf32_uca1400_czech_ai_ci" },
+  { "utf8mb4_uca1400_spanish2_as_ci","utf32_uca1400_spanish2_as_ci" },
+  { "utf8mb4_uca1400_danish_as_cs",  "utf32_uca1400_danish_as_cs" },
+  { "utf8mb3_uca1400_ai_ci",         "utf32_uca1400_ai_ci" },
+  { "utf8mb4_unicode_520_ci",        "utf32_unicode_520_ci" },
+  { "utf8mb4_czech_ci",              "utf32_czech_ci" },
+  { "utf8mb3_unicode_ci",            "utf32_unicode_ci" }
+};
+
+
+int main(int argc, char **argv)
+{
+  size_t i;
+  ulong iterations= argc > 1 ? strtoul(argv[1], NULL, 10) : 0;
+
+  MY_INIT(argv[0]);
+
+  plan(array_elements(collations));
+
+  for (i= 0; i < array_elements(collations); i++)
+    ok(test_strnxfrm(collations[i][0], collations[i][1]) == 0,
+       "%s", collations[i][0]);
+
+  if (iterations)
+  {
+    for (i= 0; i < array_elements(collations); i++)
+      bench(collations[i][0], iterations);
+  }
+
+  my_end(0);
+  return exit_status();
+}
@@ -36,6 +36,10 @@
 # include <sys/filio.h>
 #endif
 
+#ifdef HAVE_SENDFILE
+# include <sys/sendfile.h>
+#endif
+
 /* Network io wait callbacks  for threadpool */
 static void (*before_io_wait)(void)= 0;
 static void (*after_io_wait)(void)= 0;
@@ -286,6 +290,65 @@ size_t vio_write(Vio *vio, const uchar* buf, size_t size)
   DBUG_RETURN(ret);
 }
 
+#ifdef HAVE_SENDFILE
+/**
+  Send a range of a file to the socket, without copying it to user space.
+
+  @param vio     TCP/IP or Unix socket
+  @param file    File to send from
+  @param offset  Position in the file of the first byte to send
+  @param size    Number of bytes to send
+
+  @return Number of bytes sent, which is size unless the file ended, or
+          -1 on error
+*/
+
+size_t vio_sendfile(Vio *vio, File file, my_off_t offset, size_t size)
+{
+  off_t off= (off_t) offset;
+  size_t sent= 0;
+  my_bool old_mode= TRUE;
+  ssize_t ret= 0;
+  DBUG_ENTER("vio_sendfile");
+  DBUG_PRINT("enter", ("sd: %d  file: %d  offset: %llu  size: %zu",
+                       (int)mysql_socket_getfd(vio->mysql_socket), file,
+                       (ulonglong) offset, size));
+  DBUG_ASSERT(vio->type == VIO_TYPE_TCPIP || vio->type == VIO_TYPE_SOCKET);
+
+  /*
+    sendfile() has no flag like MSG_DONTWAIT, so the socket is made
+    non-blocking while it is used, for the write timeout to work.
+  */
+  if (vio->write_timeout >= 0 && vio_blocking(vio, FALSE, &old_mode))
+    DBUG_RETURN((size_t) -1);
+
+  while (sent < size)
+  {
+    if ((ret= sendfile(mysql_socket_getfd(vio->mysql_socket), file, &off,
+                       size - sent)) > 0)
+    {
+      sent+= (size_t) ret;
+      continue;
+    }
+    if (ret == 0)
+      break;                                    /* End of file */
+    if (socket_errno != SOCKET_EAGAIN && socket_errno != SOCKET_EWOULDBLOCK)
+      break;
+    /* Wait for the output buffer to become writable.*/
+    if ((ret= vio_socket_io_wait(vio, VIO_IO_EVENT_WRITE)))
+      break;
+  }
+
+  if (old_mode && vio->write_timeout >= 0)
+  {
+    my_bool not_used;
+    vio_blocking(vio, TRUE, &not_used);
+  }
+  DBUG_PRINT("exit", ("sent: %zu  ret: %d", sent, (int) ret));
+  DBUG_RETURN(ret < 0 ? (size_t) -1 : sent);
+}
+#endif /* HAVE_SENDFILE */
+
 int vio_socket_shutdown(Vio *vio, int how)
 {
   int ret;